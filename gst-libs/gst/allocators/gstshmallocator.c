@@ -0,0 +1,424 @@
+/* GStreamer shared memory allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* for memfd_create() and file sealing */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/**
+ * SECTION:gstshmallocator
+ * @title: GstShmAllocator
+ * @short_description: Allocator for anonymous shared memory
+ * @see_also: #GstFdAllocator, #GstMemory
+ *
+ * #GstShmAllocator allocates memory from anonymous files (memfd on Linux)
+ * that are mapped once and can be handed to other processes by passing the
+ * file descriptor returned by gst_fd_memory_get_fd(), for example over a
+ * UNIX socket. The receiving process maps the very same pages, so frames
+ * can be exchanged without copying.
+ *
+ * With %GST_SHM_ALLOCATOR_FLAG_SEAL, the size of allocated memory is sealed
+ * so that a peer can't truncate the file under a process that has it
+ * mapped, which would otherwise make it crash on access. Memory received
+ * from another process can be wrapped with gst_shm_allocator_import().
+ *
+ * Since: 1.20
+ */
+
+#include "gstshmallocator.h"
+
+#include <string.h>
+
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+#ifndef MFD_HUGETLB
+#define MFD_HUGETLB 0x0004U
+#endif
+
+#define DEFAULT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+GST_DEBUG_CATEGORY_STATIC (shmallocator_debug);
+#define GST_CAT_DEFAULT shmallocator_debug
+
+#define _do_init                                        \
+    GST_DEBUG_CATEGORY_INIT (shmallocator_debug,        \
+    "shmallocator", 0, "shared memory allocator");
+
+G_DEFINE_TYPE_WITH_CODE (GstShmAllocator, gst_shm_allocator,
+    GST_TYPE_FD_ALLOCATOR, _do_init);
+
+#ifdef HAVE_MMAP
+static gsize
+gst_shm_get_page_size (void)
+{
+  static gsize page_size = 0;
+
+  if (g_once_init_enter (&page_size)) {
+    glong size = -1;
+
+#ifdef _SC_PAGESIZE
+    size = sysconf (_SC_PAGESIZE);
+#endif
+    if (size <= 0)
+      size = 4096;
+
+    g_once_init_leave (&page_size, size);
+  }
+
+  return page_size;
+}
+
+static gsize
+gst_shm_get_huge_page_size (void)
+{
+  static gsize huge_page_size = 0;
+
+  if (g_once_init_enter (&huge_page_size)) {
+    gsize size = DEFAULT_HUGE_PAGE_SIZE;
+    gchar *contents = NULL;
+
+    if (g_file_get_contents ("/proc/meminfo", &contents, NULL, NULL)) {
+      const gchar *line = strstr (contents, "Hugepagesize:");
+      guint64 kb;
+
+      if (line) {
+        line += strlen ("Hugepagesize:");
+        kb = g_ascii_strtoull (line, NULL, 10);
+        if (kb > 0)
+          size = kb * 1024;
+      }
+      g_free (contents);
+    }
+
+    GST_DEBUG ("huge page size %" G_GSIZE_FORMAT, size);
+    g_once_init_leave (&huge_page_size, size);
+  }
+
+  return huge_page_size;
+}
+
+static gint
+gst_shm_create_fd (gboolean huge_pages)
+{
+  gint fd = -1;
+
+#ifdef HAVE_MEMFD_CREATE
+  guint flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+
+  if (huge_pages)
+    flags |= MFD_HUGETLB;
+
+  fd = memfd_create ("gst-shm", flags);
+#else
+  gchar *path;
+
+  /* Huge pages and seals need memfd */
+  if (huge_pages)
+    return -1;
+
+  path = g_build_filename (g_get_user_runtime_dir (), "gst-shm-XXXXXX", NULL);
+  fd = g_mkstemp_full (path, O_RDWR | O_CLOEXEC, 0600);
+  if (fd >= 0)
+    unlink (path);
+  g_free (path);
+#endif
+
+  return fd;
+}
+
+static gboolean
+gst_shm_seal (gint fd)
+{
+#ifdef F_ADD_SEALS
+  return fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+      == 0;
+#else
+  errno = ENOTSUP;
+  return FALSE;
+#endif
+}
+
+static GstMemory *
+gst_shm_allocator_alloc_fd (GstShmAllocator * self, gsize size,
+    gboolean huge_pages)
+{
+  GstAllocator *allocator = GST_ALLOCATOR_CAST (self);
+  GstMemory *mem;
+  GstMapInfo info;
+  gsize page_size, alloc_size;
+  gint fd;
+
+  page_size = huge_pages ? gst_shm_get_huge_page_size () :
+      gst_shm_get_page_size ();
+  alloc_size = (size + page_size - 1) & ~(page_size - 1);
+
+  fd = gst_shm_create_fd (huge_pages);
+  if (fd < 0) {
+    GST_DEBUG_OBJECT (self, "failed to create %sfile: %s",
+        huge_pages ? "huge page " : "", g_strerror (errno));
+    return NULL;
+  }
+
+  if (ftruncate (fd, alloc_size) < 0) {
+    GST_DEBUG_OBJECT (self, "failed to resize file to %" G_GSIZE_FORMAT
+        ": %s", alloc_size, g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  if ((self->flags & GST_SHM_ALLOCATOR_FLAG_SEAL) && !gst_shm_seal (fd)) {
+    GST_DEBUG_OBJECT (self, "failed to seal file: %s", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  /* The memory is mapped once and the mapping reused for its whole lifetime.
+   * Map it right away so that a lack of huge pages is noticed here rather
+   * than by the first user of the memory. */
+  mem = gst_fd_allocator_alloc (allocator, fd, alloc_size,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+  if (!mem) {
+    close (fd);
+    return NULL;
+  }
+
+  if (!gst_memory_map (mem, &info, GST_MAP_READWRITE)) {
+    GST_DEBUG_OBJECT (self, "failed to map %" G_GSIZE_FORMAT " bytes",
+        alloc_size);
+    gst_memory_unref (mem);
+    return NULL;
+  }
+  gst_memory_unmap (mem, &info);
+
+  GST_LOG_OBJECT (self, "allocated fd %d of %" G_GSIZE_FORMAT " bytes%s",
+      fd, alloc_size, huge_pages ? " with huge pages" : "");
+
+  return mem;
+}
+#endif /* HAVE_MMAP */
+
+static GstMemory *
+gst_shm_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+#ifdef HAVE_MMAP
+  GstShmAllocator *self = GST_SHM_ALLOCATOR_CAST (allocator);
+  GstMemory *mem = NULL;
+  gsize maxsize;
+
+  /* Mappings are page aligned, which covers any alignment that can be
+   * requested in practice */
+  maxsize = size + params->prefix + params->padding;
+
+  if (self->flags & GST_SHM_ALLOCATOR_FLAG_HUGE_PAGES) {
+    mem = gst_shm_allocator_alloc_fd (self, maxsize, TRUE);
+    if (!mem)
+      GST_INFO_OBJECT (self, "no huge pages available, using normal pages");
+  }
+
+  if (!mem)
+    mem = gst_shm_allocator_alloc_fd (self, maxsize, FALSE);
+
+  if (!mem) {
+    GST_WARNING_OBJECT (self, "failed to allocate %" G_GSIZE_FORMAT " bytes",
+        maxsize);
+    return NULL;
+  }
+
+  gst_memory_resize (mem, params->prefix, size);
+  GST_MINI_OBJECT_FLAGS (mem) |= params->flags;
+
+  return mem;
+#else /* !HAVE_MMAP */
+  return NULL;
+#endif
+}
+
+static void
+gst_shm_allocator_class_init (GstShmAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_shm_allocator_alloc;
+}
+
+static void
+gst_shm_allocator_init (GstShmAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_SHM;
+
+  /* Unlike the plain fd allocator, memory can be allocated through the
+   * generic allocator API and buffer pools */
+  GST_OBJECT_FLAG_UNSET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+/**
+ * gst_shm_allocator_new:
+ * @flags: #GstShmAllocatorFlags
+ *
+ * Return a new shared memory allocator.
+ *
+ * Returns: (transfer full): a new shared memory allocator. Use
+ *    gst_object_unref() to release the allocator after usage
+ *
+ * Since: 1.20
+ */
+GstAllocator *
+gst_shm_allocator_new (GstShmAllocatorFlags flags)
+{
+  GstShmAllocator *alloc;
+
+  alloc = g_object_new (GST_TYPE_SHM_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+  alloc->flags = flags;
+
+  return GST_ALLOCATOR_CAST (alloc);
+}
+
+/**
+ * gst_shm_allocator_import:
+ * @allocator: a #GstShmAllocator
+ * @fd: file descriptor of the shared memory
+ * @size: memory size
+ *
+ * Wrap a shared memory file descriptor received from another process.
+ *
+ * If @allocator was created with %GST_SHM_ALLOCATOR_FLAG_SEAL, @fd is only
+ * accepted if its size can no longer be reduced. In all cases the file must
+ * be at least @size bytes large.
+ *
+ * Returns: (transfer full) (nullable): a #GstMemory wrapping @fd, or %NULL if
+ * @fd can't be used. On success the memory takes ownership of @fd and closes
+ * it when released.
+ *
+ * Since: 1.20
+ */
+GstMemory *
+gst_shm_allocator_import (GstAllocator * allocator, gint fd, gsize size)
+{
+#ifdef HAVE_MMAP
+  GstShmAllocator *self;
+  struct stat st;
+
+  g_return_val_if_fail (GST_IS_SHM_ALLOCATOR (allocator), NULL);
+  g_return_val_if_fail (fd >= 0, NULL);
+
+  self = GST_SHM_ALLOCATOR_CAST (allocator);
+
+  if (self->flags & GST_SHM_ALLOCATOR_FLAG_SEAL) {
+#ifdef F_GET_SEALS
+    gint seals = fcntl (fd, F_GET_SEALS);
+
+    if (seals < 0 || !(seals & F_SEAL_SHRINK)) {
+      GST_WARNING_OBJECT (self, "fd %d is not sealed against shrinking", fd);
+      return NULL;
+    }
+#else
+    GST_WARNING_OBJECT (self, "sealing is not supported");
+    return NULL;
+#endif
+  }
+
+  if (fstat (fd, &st) < 0) {
+    GST_WARNING_OBJECT (self, "failed to stat fd %d: %s", fd,
+        g_strerror (errno));
+    return NULL;
+  }
+
+  if (st.st_size < 0 || (guint64) st.st_size < size) {
+    GST_WARNING_OBJECT (self, "fd %d is smaller than %" G_GSIZE_FORMAT
+        " bytes", fd, size);
+    return NULL;
+  }
+
+  return gst_fd_allocator_alloc (allocator, fd, size,
+      GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+#else /* !HAVE_MMAP */
+  return NULL;
+#endif
+}
+
+/**
+ * gst_is_shm_memory:
+ * @mem: #GstMemory
+ *
+ * Check if @mem is shared memory allocated or imported by a
+ * #GstShmAllocator.
+ *
+ * Returns: %TRUE when @mem is shared memory.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_is_shm_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return GST_IS_SHM_ALLOCATOR (mem->allocator);
+}
+
+/**
+ * gst_shm_buffer_pool_new:
+ * @flags: #GstShmAllocatorFlags
+ *
+ * Create a #GstBufferPool whose buffers are backed by shared memory. The
+ * pool still needs to be configured with gst_buffer_pool_config_set_params();
+ * the allocator is already set in its configuration.
+ *
+ * Returns: (transfer full): a new #GstBufferPool
+ *
+ * Since: 1.20
+ */
+GstBufferPool *
+gst_shm_buffer_pool_new (GstShmAllocatorFlags flags)
+{
+  GstBufferPool *pool;
+  GstAllocator *allocator;
+  GstStructure *config;
+
+  pool = gst_buffer_pool_new ();
+  allocator = gst_shm_allocator_new (flags);
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_allocator (config, allocator, NULL);
+  gst_buffer_pool_set_config (pool, config);
+
+  gst_object_unref (allocator);
+
+  return pool;
+}
@@ -530,44 +530,69 @@ end:
 }
 
 /**
- * gst_rtcp_buffer_add_packet:
+ * gst_rtcp_buffer_get_packets:
  * @rtcp: a valid RTCP buffer
- * @type: the #GstRTCPType of the new packet
- * @packet: pointer to new packet
+ * @packets: (array length=n_packets) (out caller-allocates): an array of
+ *     #GstRTCPPacket to fill
+ * @n_packets: the number of packets in @packets
+ *
+ * Fill @packets with pointers to the first @n_packets packets in @rtcp, in a
+ * single pass over the packet headers. The resulting packets can be used in
+ * any order and are equivalent to the ones obtained by calling
+ * gst_rtcp_buffer_get_first_packet() followed by
+ * gst_rtcp_packet_move_to_next().
  *
- * Add a new packet of @type to @rtcp. @packet will point to the newly created
- * packet.
+ * The packets within a compound RTCP buffer are only located by walking all
+ * the headers before them, so this is faster than looking up a packet several
+ * times by index.
  *
- * Returns: %TRUE if the packet could be created. This function returns %FALSE
- * if the max mtu is exceeded for the buffer.
+ * Returns: the number of packets stored in @packets.
+ *
+ * Since: 1.20
  */
-gboolean
-gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
-    GstRTCPPacket * packet)
+guint
+gst_rtcp_buffer_get_packets (GstRTCPBuffer * rtcp, GstRTCPPacket * packets,
+    guint n_packets)
 {
-  guint len;
-  gsize maxsize;
-  guint8 *data;
-  gboolean result;
+  GstRTCPPacket *packet;
+  guint offset, n;
 
-  g_return_val_if_fail (rtcp != NULL, FALSE);
-  g_return_val_if_fail (GST_IS_BUFFER (rtcp->buffer), FALSE);
-  g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, FALSE);
-  g_return_val_if_fail (packet != NULL, FALSE);
-  g_return_val_if_fail (rtcp->map.flags & GST_MAP_WRITE, FALSE);
+  g_return_val_if_fail (rtcp != NULL, 0);
+  g_return_val_if_fail (GST_IS_BUFFER (rtcp->buffer), 0);
+  g_return_val_if_fail (packets != NULL || n_packets == 0, 0);
+  g_return_val_if_fail (rtcp->map.flags & GST_MAP_READ, 0);
 
-  /* find free space */
-  if (gst_rtcp_buffer_get_first_packet (rtcp, packet)) {
-    while (gst_rtcp_packet_move_to_next (packet));
+  offset = 0;
+  for (n = 0; n < n_packets; n++) {
+    packet = &packets[n];
+    packet->rtcp = rtcp;
+    packet->offset = offset;
 
+    if (!read_packet_header (packet)) {
+      packet->type = GST_RTCP_TYPE_INVALID;
+      break;
+    }
+
+    /* padding is only allowed on the last packet */
     if (packet->padding) {
-      /* Last packet is a padding packet. Let's not replace it silently  */
-      /* and let the application know that it could not be added because */
-      /* it would involve replacing a packet */
-      return FALSE;
+      n++;
+      break;
     }
+
+    offset += (packet->length << 2) + 4;
   }
 
+  return n;
+}
+
+static gboolean
+write_packet_header (GstRTCPBuffer * rtcp, GstRTCPType type,
+    GstRTCPPacket * packet)
+{
+  guint len;
+  gsize maxsize;
+  guint8 *data;
+
   maxsize = rtcp->map.maxsize;
 
   /* packet->offset is now pointing to the next free offset in the buffer to
@@ -592,9 +617,7 @@ gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
   data[3] = len & 0xff;
 
   /* now try to position to the packet */
-  result = read_packet_header (packet);
-
-  return result;
+  return read_packet_header (packet);
 
   /* ERRORS */
 unknown_type:
@@ -608,6 +631,95 @@ no_space:
   }
 }
 
+/**
+ * gst_rtcp_buffer_add_packet:
+ * @rtcp: a valid RTCP buffer
+ * @type: the #GstRTCPType of the new packet
+ * @packet: pointer to new packet
+ *
+ * Add a new packet of @type to @rtcp. @packet will point to the newly created
+ * packet.
+ *
+ * Returns: %TRUE if the packet could be created. This function returns %FALSE
+ * if the max mtu is exceeded for the buffer.
+ */
+gboolean
+gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
+    GstRTCPPacket * packet)
+{
+  g_return_val_if_fail (rtcp != NULL, FALSE);
+  g_return_val_if_fail (GST_IS_BUFFER (rtcp->buffer), FALSE);
+  g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, FALSE);
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (rtcp->map.flags & GST_MAP_WRITE, FALSE);
+
+  /* find free space */
+  if (gst_rtcp_buffer_get_first_packet (rtcp, packet)) {
+    while (gst_rtcp_packet_move_to_next (packet));
+
+    if (packet->padding) {
+      /* Last packet is a padding packet. Let's not replace it silently  */
+      /* and let the application know that it could not be added because */
+      /* it would involve replacing a packet */
+      return FALSE;
+    }
+  }
+
+  return write_packet_header (rtcp, type, packet);
+}
+
+/**
+ * gst_rtcp_packet_add_next:
+ * @packet: a #GstRTCPPacket pointing to the last packet of its buffer
+ * @type: the #GstRTCPType of the new packet
+ *
+ * Add a new packet of @type after @packet and make @packet point to the
+ * newly created packet.
+ *
+ * When building a compound packet, @packet is usually the packet that was
+ * previously added with gst_rtcp_buffer_add_packet() or this function.
+ * Unlike gst_rtcp_buffer_add_packet(), this does not need to walk all the
+ * packets in the buffer to find the free space after them, so the cost of
+ * adding a packet does not grow with the number of packets in the buffer.
+ *
+ * Returns: %TRUE if the packet could be created. This function returns %FALSE
+ * if the max mtu is exceeded for the buffer or when the last packet in the
+ * buffer has padding.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_add_next (GstRTCPPacket * packet, GstRTCPType type)
+{
+  GstRTCPBuffer *rtcp;
+  guint8 *data;
+  guint offset;
+
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (packet->type != GST_RTCP_TYPE_INVALID, FALSE);
+  g_return_val_if_fail (packet->rtcp != NULL, FALSE);
+  g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, FALSE);
+  g_return_val_if_fail (packet->rtcp->map.flags & GST_MAP_WRITE, FALSE);
+
+  rtcp = packet->rtcp;
+  data = rtcp->map.data + packet->offset;
+
+  /* all the setters keep the map size at the end of the last packet. Take the
+   * length from the data as not all of them update the one in @packet */
+  offset = packet->offset + (GST_READ_UINT16_BE (data + 2) << 2) + 4;
+  if (offset != rtcp->map.size)
+    return gst_rtcp_buffer_add_packet (rtcp, type, packet);
+
+  /* padding only allowed on the last packet */
+  if (data[0] & 0x20)
+    return FALSE;
+
+  packet->offset = offset;
+  packet->type = GST_RTCP_TYPE_INVALID;
+
+  return write_packet_header (rtcp, type, packet);
+}
+
 /**
  * gst_rtcp_packet_remove:
  * @packet: a #GstRTCPPacket
@@ -2417,6 +2529,355 @@ gst_rtcp_packet_fb_get_fci (GstRTCPPacket * packet)
   return data + 12;
 }
 
+/* transport-wide congestion control feedback,
+ * draft-holmer-rmcat-transport-wide-cc-extensions-01 */
+#define TWCC_HEADER_SIZE 8
+#define TWCC_MAX_RUN_LENGTH 0x1fff
+/* the FCI length plus the 2 words of SSRCs must fit in the length field */
+#define TWCC_MAX_FCI_LENGTH ((G_MAXUINT16 - 2) * 4)
+
+/* packet status symbols */
+#define TWCC_NOT_RECEIVED 0
+#define TWCC_SMALL_DELTA 1
+#define TWCC_LARGE_DELTA 2
+
+static gboolean
+twcc_get_fci (GstRTCPPacket * packet, guint8 ** fci, guint * fci_len)
+{
+  guint8 *data;
+  guint len;
+
+  if (packet->count != GST_RTCP_RTPFB_TYPE_TWCC)
+    return FALSE;
+
+  data = packet->rtcp->map.data + packet->offset;
+
+  /* take the length from the data, gst_rtcp_packet_fb_set_fci_length()
+   * doesn't update the one in @packet */
+  len = GST_READ_UINT16_BE (data + 2);
+  if (len <= 2 || packet->offset + 4 + len * 4 > packet->rtcp->map.size)
+    return FALSE;
+  len = (len - 2) * 4;
+
+  /* subtract any padding */
+  if (data[0] & 0x20) {
+    guint8 pad_bytes = data[12 + len - 1];
+
+    if (pad_bytes > len)
+      return FALSE;
+    len -= pad_bytes;
+  }
+
+  if (len < TWCC_HEADER_SIZE)
+    return FALSE;
+
+  *fci = data + 12;
+  *fci_len = len;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_twcc_get_info:
+ * @packet: a valid RTPFB #GstRTCPPacket
+ * @base_seqnum: (out) (optional): result transport-wide sequence number of
+ *     the first packet
+ * @status_count: (out) (optional): result number of packet statuses
+ * @reference_time: (out) (optional): result reference time in multiples of
+ *     64 milliseconds
+ * @fb_pkt_count: (out) (optional): result feedback packet count
+ *
+ * Parse the header of the transport-wide congestion control feedback in
+ * @packet.
+ *
+ * Returns: %TRUE if @packet is a transport-wide congestion control feedback
+ * packet with a valid header.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_twcc_get_info (GstRTCPPacket * packet, guint16 * base_seqnum,
+    guint16 * status_count, gint32 * reference_time, guint8 * fb_pkt_count)
+{
+  guint8 *fci;
+  guint fci_len;
+
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (packet->type == GST_RTCP_TYPE_RTPFB, FALSE);
+  g_return_val_if_fail (packet->rtcp != NULL, FALSE);
+  g_return_val_if_fail (packet->rtcp->map.flags & GST_MAP_READ, FALSE);
+
+  if (!twcc_get_fci (packet, &fci, &fci_len))
+    return FALSE;
+
+  if (base_seqnum)
+    *base_seqnum = GST_READ_UINT16_BE (fci);
+  if (status_count)
+    *status_count = GST_READ_UINT16_BE (fci + 2);
+  if (reference_time) {
+    guint32 tmp = GST_READ_UINT24_BE (fci + 4);
+
+    /* sign extend */
+    if (tmp & 0x00800000)
+      tmp |= 0xff000000;
+    *reference_time = (gint32) tmp;
+  }
+  if (fb_pkt_count)
+    *fb_pkt_count = fci[7];
+
+  return TRUE;
+}
+
+/**
+ * gst_rtcp_packet_twcc_get_statuses:
+ * @packet: a valid RTPFB #GstRTCPPacket
+ * @statuses: (array length=n_statuses) (out caller-allocates): an array of
+ *     #GstRTCPTWCCStatus to fill
+ * @n_statuses: the number of entries in @statuses
+ *
+ * Decode the packet status chunks and receive deltas of the transport-wide
+ * congestion control feedback in @packet into @statuses. One entry is stored
+ * for each of the packet statuses, as returned in @status_count by
+ * gst_rtcp_packet_twcc_get_info().
+ *
+ * Returns: %TRUE if the feedback could be decoded. %FALSE is returned when
+ * @packet is not valid transport-wide congestion control feedback or when
+ * @statuses is too small.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_twcc_get_statuses (GstRTCPPacket * packet,
+    GstRTCPTWCCStatus * statuses, guint n_statuses)
+{
+  guint8 *fci;
+  guint fci_len, offset, status_count, i, j, n;
+  guint16 base_seqnum, chunk, symbol;
+
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (packet->type == GST_RTCP_TYPE_RTPFB, FALSE);
+  g_return_val_if_fail (packet->rtcp != NULL, FALSE);
+  g_return_val_if_fail (packet->rtcp->map.flags & GST_MAP_READ, FALSE);
+  g_return_val_if_fail (statuses != NULL || n_statuses == 0, FALSE);
+
+  if (!twcc_get_fci (packet, &fci, &fci_len))
+    return FALSE;
+
+  base_seqnum = GST_READ_UINT16_BE (fci);
+  status_count = GST_READ_UINT16_BE (fci + 2);
+  if (status_count > n_statuses)
+    return FALSE;
+
+  /* decode the chunks first, the status symbols are kept in the delta field
+   * until the deltas that follow all the chunks are read */
+  offset = TWCC_HEADER_SIZE;
+  i = 0;
+  while (i < status_count) {
+    if (offset + 2 > fci_len)
+      return FALSE;
+    chunk = GST_READ_UINT16_BE (fci + offset);
+    offset += 2;
+
+    if ((chunk & 0x8000) == 0) {
+      /* run length chunk */
+      symbol = (chunk >> 13) & 0x3;
+      if (symbol > TWCC_LARGE_DELTA)
+        return FALSE;
+      n = MIN (chunk & TWCC_MAX_RUN_LENGTH, status_count - i);
+      for (j = 0; j < n; j++)
+        statuses[i + j].delta = symbol;
+    } else if ((chunk & 0x4000) == 0) {
+      /* status vector chunk with 14 one bit symbols */
+      n = MIN (14, status_count - i);
+      for (j = 0; j < n; j++)
+        statuses[i + j].delta = (chunk >> (13 - j)) & 0x1;
+    } else {
+      /* status vector chunk with 7 two bit symbols */
+      n = MIN (7, status_count - i);
+      for (j = 0; j < n; j++) {
+        symbol = (chunk >> (12 - 2 * j)) & 0x3;
+        if (symbol > TWCC_LARGE_DELTA)
+          return FALSE;
+        statuses[i + j].delta = symbol;
+      }
+    }
+    i += n;
+  }
+
+  for (i = 0; i < status_count; i++) {
+    GstRTCPTWCCStatus *status = &statuses[i];
+
+    status->seqnum = base_seqnum + i;
+
+    switch (status->delta) {
+      case TWCC_NOT_RECEIVED:
+        status->received = FALSE;
+        break;
+      case TWCC_SMALL_DELTA:
+        if (offset + 1 > fci_len)
+          return FALSE;
+        status->received = TRUE;
+        status->delta = fci[offset];
+        offset += 1;
+        break;
+      default:
+        if (offset + 2 > fci_len)
+          return FALSE;
+        status->received = TRUE;
+        status->delta = (gint16) GST_READ_UINT16_BE (fci + offset);
+        offset += 2;
+        break;
+    }
+  }
+
+  return TRUE;
+}
+
+static inline guint
+twcc_status_symbol (const GstRTCPTWCCStatus * status)
+{
+  if (!status->received)
+    return TWCC_NOT_RECEIVED;
+  if (status->delta >= 0 && status->delta <= G_MAXUINT8)
+    return TWCC_SMALL_DELTA;
+  return TWCC_LARGE_DELTA;
+}
+
+/**
+ * gst_rtcp_packet_twcc_set_statuses:
+ * @packet: a valid RTPFB #GstRTCPPacket
+ * @reference_time: the reference time in multiples of 64 milliseconds, only
+ *     the lower 24 bits are used
+ * @fb_pkt_count: the feedback packet count
+ * @statuses: (array length=n_statuses): the statuses of the packets
+ * @n_statuses: the number of entries in @statuses
+ *
+ * Make @packet a transport-wide congestion control feedback packet and
+ * encode @statuses in its FCI. The packet status chunks are chosen to keep
+ * the FCI small: long runs of the same status are stored as run length
+ * chunks and mixed statuses as status vector chunks. The FCI is padded with
+ * zero bytes to a multiple of 32 bits.
+ *
+ * The seqnum of the entries in @statuses must be consecutive, the first one
+ * is used as the base sequence number. The delta of received packets must
+ * fit in 16 bits.
+ *
+ * Returns: %TRUE if @statuses could be encoded in @packet. %FALSE is returned
+ * when @statuses can't be encoded or when the max mtu of the buffer is
+ * exceeded.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtcp_packet_twcc_set_statuses (GstRTCPPacket * packet,
+    gint32 reference_time, guint8 fb_pkt_count,
+    const GstRTCPTWCCStatus * statuses, guint n_statuses)
+{
+  guint8 *fci;
+  gsize maxlen;
+  guint offset, i, j, n, run;
+  guint16 chunk;
+
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (packet->type == GST_RTCP_TYPE_RTPFB, FALSE);
+  g_return_val_if_fail (packet->rtcp != NULL, FALSE);
+  g_return_val_if_fail (packet->rtcp->map.flags & GST_MAP_WRITE, FALSE);
+  g_return_val_if_fail (statuses != NULL, FALSE);
+  g_return_val_if_fail (n_statuses > 0 && n_statuses <= G_MAXUINT16, FALSE);
+
+  fci = packet->rtcp->map.data + packet->offset + 12;
+  maxlen = MIN (packet->rtcp->map.maxsize - (packet->offset + 12),
+      TWCC_MAX_FCI_LENGTH);
+
+  offset = TWCC_HEADER_SIZE;
+  i = 0;
+  while (i < n_statuses) {
+    guint symbol = twcc_status_symbol (&statuses[i]);
+
+    if (offset + 2 > maxlen)
+      return FALSE;
+
+    for (run = 1; i + run < n_statuses && run < TWCC_MAX_RUN_LENGTH; run++) {
+      if (twcc_status_symbol (&statuses[i + run]) != symbol)
+        break;
+    }
+
+    n = MIN (14, n_statuses - i);
+    if (symbol != TWCC_LARGE_DELTA && run < 14 && run < n_statuses - i) {
+      /* see if the next symbols fit in a one bit status vector */
+      for (j = run; j < n; j++) {
+        if (twcc_status_symbol (&statuses[i + j]) == TWCC_LARGE_DELTA)
+          break;
+      }
+      if (j == n) {
+        chunk = 0x8000;
+        for (j = 0; j < n; j++)
+          chunk |= twcc_status_symbol (&statuses[i + j]) << (13 - j);
+        GST_WRITE_UINT16_BE (fci + offset, chunk);
+        offset += 2;
+        i += n;
+        continue;
+      }
+    }
+
+    if (run >= 7 || run == n_statuses - i) {
+      chunk = (symbol << 13) | run;
+      i += run;
+    } else {
+      /* two bit status vector */
+      n = MIN (7, n_statuses - i);
+      chunk = 0xc000;
+      for (j = 0; j < n; j++)
+        chunk |= twcc_status_symbol (&statuses[i + j]) << (12 - 2 * j);
+      i += n;
+    }
+    GST_WRITE_UINT16_BE (fci + offset, chunk);
+    offset += 2;
+  }
+
+  for (i = 0; i < n_statuses; i++) {
+    const GstRTCPTWCCStatus *status = &statuses[i];
+
+    if (status->seqnum != (guint16) (statuses[0].seqnum + i))
+      return FALSE;
+
+    switch (twcc_status_symbol (status)) {
+      case TWCC_NOT_RECEIVED:
+        break;
+      case TWCC_SMALL_DELTA:
+        if (offset + 1 > maxlen)
+          return FALSE;
+        fci[offset] = status->delta;
+        offset += 1;
+        break;
+      default:
+        if (status->delta < G_MININT16 || status->delta > G_MAXINT16)
+          return FALSE;
+        if (offset + 2 > maxlen)
+          return FALSE;
+        GST_WRITE_UINT16_BE (fci + offset, status->delta);
+        offset += 2;
+        break;
+    }
+  }
+
+  /* pad to 32 bits */
+  for (; offset & 3; offset++) {
+    if (offset + 1 > maxlen)
+      return FALSE;
+    fci[offset] = 0;
+  }
+
+  GST_WRITE_UINT16_BE (fci, statuses[0].seqnum);
+  GST_WRITE_UINT16_BE (fci + 2, n_statuses);
+  GST_WRITE_UINT24_BE (fci + 4, reference_time & 0xffffff);
+  fci[7] = fb_pkt_count;
+
+  gst_rtcp_packet_fb_set_type (packet, GST_RTCP_RTPFB_TYPE_TWCC);
+
+  return gst_rtcp_packet_fb_set_fci_length (packet, offset >> 2);
+}
+
 /**
  * gst_rtcp_packet_app_set_subtype:
  * @packet: a valid APP #GstRTCPPacket
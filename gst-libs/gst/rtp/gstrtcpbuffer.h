@@ -311,6 +311,27 @@ struct _GstRTCPPacket
   guint          entry_offset; /* current entry offset for navigating SDES items */
 };
 
+/**
+ * GstRTCPTWCCStatus:
+ * @seqnum: the transport-wide sequence number of the RTP packet
+ * @received: whether the RTP packet was received
+ * @delta: when @received, the receive delta in multiples of 250 microseconds.
+ *   It is relative to the previous received packet or, for the first one, to
+ *   the reference time of the feedback.
+ *
+ * The status of one RTP packet in transport-wide congestion control feedback.
+ *
+ * Since: 1.20
+ */
+typedef struct _GstRTCPTWCCStatus GstRTCPTWCCStatus;
+
+struct _GstRTCPTWCCStatus
+{
+  guint16  seqnum;
+  gboolean received;
+  gint32   delta;
+};
+
 /* creating buffers */
 
 GST_RTP_API
@@ -352,10 +373,17 @@ gboolean        gst_rtcp_buffer_get_first_packet  (GstRTCPBuffer *rtcp, GstRTCPP
 GST_RTP_API
 gboolean        gst_rtcp_packet_move_to_next      (GstRTCPPacket *packet);
 
+GST_RTP_API
+guint           gst_rtcp_buffer_get_packets       (GstRTCPBuffer *rtcp, GstRTCPPacket *packets,
+                                                   guint n_packets);
+
 GST_RTP_API
 gboolean        gst_rtcp_buffer_add_packet        (GstRTCPBuffer *rtcp, GstRTCPType type,
                                                    GstRTCPPacket *packet);
 
+GST_RTP_API
+gboolean        gst_rtcp_packet_add_next          (GstRTCPPacket *packet, GstRTCPType type);
+
 GST_RTP_API
 gboolean        gst_rtcp_packet_remove            (GstRTCPPacket *packet);
 
@@ -555,6 +583,23 @@ gboolean        gst_rtcp_packet_fb_set_fci_length     (GstRTCPPacket *packet, gu
 GST_RTP_API
 guint8 *        gst_rtcp_packet_fb_get_fci            (GstRTCPPacket *packet);
 
+/* transport-wide congestion control feedback */
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_twcc_get_info         (GstRTCPPacket *packet, guint16 *base_seqnum,
+                                                       guint16 *status_count, gint32 *reference_time,
+                                                       guint8 *fb_pkt_count);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_twcc_get_statuses     (GstRTCPPacket *packet, GstRTCPTWCCStatus *statuses,
+                                                       guint n_statuses);
+
+GST_RTP_API
+gboolean        gst_rtcp_packet_twcc_set_statuses     (GstRTCPPacket *packet, gint32 reference_time,
+                                                       guint8 fb_pkt_count,
+                                                       const GstRTCPTWCCStatus *statuses,
+                                                       guint n_statuses);
+
 /* helper functions */
 
 GST_RTP_API
@@ -1704,12 +1704,109 @@ error:
   return;
 }
 
+/* Writes all header extensions into one extension block, sized up front from
+ * their maximum sizes and trimmed once when they are all written. When the
+ * block can be inserted in the packet as is, it is returned in @extmem and
+ * must be inserted after @rtp is unmapped. Must be called with the object
+ * lock held. */
+static gboolean
+write_header_extensions (GstRTPBasePayload * payload, GstBuffer * buffer,
+    GstRTPBuffer * rtp, GstMemory ** extmem)
+{
+  HeaderExt hdrext = { NULL, };
+  GstMemory *mem;
+  GstMapInfo map;
+  guint wordlen;
+  gsize extlen;
+  guint16 bit_pattern;
+  gpointer extdata;
+
+  hdrext.payload = payload;
+  hdrext.output = buffer;
+  /* XXX: pre-calculate these flags and sizes? */
+  hdrext.flags =
+      GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+  g_ptr_array_foreach (payload->priv->header_exts,
+      (GFunc) determine_header_extension_flags_size, &hdrext);
+  hdrext.hdr_unit_size = 0;
+  if (hdrext.flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
+    /* prefer the one byte header */
+    hdrext.hdr_unit_size = 1;
+    /* TODO: support mixed size writing modes, i.e. RFC8285 */
+    hdrext.flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+    bit_pattern = 0xBEDE;
+  } else if (hdrext.flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
+    hdrext.hdr_unit_size = 2;
+    bit_pattern = 0x1000;
+  } else {
+    return FALSE;
+  }
+
+  extlen =
+      hdrext.hdr_unit_size * payload->priv->header_exts->len +
+      hdrext.allocated_size;
+  wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
+
+  /* allocate the block for the largest possible extension data once, with
+   * room for the bit pattern and the length in front of it */
+  mem = gst_allocator_alloc (NULL, 4 + wordlen * 4, NULL);
+  gst_memory_map (mem, &map, GST_MAP_WRITE);
+  hdrext.data = map.data + 4;
+  /* from 32-bit words to bytes */
+  hdrext.allocated_size = wordlen * 4;
+
+  g_ptr_array_foreach (payload->priv->header_exts,
+      (GFunc) write_header_extension, &hdrext);
+
+  if (hdrext.written_size == 0) {
+    gst_memory_unmap (mem, &map);
+    gst_memory_unref (mem);
+    gst_rtp_buffer_remove_extension_data (rtp);
+    return TRUE;
+  }
+
+  wordlen = hdrext.written_size / 4 + ((hdrext.written_size % 4) ? 1 : 0);
+
+  /* zero-fill the hdrext padding bytes */
+  memset (&hdrext.data[hdrext.written_size], 0,
+      wordlen * 4 - hdrext.written_size);
+
+  GST_WRITE_UINT16_BE (map.data, bit_pattern);
+  GST_WRITE_UINT16_BE (map.data + 2, wordlen);
+  gst_memory_unmap (mem, &map);
+
+  /* trim the block to what was actually written */
+  gst_memory_resize (mem, 0, 4 + wordlen * 4);
+
+  if (!gst_rtp_buffer_get_extension (rtp) &&
+      gst_buffer_peek_memory (buffer, 0)->size ==
+      gst_rtp_buffer_get_header_len (rtp)) {
+    /* the header is alone in the first memory, the block goes right after
+     * it */
+    gst_rtp_buffer_set_extension (rtp, TRUE);
+    *extmem = mem;
+    return TRUE;
+  }
+
+  /* XXX: do we need to add to any existing extension data instead of
+   * overwriting everything? */
+  gst_rtp_buffer_set_extension_data (rtp, bit_pattern, wordlen);
+  gst_rtp_buffer_get_extension_data (rtp, NULL, &extdata, NULL);
+
+  gst_memory_map (mem, &map, GST_MAP_READ);
+  memcpy (extdata, map.data + 4, wordlen * 4);
+  gst_memory_unmap (mem, &map);
+  gst_memory_unref (mem);
+
+  return TRUE;
+}
+
 static gboolean
 set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
 {
   HeaderData *data = user_data;
-  HeaderExt hdrext = { NULL, };
   GstRTPBuffer rtp = { NULL, };
+  GstMemory *extmem = NULL;
 
   if (!gst_rtp_buffer_map (*buffer, GST_MAP_READWRITE, &rtp))
     goto map_failed;
@@ -1721,64 +1818,16 @@ set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
 
   GST_OBJECT_LOCK (data->payload);
   if (data->payload->priv->header_exts->len > 0) {
-    guint wordlen;
-    gsize extlen;
-    guint16 bit_pattern;
-
     /* write header extensions */
-    hdrext.payload = data->payload;
-    hdrext.output = *buffer;
-    /* XXX: pre-calculate these flags and sizes? */
-    hdrext.flags =
-        GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-    g_ptr_array_foreach (data->payload->priv->header_exts,
-        (GFunc) determine_header_extension_flags_size, &hdrext);
-    hdrext.hdr_unit_size = 0;
-    if (hdrext.flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
-      /* prefer the one byte header */
-      hdrext.hdr_unit_size = 1;
-      /* TODO: support mixed size writing modes, i.e. RFC8285 */
-      hdrext.flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-      bit_pattern = 0xBEDE;
-    } else if (hdrext.flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
-      hdrext.hdr_unit_size = 2;
-      bit_pattern = 0x1000;
-    } else {
+    if (!write_header_extensions (data->payload, *buffer, &rtp, &extmem))
       goto unsupported_flags;
-    }
-
-    extlen =
-        hdrext.hdr_unit_size * data->payload->priv->header_exts->len +
-        hdrext.allocated_size;
-    wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
-
-    /* XXX: do we need to add to any existing extension data instead of
-     * overwriting everything? */
-    gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
-    gst_rtp_buffer_get_extension_data (&rtp, NULL, (gpointer) & hdrext.data,
-        &wordlen);
-
-    /* from 32-bit words to bytes */
-    hdrext.allocated_size = wordlen * 4;
-
-    g_ptr_array_foreach (data->payload->priv->header_exts,
-        (GFunc) write_header_extension, &hdrext);
-
-    if (hdrext.written_size > 0) {
-      wordlen = hdrext.written_size / 4 + ((hdrext.written_size % 4) ? 1 : 0);
-
-      /* zero-fill the hdrext padding bytes */
-      memset (&hdrext.data[hdrext.written_size], 0,
-          wordlen * 4 - hdrext.written_size);
-
-      gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
-    } else {
-      gst_rtp_buffer_remove_extension_data (&rtp);
-    }
   }
   GST_OBJECT_UNLOCK (data->payload);
   gst_rtp_buffer_unmap (&rtp);
 
+  if (extmem)
+    gst_buffer_insert_memory (*buffer, 1, extmem);
+
   /* increment the seqnum for each buffer */
   data->seqnum++;
 
@@ -1200,6 +1200,9 @@ gst_rtp_buffer_get_payload_len (GstRTPBuffer * rtp)
  * Get a pointer to the payload data in @buffer. This pointer is valid as long
  * as a reference to @buffer is held.
  *
+ * When the payload is spread over several memories, they are merged into one.
+ * Use gst_rtp_buffer_map_payload_vectors() to avoid this.
+ *
  * Returns: (array) (element-type guint8) (transfer none): A pointer
  * to the payload data in @buffer.
  */
@@ -1241,6 +1244,194 @@ gst_rtp_buffer_get_payload_bytes (GstRTPBuffer * rtp)
   return g_bytes_new (data, gst_rtp_buffer_get_payload_len (rtp));
 }
 
+/* find the range of @len bytes at @offset in the payload, -1 is until the end
+ * of the payload */
+static gboolean
+find_payload_range (GstRTPBuffer * rtp, guint offset, guint len,
+    gsize * poffset, gsize * plen)
+{
+  guint size;
+
+  size = gst_rtp_buffer_get_payload_len (rtp);
+  if (G_UNLIKELY (offset > size))
+    return FALSE;
+
+  size -= offset;
+  if (len != -1 && len < size)
+    size = len;
+
+  *poffset = gst_rtp_buffer_get_header_len (rtp) + offset;
+  *plen = size;
+
+  return TRUE;
+}
+
+/**
+ * gst_rtp_buffer_get_payload_n_vectors:
+ * @rtp: the RTP packet
+ * @offset: the offset in the payload
+ * @len: the length in the payload, or -1 for the rest of the payload
+ *
+ * Get the number of memory regions that @len bytes of the payload of @rtp
+ * starting at @offset are spread over. This is the number of
+ * #GstRTPPayloadVector needed to map them with
+ * gst_rtp_buffer_map_payload_vectors().
+ *
+ * Returns: the number of payload regions, 0 when the range is empty or
+ * invalid.
+ *
+ * Since: 1.20
+ */
+guint
+gst_rtp_buffer_get_payload_n_vectors (GstRTPBuffer * rtp, guint offset,
+    guint len)
+{
+  gsize poffset, plen, skip;
+  guint idx, length;
+
+  g_return_val_if_fail (rtp != NULL, 0);
+  g_return_val_if_fail (GST_IS_BUFFER (rtp->buffer), 0);
+
+  if (!find_payload_range (rtp, offset, len, &poffset, &plen) || plen == 0)
+    return 0;
+
+  if (!gst_buffer_find_memory (rtp->buffer, poffset, plen, &idx, &length,
+          &skip))
+    return 0;
+
+  return length;
+}
+
+/**
+ * gst_rtp_buffer_map_payload_vectors:
+ * @rtp: the RTP packet
+ * @offset: the offset in the payload
+ * @len: the length in the payload, or -1 for the rest of the payload
+ * @vectors: (array length=n_vectors) (out caller-allocates): the vectors to
+ *     fill
+ * @n_vectors: the number of vectors in @vectors
+ *
+ * Map @len bytes of the payload of @rtp starting at @offset as a list of
+ * memory regions, one for each memory of the buffer that contains part of
+ * them. The memories are mapped with the flags @rtp was mapped with.
+ *
+ * Unlike gst_rtp_buffer_get_payload(), this never merges the memories of a
+ * packet into one, so it does not copy the payload when the header and the
+ * payload are in different memories, as produced by most payloaders.
+ *
+ * When @n_vectors is smaller than the number of regions, only the first
+ * @n_vectors regions are mapped. Unmap the vectors with
+ * gst_rtp_buffer_unmap_payload_vectors() before unmapping @rtp.
+ *
+ * Returns: the number of vectors that were mapped, 0 when the range is empty
+ * or invalid or when mapping failed.
+ *
+ * Since: 1.20
+ */
+guint
+gst_rtp_buffer_map_payload_vectors (GstRTPBuffer * rtp, guint offset,
+    guint len, GstRTPPayloadVector * vectors, guint n_vectors)
+{
+  gsize poffset, plen, skip;
+  guint idx, length, i;
+
+  g_return_val_if_fail (rtp != NULL, 0);
+  g_return_val_if_fail (GST_IS_BUFFER (rtp->buffer), 0);
+  g_return_val_if_fail (vectors != NULL || n_vectors == 0, 0);
+
+  if (!find_payload_range (rtp, offset, len, &poffset, &plen) || plen == 0)
+    return 0;
+
+  if (!gst_buffer_find_memory (rtp->buffer, poffset, plen, &idx, &length,
+          &skip))
+    return 0;
+
+  length = MIN (length, n_vectors);
+  for (i = 0; i < length; i++) {
+    GstRTPPayloadVector *vector = &vectors[i];
+
+    /* map one memory at a time, mapping a range would merge them */
+    if (!gst_buffer_map_range (rtp->buffer, idx + i, 1, &vector->map,
+            rtp->map[0].flags))
+      goto map_failed;
+
+    vector->data = vector->map.data + skip;
+    vector->size = MIN (vector->map.size - skip, plen);
+    plen -= vector->size;
+    skip = 0;
+  }
+
+  return length;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ERROR ("failed to map memory");
+    gst_rtp_buffer_unmap_payload_vectors (rtp, vectors, i);
+    return 0;
+  }
+}
+
+/**
+ * gst_rtp_buffer_unmap_payload_vectors:
+ * @rtp: the RTP packet
+ * @vectors: (array length=n_vectors): the vectors to unmap
+ * @n_vectors: the number of vectors in @vectors
+ *
+ * Unmap @vectors previously mapped with gst_rtp_buffer_map_payload_vectors().
+ *
+ * Since: 1.20
+ */
+void
+gst_rtp_buffer_unmap_payload_vectors (GstRTPBuffer * rtp,
+    GstRTPPayloadVector * vectors, guint n_vectors)
+{
+  guint i;
+
+  g_return_if_fail (rtp != NULL);
+  g_return_if_fail (GST_IS_BUFFER (rtp->buffer));
+  g_return_if_fail (vectors != NULL || n_vectors == 0);
+
+  for (i = 0; i < n_vectors; i++) {
+    gst_buffer_unmap (rtp->buffer, &vectors[i].map);
+    vectors[i].data = NULL;
+    vectors[i].size = 0;
+  }
+}
+
+/**
+ * gst_rtp_buffer_extract_payload:
+ * @rtp: the RTP packet
+ * @offset: the offset in the payload
+ * @dest: (out caller-allocates) (array length=size) (element-type guint8):
+ *     the destination address
+ * @size: the size to extract
+ *
+ * Copy @size bytes of the payload of @rtp starting at @offset to @dest. This
+ * is meant to read small payload headers that might span several memories
+ * without merging them.
+ *
+ * Returns: The amount of bytes extracted. This value can be lower than @size
+ * when the payload did not contain enough data.
+ *
+ * Since: 1.20
+ */
+gsize
+gst_rtp_buffer_extract_payload (GstRTPBuffer * rtp, guint offset,
+    gpointer dest, gsize size)
+{
+  gsize poffset, plen;
+
+  g_return_val_if_fail (rtp != NULL, 0);
+  g_return_val_if_fail (GST_IS_BUFFER (rtp->buffer), 0);
+  g_return_val_if_fail (dest != NULL || size == 0, 0);
+
+  if (!find_payload_range (rtp, offset, -1, &poffset, &plen))
+    return 0;
+
+  return gst_buffer_extract (rtp->buffer, poffset, dest, MIN (size, plen));
+}
+
 /**
  * gst_rtp_buffer_default_clock_rate:
  * @payload_type: the static payload type
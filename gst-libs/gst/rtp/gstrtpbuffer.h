@@ -62,6 +62,27 @@ struct _GstRTPBuffer
 #define GST_RTP_BUFFER_INIT { NULL, 0, { NULL, NULL, NULL, NULL}, { 0, 0, 0, 0 }, \
   { GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT} }
 
+/**
+ * GstRTPPayloadVector:
+ * @data: pointer to the payload bytes in this region
+ * @size: the number of payload bytes at @data
+ *
+ * A region of the payload of an RTP packet that is contiguous in memory, see
+ * gst_rtp_buffer_map_payload_vectors().
+ *
+ * Since: 1.20
+ */
+typedef struct _GstRTPPayloadVector GstRTPPayloadVector;
+
+struct _GstRTPPayloadVector
+{
+  guint8      *data;
+  gsize        size;
+
+  /*< private >*/
+  GstMapInfo   map;
+};
+
 /* creating buffers */
 
 GST_RTP_API
@@ -192,6 +213,21 @@ gpointer        gst_rtp_buffer_get_payload           (GstRTPBuffer *rtp);
 GST_RTP_API
 GBytes*         gst_rtp_buffer_get_payload_bytes     (GstRTPBuffer *rtp);
 
+GST_RTP_API
+guint           gst_rtp_buffer_get_payload_n_vectors (GstRTPBuffer *rtp, guint offset, guint len);
+
+GST_RTP_API
+guint           gst_rtp_buffer_map_payload_vectors   (GstRTPBuffer *rtp, guint offset, guint len,
+                                                      GstRTPPayloadVector *vectors, guint n_vectors);
+
+GST_RTP_API
+void            gst_rtp_buffer_unmap_payload_vectors (GstRTPBuffer *rtp, GstRTPPayloadVector *vectors,
+                                                      guint n_vectors);
+
+GST_RTP_API
+gsize           gst_rtp_buffer_extract_payload       (GstRTPBuffer *rtp, guint offset,
+                                                      gpointer dest, gsize size);
+
 /* some helpers */
 
 GST_RTP_API
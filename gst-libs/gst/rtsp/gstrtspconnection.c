@@ -69,6 +69,7 @@
 #include <gio/gnetworking.h>
 
 #include "gstrtspconnection.h"
+#include "gstrtspmessageprivate.h"
 
 #ifdef IP_TOS
 union gst_sockaddr
@@ -145,6 +146,10 @@ typedef enum
 
 #define TUNNELID_LEN   24
 
+/* size of the read-ahead buffer of a connection, reads of at least this size
+ * go straight to the caller's memory */
+#define READ_BUFFER_SIZE (16 * 1024)
+
 struct _GstRTSPConnection
 {
   /*< private > */
@@ -188,6 +193,14 @@ struct _GstRTSPConnection
   gchar *initial_buffer;
   gsize initial_buffer_offset;
 
+  /* all reads from input_stream go through this buffer, the bytes between
+   * read_pos and read_end were read but not consumed yet */
+  GstMemory *read_mem;
+  GstMapInfo read_map;
+  gsize read_pos;
+  gsize read_end;
+  gboolean data_body_buffer;
+
   gboolean remember_session_id; /* remember the session id or not */
 
   /* Session state */
@@ -1399,11 +1412,63 @@ writev_bytes (GOutputStream * stream, GOutputVector * vectors, gint n_vectors,
 }
 #endif
 
+static void
+read_buffer_clear (GstRTSPConnection * conn)
+{
+  if (conn->read_mem) {
+    gst_memory_unmap (conn->read_mem, &conn->read_map);
+    gst_memory_unref (conn->read_mem);
+    conn->read_mem = NULL;
+  }
+  conn->read_pos = 0;
+  conn->read_end = 0;
+}
+
+static inline gsize
+read_buffer_available (GstRTSPConnection * conn)
+{
+  return conn->read_end - conn->read_pos;
+}
+
+/* refills the empty read buffer with one read */
+static gssize
+read_buffer_fill (GstRTSPConnection * conn, gboolean block, GError ** err)
+{
+  gssize r;
+
+  /* data messages can still use the memory of the previous reads, use new
+   * memory in that case */
+  if (conn->read_mem && GST_MINI_OBJECT_REFCOUNT_VALUE (conn->read_mem) > 1)
+    read_buffer_clear (conn);
+
+  if (conn->read_mem == NULL) {
+    conn->read_mem = gst_allocator_alloc (NULL, READ_BUFFER_SIZE, NULL);
+    gst_memory_map (conn->read_mem, &conn->read_map, GST_MAP_READWRITE);
+  }
+  conn->read_pos = 0;
+  conn->read_end = 0;
+
+  if (block)
+    r = g_input_stream_read (conn->input_stream, conn->read_map.data,
+        READ_BUFFER_SIZE, conn->may_cancel ? conn->cancellable : NULL, err);
+  else
+    r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
+        (conn->input_stream), conn->read_map.data, READ_BUFFER_SIZE,
+        conn->may_cancel ? conn->cancellable : NULL, err);
+
+  if (r > 0)
+    conn->read_end = r;
+
+  return r;
+}
+
 static gint
 fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
     gboolean block, GError ** err)
 {
   gint out = 0;
+  gsize avail;
+  gssize r;
 
   if (G_UNLIKELY (conn->initial_buffer != NULL)) {
     gsize left = strlen (&conn->initial_buffer[conn->initial_buffer_offset]);
@@ -1417,31 +1482,36 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
       conn->initial_buffer_offset = 0;
     } else
       conn->initial_buffer_offset += out;
+
+    if (out > 0)
+      return out;
   }
 
-  if (G_LIKELY (size > (guint) out)) {
-    gssize r;
-    gsize count = size - out;
-    if (block)
-      r = g_input_stream_read (conn->input_stream, (gchar *) & buffer[out],
-          count, conn->may_cancel ? conn->cancellable : NULL, err);
-    else
-      r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
-          (conn->input_stream), (gchar *) & buffer[out], count,
-          conn->may_cancel ? conn->cancellable : NULL, err);
-
-    if (G_UNLIKELY (r < 0)) {
-      if (out == 0) {
-        /* propagate the error */
-        out = r;
-      } else {
-        /* we have some data ignore error */
-        g_clear_error (err);
-      }
-    } else
-      out += r;
+  avail = read_buffer_available (conn);
+  if (avail == 0) {
+    if (size >= READ_BUFFER_SIZE) {
+      /* large reads don't need to be buffered */
+      if (block)
+        r = g_input_stream_read (conn->input_stream, (gchar *) buffer, size,
+            conn->may_cancel ? conn->cancellable : NULL, err);
+      else
+        r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
+            (conn->input_stream), (gchar *) buffer, size,
+            conn->may_cancel ? conn->cancellable : NULL, err);
+
+      return r;
+    }
+
+    r = read_buffer_fill (conn, block, err);
+    if (r <= 0)
+      return r;
+    avail = r;
   }
 
+  out = MIN (avail, size);
+  memcpy (buffer, conn->read_map.data + conn->read_pos, out);
+  conn->read_pos += out;
+
   return out;
 }
 
@@ -1529,6 +1599,22 @@ error:
   }
 }
 
+/* like read_bytes() for one byte but without going through fill_bytes() when
+ * the byte is in the read buffer already */
+static inline GstRTSPResult
+read_byte (GstRTSPConnection * conn, guint8 * c, gboolean block)
+{
+  guint i = 0;
+
+  if (G_LIKELY (conn->ctxp == NULL && conn->initial_buffer == NULL &&
+          conn->read_pos < conn->read_end)) {
+    *c = conn->read_map.data[conn->read_pos++];
+    return GST_RTSP_OK;
+  }
+
+  return read_bytes (conn, c, &i, 1, block);
+}
+
 /* The code below tries to handle clients using \r, \n or \r\n to indicate the
  * end of a line. It even does its best to handle clients which mix them (even
  * though this is a really stupid idea (tm).) It also handles Line White Space
@@ -1543,7 +1629,6 @@ read_line (GstRTSPConnection * conn, guint8 * buffer, guint * idx, guint size,
 
   while (TRUE) {
     guint8 c;
-    guint i;
 
     if (conn->read_ahead == READ_AHEAD_EOH) {
       /* the last call to read_line() already determined that we have reached
@@ -1562,8 +1647,7 @@ read_line (GstRTSPConnection * conn, guint8 * buffer, guint * idx, guint size,
       conn->read_ahead = 0;
     } else {
       /* read the next character */
-      i = 0;
-      res = read_bytes (conn, &c, &i, 1, block);
+      res = read_byte (conn, &c, block);
       if (G_UNLIKELY (res != GST_RTSP_OK))
         return res;
     }
@@ -1574,8 +1658,7 @@ read_line (GstRTSPConnection * conn, guint8 * buffer, guint * idx, guint size,
 
     retry:
       /* need to read ahead one more character to know what to do... */
-      i = 0;
-      res = read_bytes (conn, &read_ahead, &i, 1, block);
+      res = read_byte (conn, &read_ahead, block);
       if (G_UNLIKELY (res != GST_RTSP_OK))
         return res;
 
@@ -1775,8 +1858,7 @@ serialize_message (GstRTSPConnection * conn, GstRTSPMessage * message,
           conn->cseq++);
       /* add session id if we have one */
       if (conn->session_id[0] != '\0') {
-        gst_rtsp_message_remove_header (message, GST_RTSP_HDR_SESSION, -1);
-        gst_rtsp_message_add_header (message, GST_RTSP_HDR_SESSION,
+        gst_rtsp_message_set_header (message, GST_RTSP_HDR_SESSION,
             conn->session_id);
       }
       /* add any authentication headers */
@@ -1846,11 +1928,13 @@ serialize_message (GstRTSPConnection * conn, GstRTSPMessage * message,
 
     gen_date_string (date_string, sizeof (date_string));
 
-    /* add date header */
-    gst_rtsp_message_remove_header (message, GST_RTSP_HDR_DATE, -1);
-    gst_rtsp_message_add_header (message, GST_RTSP_HDR_DATE, date_string);
+    /* add date header, replacing its value doesn't require serializing the
+     * other headers again */
+    gst_rtsp_message_set_header (message, GST_RTSP_HDR_DATE, date_string);
 
-    /* append headers */
+    /* append headers, keeping them serialized in case the message is sent
+     * again */
+    __gst_rtsp_message_cache_headers (message);
     gst_rtsp_message_append_headers (message, str);
 
     /* append Content-Length and body if needed */
@@ -2441,6 +2525,49 @@ invalid_format:
   }
 }
 
+/* Parses the interleaved data message following the '$' from the read
+ * buffer when it is complete. The payload is copied out of the read buffer,
+ * or shared with it when data_body_buffer is set. */
+static gboolean
+read_data_message (GstRTSPConnection * conn, GstRTSPMessage * message)
+{
+  const guint8 *data;
+  gsize avail;
+  guint len;
+
+  if (conn->ctxp != NULL || conn->initial_buffer != NULL)
+    return FALSE;
+
+  avail = read_buffer_available (conn);
+  if (avail < 3)
+    return FALSE;
+
+  data = conn->read_map.data + conn->read_pos;
+  len = GST_READ_UINT16_BE (data + 1);
+  if (avail < 3 + len)
+    return FALSE;
+
+  gst_rtsp_message_init_data (message, data[0]);
+
+  if (conn->data_body_buffer) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    if (len > 0)
+      gst_buffer_append_memory (buffer, gst_memory_share (conn->read_mem,
+              conn->read_pos + 3, len));
+    gst_rtsp_message_take_body_buffer (message, buffer);
+  } else {
+    guint8 *body = g_malloc (len + 1);
+
+    memcpy (body, data + 3, len);
+    body[len] = '\0';
+    gst_rtsp_message_take_body (message, body, len + 1);
+  }
+  conn->read_pos += 3 + len;
+
+  return TRUE;
+}
+
 /* returns:
  *  GST_RTSP_OK when a complete message was read.
  *  GST_RTSP_EEOF: when the read socket is closed
@@ -2486,6 +2613,12 @@ build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
       }
       case STATE_DATA_HEADER:
       {
+        /* the whole message is often in the read buffer already */
+        if (builder->offset == 1 && read_data_message (conn, message)) {
+          builder->state = STATE_END;
+          break;
+        }
+
         res =
             read_bytes (conn, (guint8 *) builder->buffer, &builder->offset, 4,
             block);
@@ -2511,8 +2644,14 @@ build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
 
         /* we have the complete body now, store in the message adjusting the
          * length to include the trailing '\0' */
-        gst_rtsp_message_take_body (message,
-            (guint8 *) builder->body_data, builder->body_len + 1);
+        if (message->type == GST_RTSP_MESSAGE_DATA && conn->data_body_buffer)
+          gst_rtsp_message_take_body_buffer (message,
+              gst_buffer_new_wrapped_full (0, builder->body_data,
+                  builder->body_len + 1, 0, builder->body_len,
+                  builder->body_data, g_free));
+        else
+          gst_rtsp_message_take_body (message,
+              (guint8 *) builder->body_data, builder->body_len + 1);
         builder->body_data = NULL;
         builder->body_len = 0;
 
@@ -2892,6 +3031,8 @@ gst_rtsp_connection_close (GstRTSPConnection * conn)
   conn->initial_buffer = NULL;
   conn->initial_buffer_offset = 0;
 
+  read_buffer_clear (conn);
+
   conn->write_socket = NULL;
   conn->read_socket = NULL;
   conn->write_socket_used = FALSE;
@@ -2982,6 +3123,17 @@ gst_rtsp_connection_poll_usec (GstRTSPConnection * conn, GstRTSPEvent events,
   g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (conn->write_socket != NULL, GST_RTSP_EINVAL);
 
+  /* buffered data can be read right away */
+  if ((events & GST_RTSP_EV_READ) && read_buffer_available (conn) > 0) {
+    *revents = GST_RTSP_EV_READ;
+    if (events & GST_RTSP_EV_WRITE) {
+      condition = g_socket_condition_check (conn->write_socket, G_IO_OUT);
+      if ((condition & G_IO_OUT))
+        *revents |= GST_RTSP_EV_WRITE;
+    }
+    return GST_RTSP_OK;
+  }
+
   ctx = g_main_context_new ();
 
   /* configure timeout if any */
@@ -3578,6 +3730,48 @@ gst_rtsp_connection_get_ignore_x_server_reply (const GstRTSPConnection * conn)
   return conn->ignore_x_server_reply;
 }
 
+/**
+ * gst_rtsp_connection_set_data_body_buffer:
+ * @conn: a #GstRTSPConnection
+ * @enable: %TRUE to receive the payload of data messages as a #GstBuffer
+ *
+ * Set whether the payload of the interleaved data messages received on @conn
+ * is stored as a #GstBuffer in the message, that can be retrieved with
+ * gst_rtsp_message_steal_body_buffer(). The buffer shares the memory the
+ * connection read the data into, when possible, and has no trailing '\0'.
+ *
+ * The default is %FALSE, the payload is then copied in the body of the
+ * message followed by a '\0'.
+ *
+ * Since: 1.20
+ */
+void
+gst_rtsp_connection_set_data_body_buffer (GstRTSPConnection * conn,
+    gboolean enable)
+{
+  g_return_if_fail (conn != NULL);
+
+  conn->data_body_buffer = enable;
+}
+
+/**
+ * gst_rtsp_connection_get_data_body_buffer:
+ * @conn: a #GstRTSPConnection
+ *
+ * Get whether the payload of the data messages is received as a #GstBuffer.
+ *
+ * Returns: %TRUE if the payload of data messages is a #GstBuffer.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_rtsp_connection_get_data_body_buffer (const GstRTSPConnection * conn)
+{
+  g_return_val_if_fail (conn != NULL, FALSE);
+
+  return conn->data_body_buffer;
+}
+
 /**
  * gst_rtsp_connection_do_tunnel:
  * @conn: a #GstRTSPConnection
@@ -3620,6 +3814,15 @@ gst_rtsp_connection_do_tunnel (GstRTSPConnection * conn,
       conn->input_stream = conn2->input_stream;
       conn->control_stream = g_io_stream_get_input_stream (conn->stream0);
       conn2->output_stream = NULL;
+
+      /* and what conn2 already read from it */
+      read_buffer_clear (conn);
+      conn->read_mem = conn2->read_mem;
+      conn->read_map = conn2->read_map;
+      conn->read_pos = conn2->read_pos;
+      conn->read_end = conn2->read_end;
+      conn2->read_mem = NULL;
+      conn2->read_pos = conn2->read_end = 0;
     } else {
       /* conn2 is the HTTP GET channel. take its socket and set it as write
        * socket in conn */
@@ -3733,6 +3936,11 @@ struct _GstRTSPWatch
   GCond queue_not_full;
   gboolean flushing;
 
+  /* scratch space for writing the queued messages, protected by the mutex */
+  GOutputVector *vectors;
+  GstMapInfo *map_infos;
+  guint vectors_size;
+
   GstRTSPWatchFuncs funcs;
 
   gpointer user_data;
@@ -3742,12 +3950,17 @@ struct _GstRTSPWatch
 #define IS_BACKLOG_FULL(w) (((w)->max_bytes != 0 && (w)->messages_bytes >= (w)->max_bytes) || \
       ((w)->max_messages != 0 && (w)->messages_count >= (w)->max_messages))
 
+/* maximum number of vectors written with one writev() call. A single message
+ * with more memories is still written at once */
+#define WATCH_MAX_VECTORS 512
+
 static gboolean
 gst_rtsp_source_prepare (GSource * source, gint * timeout)
 {
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
 
-  if (watch->conn->initial_buffer != NULL)
+  if (watch->conn->initial_buffer != NULL ||
+      read_buffer_available (watch->conn) > 0)
     return TRUE;
 
   *timeout = (watch->conn->timeout * 1000);
@@ -3845,6 +4058,7 @@ gst_rtsp_source_dispatch_read (GPollableInputStream * stream,
       conn->stream1 = NULL;
       conn->socket1 = NULL;
       conn->input_stream = NULL;
+      read_buffer_clear (conn);
     }
     g_mutex_unlock (&watch->mutex);
 
@@ -3971,19 +4185,126 @@ gst_rtsp_source_dispatch (GSource * source, GSourceFunc callback G_GNUC_UNUSED,
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
   GstRTSPConnection *conn = watch->conn;
 
-  if (conn->initial_buffer != NULL) {
+  if (conn->initial_buffer != NULL || read_buffer_available (conn) > 0) {
     gst_rtsp_source_dispatch_read (G_POLLABLE_INPUT_STREAM (conn->input_stream),
         watch);
   }
   return watch->keep_running;
 }
 
+/* returns the number of vectors needed for the data of @msg that was not
+ * written yet */
+static guint
+serialized_message_n_vectors (GstRTSPSerializedMessage * msg)
+{
+  guint n_vectors = 0;
+
+  if (msg->data_offset < msg->data_size)
+    n_vectors++;
+
+  if (msg->body_data) {
+    if (msg->body_offset < msg->body_data_size)
+      n_vectors++;
+  } else if (msg->body_buffer) {
+    guint m, n;
+    guint offset = 0;
+
+    n = gst_buffer_n_memory (msg->body_buffer);
+    for (m = 0; m < n; m++) {
+      GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
+
+      /* Skip all memories we already wrote */
+      offset += mem->size;
+      if (offset > msg->body_offset)
+        n_vectors++;
+    }
+  }
+
+  return n_vectors;
+}
+
+/* fills @vectors with the data of @msg that was not written yet, mapping the
+ * memories of the body buffer to @map_infos. Returns the number of vectors */
+static guint
+serialized_message_fill_vectors (GstRTSPSerializedMessage * msg,
+    GOutputVector * vectors, GstMapInfo * map_infos, guint * n_mmap,
+    gsize * bytes_to_write)
+{
+  guint j = 0;
+
+  if (msg->data_offset < msg->data_size) {
+    vectors[j].buffer = (msg->data_is_data_header ?
+        msg->data_header : msg->data) + msg->data_offset;
+    vectors[j].size = msg->data_size - msg->data_offset;
+    *bytes_to_write += vectors[j].size;
+    j++;
+  }
+
+  if (msg->body_data) {
+    if (msg->body_offset < msg->body_data_size) {
+      vectors[j].buffer = msg->body_data + msg->body_offset;
+      vectors[j].size = msg->body_data_size - msg->body_offset;
+      *bytes_to_write += vectors[j].size;
+      j++;
+    }
+  } else if (msg->body_buffer) {
+    guint m, n;
+    guint offset = 0;
+
+    n = gst_buffer_n_memory (msg->body_buffer);
+    for (m = 0; m < n; m++) {
+      GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
+      GstMapInfo *map_info = &map_infos[*n_mmap];
+      guint off;
+
+      /* Skip all memories we already wrote */
+      if (offset + mem->size <= msg->body_offset) {
+        offset += mem->size;
+        continue;
+      }
+
+      if (offset < msg->body_offset)
+        off = msg->body_offset - offset;
+      else
+        off = 0;
+
+      offset += mem->size;
+
+      g_assert (off < mem->size);
+
+      gst_memory_map (mem, map_info, GST_MAP_READ);
+      vectors[j].buffer = map_info->data + off;
+      vectors[j].size = map_info->size - off;
+      *bytes_to_write += vectors[j].size;
+
+      (*n_mmap)++;
+      j++;
+    }
+  }
+
+  return j;
+}
+
+/* makes sure the scratch space of @watch can hold @n_vectors vectors and
+ * mapped memories. Must be called with the watch mutex */
+static void
+gst_rtsp_watch_ensure_vectors (GstRTSPWatch * watch, guint n_vectors)
+{
+  if (watch->vectors_size >= n_vectors)
+    return;
+
+  watch->vectors = g_renew (GOutputVector, watch->vectors, n_vectors);
+  watch->map_infos = g_renew (GstMapInfo, watch->map_infos, n_vectors);
+  watch->vectors_size = n_vectors;
+}
+
 static gboolean
 gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     GstRTSPWatch * watch)
 {
   GstRTSPResult res = GST_RTSP_ERROR;
   GstRTSPConnection *conn = watch->conn;
+  guint ids_data[WATCH_MAX_VECTORS + 1];
 
   /* if this connection was already closed, stop now */
   if (G_POLLABLE_OUTPUT_STREAM (conn->output_stream) != stream ||
@@ -3997,8 +4318,8 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     GstMapInfo *map_infos;
     guint *ids;
     gsize bytes_to_write, bytes_written;
-    guint n_vectors, n_memories, n_ids, drop_messages;
-    gint i, j, l, n_mmap;
+    guint n_vectors, n_ids, drop_messages, n_mmap;
+    gint i, j, l;
     GstRTSPSerializedMessage *msg;
 
     /* if this connection was already closed, stop now */
@@ -4035,94 +4356,35 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
       break;
     }
 
-    for (i = 0, n_vectors = 0, n_memories = 0, n_ids = 0; i < n_messages; i++) {
+    /* write at most WATCH_MAX_VECTORS vectors at once, but always the
+     * complete first message */
+    for (i = 0, n_vectors = 0, n_ids = 0; i < n_messages; i++) {
+      guint n;
+
       msg = gst_queue_array_peek_nth_struct (watch->messages, i);
+      n = serialized_message_n_vectors (msg);
+      if (i > 0 && (i == WATCH_MAX_VECTORS
+              || n_vectors + n > WATCH_MAX_VECTORS))
+        break;
+
+      n_vectors += n;
       if (msg->id != 0)
         n_ids++;
-
-      if (msg->data_offset < msg->data_size)
-        n_vectors++;
-
-      if (msg->body_data && msg->body_offset < msg->body_data_size) {
-        n_vectors++;
-      } else if (msg->body_buffer) {
-        guint m, n;
-        guint offset = 0;
-
-        n = gst_buffer_n_memory (msg->body_buffer);
-        for (m = 0; m < n; m++) {
-          GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
-
-          /* Skip all memories we already wrote */
-          if (offset + mem->size <= msg->body_offset) {
-            offset += mem->size;
-            continue;
-          }
-          offset += mem->size;
-
-          n_memories++;
-          n_vectors++;
-        }
-      }
     }
+    n_messages = i;
 
-    vectors = g_newa (GOutputVector, n_vectors);
-    map_infos = n_memories ? g_newa (GstMapInfo, n_memories) : NULL;
-    ids = n_ids ? g_newa (guint, n_ids + 1) : NULL;
+    gst_rtsp_watch_ensure_vectors (watch, n_vectors);
+    vectors = watch->vectors;
+    map_infos = watch->map_infos;
+    ids = n_ids ? ids_data : NULL;
     if (ids)
       memset (ids, 0, sizeof (guint) * (n_ids + 1));
 
     for (i = 0, j = 0, n_mmap = 0, l = 0, bytes_to_write = 0; i < n_messages;
         i++) {
       msg = gst_queue_array_peek_nth_struct (watch->messages, i);
-
-      if (msg->data_offset < msg->data_size) {
-        vectors[j].buffer = (msg->data_is_data_header ?
-            msg->data_header : msg->data) + msg->data_offset;
-        vectors[j].size = msg->data_size - msg->data_offset;
-        bytes_to_write += vectors[j].size;
-        j++;
-      }
-
-      if (msg->body_data) {
-        if (msg->body_offset < msg->body_data_size) {
-          vectors[j].buffer = msg->body_data + msg->body_offset;
-          vectors[j].size = msg->body_data_size - msg->body_offset;
-          bytes_to_write += vectors[j].size;
-          j++;
-        }
-      } else if (msg->body_buffer) {
-        guint m, n;
-        guint offset = 0;
-        n = gst_buffer_n_memory (msg->body_buffer);
-        for (m = 0; m < n; m++) {
-          GstMemory *mem = gst_buffer_peek_memory (msg->body_buffer, m);
-          guint off;
-
-          /* Skip all memories we already wrote */
-          if (offset + mem->size <= msg->body_offset) {
-            offset += mem->size;
-            continue;
-          }
-
-          if (offset < msg->body_offset)
-            off = msg->body_offset - offset;
-          else
-            off = 0;
-
-          offset += mem->size;
-
-          g_assert (off < mem->size);
-
-          gst_memory_map (mem, &map_infos[n_mmap], GST_MAP_READ);
-          vectors[j].buffer = map_infos[n_mmap].data + off;
-          vectors[j].size = map_infos[n_mmap].size - off;
-          bytes_to_write += vectors[j].size;
-
-          n_mmap++;
-          j++;
-        }
-      }
+      j += serialized_message_fill_vectors (msg, &vectors[j], map_infos,
+          &n_mmap, &bytes_to_write);
     }
 
     res =
@@ -4138,9 +4400,11 @@ gst_rtsp_source_dispatch_write (GPollableOutputStream * stream,
     }
 
     if (bytes_written == bytes_to_write) {
-      /* fast path, just unmap all memories, free memory, drop all messages and notify them */
+      /* fast path, just unmap all memories, free memory, drop all written
+       * messages and notify them */
       l = 0;
-      while ((msg = gst_queue_array_pop_head_struct (watch->messages))) {
+      for (i = 0; i < n_messages; i++) {
+        msg = gst_queue_array_pop_head_struct (watch->messages);
         if (msg->id) {
           ids[l] = msg->id;
           l++;
@@ -4283,6 +4547,9 @@ gst_rtsp_source_finalize (GSource * source)
   watch->messages_bytes = 0;
   watch->messages_count = 0;
 
+  g_free (watch->vectors);
+  g_free (watch->map_infos);
+
   g_cond_clear (&watch->queue_not_full);
 
   if (watch->readsrc)
@@ -4514,55 +4781,31 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
   if (watch->flushing)
     goto flushing;
 
-  /* try to send the message synchronously first */
-  if (gst_queue_array_get_length (watch->messages) == 0) {
-    gint j, k;
+  /* try to send the messages synchronously first, at most WATCH_MAX_VECTORS
+   * vectors at once */
+  while (n_messages > 0 && gst_queue_array_get_length (watch->messages) == 0) {
+    guint j, k;
     GOutputVector *vectors;
     GstMapInfo *map_infos;
     gsize bytes_to_write, bytes_written;
-    guint n_vectors, n_memories, drop_messages;
-
-    for (i = 0, n_vectors = 0, n_memories = 0; i < n_messages; i++) {
-      n_vectors++;
-      if (messages[i].body_data) {
-        n_vectors++;
-      } else if (messages[i].body_buffer) {
-        n_vectors += gst_buffer_n_memory (messages[i].body_buffer);
-        n_memories += gst_buffer_n_memory (messages[i].body_buffer);
-      }
-    }
-
-    vectors = g_newa (GOutputVector, n_vectors);
-    map_infos = n_memories ? g_newa (GstMapInfo, n_memories) : NULL;
-
-    for (i = 0, j = 0, k = 0, bytes_to_write = 0; i < n_messages; i++) {
-      vectors[j].buffer = messages[i].data_is_data_header ?
-          messages[i].data_header : messages[i].data;
-      vectors[j].size = messages[i].data_size;
-      bytes_to_write += vectors[j].size;
-      j++;
+    guint n_vectors, n_chunk, n_mmap, drop_messages;
 
-      if (messages[i].body_data) {
-        vectors[j].buffer = messages[i].body_data;
-        vectors[j].size = messages[i].body_data_size;
-        bytes_to_write += vectors[j].size;
-        j++;
-      } else if (messages[i].body_buffer) {
-        gint l, n;
+    for (i = 0, n_vectors = 0; i < n_messages; i++) {
+      guint n = serialized_message_n_vectors (&messages[i]);
 
-        n = gst_buffer_n_memory (messages[i].body_buffer);
-        for (l = 0; l < n; l++) {
-          GstMemory *mem = gst_buffer_peek_memory (messages[i].body_buffer, l);
+      if (i > 0 && n_vectors + n > WATCH_MAX_VECTORS)
+        break;
+      n_vectors += n;
+    }
+    n_chunk = i;
 
-          gst_memory_map (mem, &map_infos[k], GST_MAP_READ);
-          vectors[j].buffer = map_infos[k].data;
-          vectors[j].size = map_infos[k].size;
-          bytes_to_write += vectors[j].size;
+    gst_rtsp_watch_ensure_vectors (watch, n_vectors);
+    vectors = watch->vectors;
+    map_infos = watch->map_infos;
 
-          k++;
-          j++;
-        }
-      }
+    for (i = 0, j = 0, n_mmap = 0, bytes_to_write = 0; i < n_chunk; i++) {
+      j += serialized_message_fill_vectors (&messages[i], &vectors[j],
+          map_infos, &n_mmap, &bytes_to_write);
     }
 
     res =
@@ -4574,17 +4817,28 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
      * error and updated the offsets inside the message accordingly */
 
     /* First of all unmap all memories. This simplifies the code below */
-    for (k = 0; k < n_memories; k++) {
+    for (k = 0; k < n_mmap; k++) {
       gst_memory_unmap (map_infos[k].memory, &map_infos[k]);
     }
 
+    if (res == GST_RTSP_OK) {
+      /* all messages of this chunk are sent, continue with the next ones */
+      for (i = 0; i < n_chunk; i++) {
+        gst_rtsp_serialized_message_clear (&messages[i]);
+      }
+
+      messages += n_chunk;
+      n_messages -= n_chunk;
+      continue;
+    }
+
     if (res != GST_RTSP_EINTR) {
-      /* actual error or done completely */
+      /* actual error */
       if (id != NULL)
         *id = 0;
 
       /* free everything */
-      for (i = 0, k = 0; i < n_messages; i++) {
+      for (i = 0; i < n_messages; i++) {
         gst_rtsp_serialized_message_clear (&messages[i]);
       }
 
@@ -4592,7 +4846,7 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
     }
 
     /* not done, let's skip all messages that were sent already and free them */
-    for (i = 0, k = 0, drop_messages = 0; i < n_messages; i++) {
+    for (i = 0, drop_messages = 0; i < n_chunk; i++) {
       if (bytes_written >= messages[i].data_size) {
         guint body_size;
 
@@ -4628,10 +4882,20 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
       }
     }
 
-    g_assert (n_messages > drop_messages);
+    g_assert (n_chunk > drop_messages);
 
     messages += drop_messages;
     n_messages -= drop_messages;
+    break;
+  }
+
+  if (n_messages == 0) {
+    /* everything was sent */
+    if (id != NULL)
+      *id = 0;
+
+    res = GST_RTSP_OK;
+    goto done;
   }
 
   /* check limits */
@@ -4848,6 +5112,81 @@ error:
   return GST_RTSP_EINVAL;
 }
 
+/**
+ * gst_rtsp_watch_send_buffer_list:
+ * @watch: a #GstRTSPWatch
+ * @channel: the interleaved channel
+ * @list: (transfer none): the payloads to send
+ * @id: (out) (optional): location for a message ID or %NULL
+ *
+ * Sends every buffer of @list as an interleaved data message on @channel
+ * using the connection of the @watch. This is the same as calling
+ * gst_rtsp_watch_send_messages() with one #GST_RTSP_MESSAGE_DATA message per
+ * buffer, but avoids creating the messages.
+ *
+ * The memories of the buffers are written with as few writev() calls as
+ * possible and are never copied. When the data cannot be sent immediately,
+ * the buffers are referenced and queued in @watch as one unit for the
+ * limits of gst_rtsp_watch_set_send_backlog(). The ID returned in @id is then
+ * non-zero and used as the ID argument in the message_sent callback once the
+ * last buffer is sent.
+ *
+ * Every buffer must be at most 65535 bytes.
+ *
+ * Returns: #GST_RTSP_OK on success.
+ *
+ * Since: 1.20
+ */
+GstRTSPResult
+gst_rtsp_watch_send_buffer_list (GstRTSPWatch * watch, guint8 channel,
+    GstBufferList * list, guint * id)
+{
+  GstRTSPSerializedMessage *serialized_messages;
+  GstRTSPResult res;
+  guint i, n_messages;
+  gsize size;
+
+  g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (list), GST_RTSP_EINVAL);
+
+  n_messages = gst_buffer_list_length (list);
+  serialized_messages = g_new0 (GstRTSPSerializedMessage, n_messages);
+
+  for (i = 0; i < n_messages; i++) {
+    GstRTSPSerializedMessage *msg = &serialized_messages[i];
+    GstBuffer *buffer = gst_buffer_list_get (list, i);
+
+    size = gst_buffer_get_size (buffer);
+    if (size > G_MAXUINT16)
+      goto too_big;
+
+    /* borrow the buffer from the list, it is only referenced when queued */
+    msg->borrowed = TRUE;
+    msg->data_header[0] = '$';
+    msg->data_header[1] = channel;
+    msg->data_header[2] = (size >> 8) & 0xff;
+    msg->data_header[3] = size & 0xff;
+    msg->data_is_data_header = TRUE;
+    msg->data_size = 4;
+    msg->body_buffer = buffer;
+  }
+
+  res = gst_rtsp_watch_write_serialized_messages (watch, serialized_messages,
+      n_messages, id);
+  g_free (serialized_messages);
+
+  return res;
+
+  /* ERRORS */
+too_big:
+  {
+    GST_WARNING ("buffer %u of %" G_GSIZE_FORMAT " bytes is too big for "
+        "interleaved data", i, size);
+    g_free (serialized_messages);
+    return GST_RTSP_EINVAL;
+  }
+}
+
 /**
  * gst_rtsp_watch_wait_backlog_usec:
  * @watch: a #GstRTSPWatch
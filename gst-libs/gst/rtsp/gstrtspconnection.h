@@ -241,6 +241,12 @@ void               gst_rtsp_connection_set_ignore_x_server_reply (GstRTSPConnect
 GST_RTSP_API
 gboolean           gst_rtsp_connection_get_ignore_x_server_reply (const GstRTSPConnection *conn);
 
+GST_RTSP_API
+void               gst_rtsp_connection_set_data_body_buffer (GstRTSPConnection *conn, gboolean enable);
+
+GST_RTSP_API
+gboolean           gst_rtsp_connection_get_data_body_buffer (const GstRTSPConnection *conn);
+
 /* async IO */
 
 /**
@@ -334,6 +340,12 @@ GstRTSPResult      gst_rtsp_watch_send_messages      (GstRTSPWatch *watch,
                                                       guint n_messages,
                                                       guint *id);
 
+GST_RTSP_API
+GstRTSPResult      gst_rtsp_watch_send_buffer_list   (GstRTSPWatch *watch,
+                                                      guint8 channel,
+                                                      GstBufferList *list,
+                                                      guint *id);
+
 GST_RTSP_API
 GstRTSPResult      gst_rtsp_watch_wait_backlog_usec  (GstRTSPWatch * watch,
                                                       gint64 timeout);
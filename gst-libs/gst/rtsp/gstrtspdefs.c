@@ -190,6 +190,39 @@ static struct rtsp_header rtsp_headers[] = {
   {NULL, FALSE}
 };
 
+/* header names are case insensitive */
+static guint
+header_name_hash (gconstpointer key)
+{
+  const gchar *p;
+  guint hash = 5381;
+
+  for (p = key; *p; p++)
+    hash = (hash << 5) + hash + g_ascii_tolower (*p);
+
+  return hash;
+}
+
+static gboolean
+header_name_equal (gconstpointer a, gconstpointer b)
+{
+  return g_ascii_strcasecmp (a, b) == 0;
+}
+
+/* maps the header names to their GstRTSPHeaderField */
+static GHashTable *
+rtsp_init_headers (void)
+{
+  GHashTable *headers = g_hash_table_new (header_name_hash, header_name_equal);
+  gint idx;
+
+  for (idx = 0; rtsp_headers[idx].name; idx++)
+    g_hash_table_insert (headers, (gpointer) rtsp_headers[idx].name,
+        GINT_TO_POINTER (idx + 1));
+
+  return headers;
+}
+
 #define DEF_STATUS(c, t) \
   g_hash_table_insert (statuses, GUINT_TO_POINTER(c), (gpointer) t)
 
@@ -406,14 +439,12 @@ gst_rtsp_status_as_text (GstRTSPStatusCode code)
 GstRTSPHeaderField
 gst_rtsp_find_header_field (const gchar * header)
 {
-  gint idx;
+  static GHashTable *headers = NULL;
 
-  for (idx = 0; rtsp_headers[idx].name; idx++) {
-    if (g_ascii_strcasecmp (rtsp_headers[idx].name, header) == 0) {
-      return idx + 1;
-    }
-  }
-  return GST_RTSP_HDR_INVALID;
+  if (g_once_init_enter (&headers))
+    g_once_init_leave (&headers, rtsp_init_headers ());
+
+  return GPOINTER_TO_INT (g_hash_table_lookup (headers, header));
 }
 
 /**
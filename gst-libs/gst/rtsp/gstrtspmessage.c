@@ -58,6 +58,7 @@
 
 #include <gst/gstutils.h>
 #include "gstrtspmessage.h"
+#include "gstrtspmessageprivate.h"
 
 typedef struct _RTSPKeyValue
 {
@@ -92,6 +93,114 @@ key_value_append (const RTSPKeyValue * kv, GArray * array)
   g_array_append_val (array, kvcopy);
 }
 
+/* lookup and serialization state of the headers of a message, kept in sync
+ * with hdr_fields */
+typedef struct _RTSPHeaderIndex
+{
+  /* position of the first header of each field in hdr_fields plus one, 0 when
+   * there is none. Custom headers start at GST_RTSP_HDR_INVALID */
+  guint first[GST_RTSP_HDR_LAST];
+
+  /* the serialized headers without the values of the patched headers, only
+   * up to date if serialized_valid is set */
+  GString *serialized;
+  gboolean serialized_valid;
+  /* RTSPHeaderPatch for each value that was left out of serialized */
+  GArray *patches;
+} RTSPHeaderIndex;
+
+typedef struct _RTSPHeaderPatch
+{
+  gsize offset;                 /* offset of the value in serialized */
+  guint pos;                    /* position of the header in hdr_fields */
+} RTSPHeaderPatch;
+
+#define HEADER_INDEX(msg) ((RTSPHeaderIndex *) (msg)->hdr_index)
+
+/* headers of which the value usually changes every time a message is sent */
+static inline gboolean
+header_is_patched (GstRTSPHeaderField field)
+{
+  return field == GST_RTSP_HDR_CSEQ || field == GST_RTSP_HDR_SESSION ||
+      field == GST_RTSP_HDR_DATE;
+}
+
+static void
+header_index_free (RTSPHeaderIndex * index)
+{
+  if (index->serialized)
+    g_string_free (index->serialized, TRUE);
+  if (index->patches)
+    g_array_free (index->patches, TRUE);
+  g_free (index);
+}
+
+static RTSPHeaderIndex *
+header_index_ensure (GstRTSPMessage * msg)
+{
+  if (msg->hdr_index == NULL)
+    msg->hdr_index = g_new0 (RTSPHeaderIndex, 1);
+
+  return msg->hdr_index;
+}
+
+/* update the index after a header with @field was appended to hdr_fields */
+static void
+header_index_append (GstRTSPMessage * msg, GstRTSPHeaderField field)
+{
+  RTSPHeaderIndex *index = header_index_ensure (msg);
+
+  if (index->first[field] == 0)
+    index->first[field] = msg->hdr_fields->len;
+  index->serialized_valid = FALSE;
+}
+
+/* update the index after headers were removed from hdr_fields */
+static void
+header_index_rebuild (GstRTSPMessage * msg)
+{
+  RTSPHeaderIndex *index = header_index_ensure (msg);
+  guint i;
+
+  memset (index->first, 0, sizeof (index->first));
+  for (i = msg->hdr_fields->len; i > 0; i--) {
+    RTSPKeyValue *key_value =
+        &g_array_index (msg->hdr_fields, RTSPKeyValue, i - 1);
+
+    index->first[key_value->field] = i;
+  }
+  index->serialized_valid = FALSE;
+}
+
+/* append the header at @pos in hdr_fields to @str. The value of patched
+ * headers is left out and its offset added to @patches if not %NULL. */
+static void
+header_serialize (const GstRTSPMessage * msg, guint pos, GString * str,
+    GArray * patches)
+{
+  RTSPKeyValue *key_value;
+  const gchar *keystr;
+
+  key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, pos);
+
+  if (key_value->custom_key != NULL)
+    keystr = key_value->custom_key;
+  else
+    keystr = gst_rtsp_header_as_text (key_value->field);
+
+  if (patches && header_is_patched (key_value->field)) {
+    RTSPHeaderPatch patch;
+
+    g_string_append_printf (str, "%s: ", keystr);
+    patch.offset = str->len;
+    patch.pos = pos;
+    g_array_append_val (patches, patch);
+    g_string_append (str, "\r\n");
+  } else {
+    g_string_append_printf (str, "%s: %s\r\n", keystr, key_value->value);
+  }
+}
+
 static GstRTSPMessage *
 gst_rtsp_message_boxed_copy (GstRTSPMessage * orig)
 {
@@ -506,6 +615,8 @@ gst_rtsp_message_unset (GstRTSPMessage * msg)
     }
     g_array_free (msg->hdr_fields, TRUE);
   }
+  if (msg->hdr_index != NULL)
+    header_index_free (msg->hdr_index);
   g_free (msg->body);
   gst_buffer_replace (&msg->body_buffer, NULL);
 
@@ -587,6 +698,7 @@ gst_rtsp_message_copy (const GstRTSPMessage * msg, GstRTSPMessage ** copy)
   }
 
   key_value_foreach (msg->hdr_fields, (GFunc) key_value_append, cp->hdr_fields);
+  header_index_rebuild (cp);
   if (msg->body)
     gst_rtsp_message_set_body (cp, msg->body, msg->body_size);
   else
@@ -614,6 +726,7 @@ gst_rtsp_message_take_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
   RTSPKeyValue key_value;
 
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (field < GST_RTSP_HDR_LAST, GST_RTSP_EINVAL);
   g_return_val_if_fail (value != NULL, GST_RTSP_EINVAL);
 
   key_value.field = field;
@@ -621,6 +734,7 @@ gst_rtsp_message_take_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
   key_value.custom_key = NULL;
 
   g_array_append_val (msg->hdr_fields, key_value);
+  header_index_append (msg, field);
 
   return GST_RTSP_OK;
 }
@@ -677,6 +791,9 @@ gst_rtsp_message_remove_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
       i++;
     }
   }
+  if (res == GST_RTSP_OK)
+    header_index_rebuild (msg);
+
   return res;
 }
 
@@ -697,16 +814,20 @@ GstRTSPResult
 gst_rtsp_message_get_header (const GstRTSPMessage * msg,
     GstRTSPHeaderField field, gchar ** value, gint indx)
 {
+  RTSPHeaderIndex *index;
   guint i;
   gint cnt = 0;
 
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
 
   /* no header initialized, there are no headers */
-  if (msg->hdr_fields == NULL)
+  index = HEADER_INDEX (msg);
+  if (msg->hdr_fields == NULL || index == NULL || field >= GST_RTSP_HDR_LAST
+      || index->first[field] == 0)
     return GST_RTSP_ENOTIMPL;
 
-  for (i = 0; i < msg->hdr_fields->len; i++) {
+  /* start at the first header with @field */
+  for (i = index->first[field] - 1; i < msg->hdr_fields->len; i++) {
     RTSPKeyValue *key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
 
     if (key_value->field == field && cnt++ == indx) {
@@ -719,6 +840,71 @@ gst_rtsp_message_get_header (const GstRTSPMessage * msg,
   return GST_RTSP_ENOTIMPL;
 }
 
+/**
+ * gst_rtsp_message_set_header:
+ * @msg: a #GstRTSPMessage
+ * @field: a #GstRTSPHeaderField
+ * @value: (transfer none): the value of the header
+ *
+ * Set @value as the only header with key @field in @msg. The value of the
+ * first header with key @field is replaced in place and all others are
+ * removed. If there is no such header, it is added to @msg like with
+ * gst_rtsp_message_add_header(). This function takes a copy of @value.
+ *
+ * Messages sent over a #GstRTSPConnection keep their serialized headers until
+ * they change. Replacing the value of the #GST_RTSP_HDR_CSEQ,
+ * #GST_RTSP_HDR_SESSION or #GST_RTSP_HDR_DATE header does not require
+ * serializing the other headers again, so that a message can be used as a
+ * template that is sent many times with only those values changed.
+ *
+ * Returns: a #GstRTSPResult.
+ *
+ * Since: 1.20
+ */
+GstRTSPResult
+gst_rtsp_message_set_header (GstRTSPMessage * msg, GstRTSPHeaderField field,
+    const gchar * value)
+{
+  RTSPHeaderIndex *index;
+  RTSPKeyValue *key_value;
+  gboolean removed = FALSE;
+  guint i, pos;
+
+  g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
+  g_return_val_if_fail (field != GST_RTSP_HDR_INVALID, GST_RTSP_EINVAL);
+  g_return_val_if_fail (field < GST_RTSP_HDR_LAST, GST_RTSP_EINVAL);
+  g_return_val_if_fail (value != NULL, GST_RTSP_EINVAL);
+
+  index = HEADER_INDEX (msg);
+  if (index == NULL || index->first[field] == 0)
+    return gst_rtsp_message_take_header (msg, field, g_strdup (value));
+
+  pos = index->first[field] - 1;
+  key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, pos);
+  g_free (key_value->value);
+  key_value->value = g_strdup (value);
+
+  i = pos + 1;
+  while (i < msg->hdr_fields->len) {
+    key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
+
+    if (key_value->field == field) {
+      g_free (key_value->value);
+      g_array_remove_index (msg->hdr_fields, i);
+      removed = TRUE;
+    } else {
+      i++;
+    }
+  }
+
+  if (removed)
+    header_index_rebuild (msg);
+  else if (!header_is_patched (field))
+    index->serialized_valid = FALSE;
+
+  return GST_RTSP_OK;
+}
+
 /**
  * gst_rtsp_message_add_header_by_name:
  * @msg: a #GstRTSPMessage
@@ -777,6 +963,7 @@ gst_rtsp_message_take_header_by_name (GstRTSPMessage * msg,
   key_value.custom_key = g_strdup (header);
 
   g_array_append_val (msg->hdr_fields, key_value);
+  header_index_append (msg, GST_RTSP_HDR_INVALID);
 
   return GST_RTSP_OK;
 }
@@ -786,16 +973,22 @@ static gint
 gst_rtsp_message_find_header_by_name (GstRTSPMessage * msg,
     const gchar * header, gint index)
 {
+  RTSPHeaderIndex *hdr_index;
   GstRTSPHeaderField field;
   gint cnt = 0;
   guint i;
 
   /* no header initialized, there are no headers */
-  if (msg->hdr_fields == NULL)
+  hdr_index = HEADER_INDEX (msg);
+  if (msg->hdr_fields == NULL || hdr_index == NULL)
     return -1;
 
   field = gst_rtsp_find_header_field (header);
-  for (i = 0; i < msg->hdr_fields->len; i++) {
+  if (hdr_index->first[field] == 0)
+    return -1;
+
+  /* start at the first header with @field */
+  for (i = hdr_index->first[field] - 1; i < msg->hdr_fields->len; i++) {
     RTSPKeyValue *key_val;
 
     key_val = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
@@ -848,6 +1041,7 @@ gst_rtsp_message_remove_header_by_name (GstRTSPMessage * msg,
     g_free (kv->value);
     g_free (kv->custom_key);
     g_array_remove_index (msg->hdr_fields, pos);
+    header_index_rebuild (msg);
     res = GST_RTSP_OK;
   } while (index < 0);
 
@@ -900,32 +1094,77 @@ gst_rtsp_message_get_header_by_name (GstRTSPMessage * msg,
  * Append the currently configured headers in @msg to the #GString @str suitable
  * for transmission.
  *
+ * Messages sent over a #GstRTSPConnection keep their serialized headers until
+ * they change, so that resending a message only has to fill in the values of
+ * the #GST_RTSP_HDR_CSEQ, #GST_RTSP_HDR_SESSION and #GST_RTSP_HDR_DATE
+ * headers.
+ *
  * Returns: #GST_RTSP_OK.
  */
 GstRTSPResult
 gst_rtsp_message_append_headers (const GstRTSPMessage * msg, GString * str)
 {
+  RTSPHeaderIndex *index;
+  gsize offset = 0;
   guint i;
 
   g_return_val_if_fail (msg != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (str != NULL, GST_RTSP_EINVAL);
 
-  for (i = 0; i < msg->hdr_fields->len; i++) {
-    RTSPKeyValue *key_value;
-    const gchar *keystr;
+  /* no index, there are no headers */
+  index = HEADER_INDEX (msg);
+  if (index == NULL)
+    return GST_RTSP_OK;
 
-    key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, i);
+  if (!index->serialized_valid) {
+    for (i = 0; i < msg->hdr_fields->len; i++)
+      header_serialize (msg, i, str, NULL);
+    return GST_RTSP_OK;
+  }
 
-    if (key_value->custom_key != NULL)
-      keystr = key_value->custom_key;
-    else
-      keystr = gst_rtsp_header_as_text (key_value->field);
+  for (i = 0; i < index->patches->len; i++) {
+    RTSPHeaderPatch *patch;
+    RTSPKeyValue *key_value;
 
-    g_string_append_printf (str, "%s: %s\r\n", keystr, key_value->value);
+    patch = &g_array_index (index->patches, RTSPHeaderPatch, i);
+    key_value = &g_array_index (msg->hdr_fields, RTSPKeyValue, patch->pos);
+
+    g_string_append_len (str, index->serialized->str + offset,
+        patch->offset - offset);
+    g_string_append (str, key_value->value);
+    offset = patch->offset;
   }
+  g_string_append_len (str, index->serialized->str + offset,
+      index->serialized->len - offset);
+
   return GST_RTSP_OK;
 }
 
+/* Serializes the headers of @msg unless they didn't change since the last
+ * time, for gst_rtsp_message_append_headers() to use. Called when a message
+ * is written out, so messages that are only received never pay for it. */
+void
+__gst_rtsp_message_cache_headers (GstRTSPMessage * msg)
+{
+  RTSPHeaderIndex *index;
+  guint i;
+
+  index = HEADER_INDEX (msg);
+  if (index == NULL || index->serialized_valid)
+    return;
+
+  if (index->serialized == NULL) {
+    index->serialized = g_string_new (NULL);
+    index->patches = g_array_new (FALSE, FALSE, sizeof (RTSPHeaderPatch));
+  }
+  g_string_truncate (index->serialized, 0);
+  g_array_set_size (index->patches, 0);
+
+  for (i = 0; i < msg->hdr_fields->len; i++)
+    header_serialize (msg, i, index->serialized, index->patches);
+  index->serialized_valid = TRUE;
+}
+
 /**
  * gst_rtsp_message_set_body:
  * @msg: a #GstRTSPMessage
@@ -105,7 +105,8 @@ struct _GstRTSPMessage
   guint          body_size;
 
   GstBuffer     *body_buffer;
-  gpointer _gst_reserved[GST_PADDING-1];
+  gpointer       hdr_index;
+  gpointer _gst_reserved[GST_PADDING-2];
 };
 
 GST_RTSP_API
@@ -210,6 +211,11 @@ GstRTSPResult      gst_rtsp_message_get_header      (const GstRTSPMessage *msg,
                                                      gchar **value,
                                                      gint indx);
 
+GST_RTSP_API
+GstRTSPResult      gst_rtsp_message_set_header      (GstRTSPMessage *msg,
+                                                     GstRTSPHeaderField field,
+                                                     const gchar *value);
+
 GST_RTSP_API
 GstRTSPResult      gst_rtsp_message_add_header_by_name    (GstRTSPMessage * msg,
                                                            const gchar    * header,
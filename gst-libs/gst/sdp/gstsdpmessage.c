@@ -172,6 +172,10 @@ GstSDPResult gst_sdp_message_add_##method (GstSDPMessage *msg, const type val) {
 
 static GstSDPMessage *gst_sdp_message_boxed_copy (GstSDPMessage * orig);
 static void gst_sdp_message_boxed_free (GstSDPMessage * msg);
+static void append_attribute_text (const GstSDPAttribute * attr,
+    GString * lines);
+static void gst_sdp_media_append_text (const GstSDPMedia * media,
+    GString * lines);
 
 G_DEFINE_BOXED_TYPE (GstSDPMessage, gst_sdp_message, gst_sdp_message_boxed_copy,
     gst_sdp_message_boxed_free);
@@ -589,25 +593,11 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
     g_string_append_printf (lines, "\r\n");
   }
 
-  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++) {
-    const GstSDPAttribute *attr = gst_sdp_message_get_attribute (msg, i);
-
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
+  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++)
+    append_attribute_text (gst_sdp_message_get_attribute (msg, i), lines);
 
-  for (i = 0; i < gst_sdp_message_medias_len (msg); i++) {
-    const GstSDPMedia *media = gst_sdp_message_get_media (msg, i);
-    gchar *sdp_media_str;
-
-    sdp_media_str = gst_sdp_media_as_text (media);
-    g_string_append_printf (lines, "%s", sdp_media_str);
-    g_free (sdp_media_str);
-  }
+  for (i = 0; i < gst_sdp_message_medias_len (msg); i++)
+    gst_sdp_media_append_text (gst_sdp_message_get_media (msg, i), lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -1959,23 +1949,26 @@ gst_sdp_media_copy (const GstSDPMedia * media, GstSDPMedia ** copy)
   return GST_SDP_OK;
 }
 
-/**
- * gst_sdp_media_as_text:
- * @media: a #GstSDPMedia
- *
- * Convert the contents of @media to a text string.
- *
- * Returns: A dynamically allocated string representing the media.
- */
-gchar *
-gst_sdp_media_as_text (const GstSDPMedia * media)
+static void
+append_attribute_text (const GstSDPAttribute * attr, GString * lines)
 {
-  GString *lines;
-  guint i;
-
-  g_return_val_if_fail (media != NULL, NULL);
+  if (attr->key) {
+    g_string_append (lines, "a=");
+    g_string_append (lines, attr->key);
+    if (attr->value && attr->value[0] != '\0') {
+      g_string_append_c (lines, ':');
+      g_string_append (lines, attr->value);
+    }
+    g_string_append (lines, "\r\n");
+  }
+}
 
-  lines = g_string_new ("");
+/* appends the text of @media to @lines, used for the media of a message
+ * without building a string per media */
+static void
+gst_sdp_media_append_text (const GstSDPMedia * media, GString * lines)
+{
+  guint i;
 
   if (media->media)
     g_string_append_printf (lines, "m=%s", media->media);
@@ -1987,9 +1980,11 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
 
   g_string_append_printf (lines, " %s", media->proto);
 
-  for (i = 0; i < gst_sdp_media_formats_len (media); i++)
-    g_string_append_printf (lines, " %s", gst_sdp_media_get_format (media, i));
-  g_string_append_printf (lines, "\r\n");
+  for (i = 0; i < gst_sdp_media_formats_len (media); i++) {
+    g_string_append_c (lines, ' ');
+    g_string_append (lines, gst_sdp_media_get_format (media, i));
+  }
+  g_string_append (lines, "\r\n");
 
   if (media->information)
     g_string_append_printf (lines, "i=%s", media->information);
@@ -2008,7 +2003,7 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
         if (conn->addr_number > 1)
           g_string_append_printf (lines, "/%u", conn->addr_number);
       }
-      g_string_append_printf (lines, "\r\n");
+      g_string_append (lines, "\r\n");
     }
   }
 
@@ -2023,19 +2018,30 @@ gst_sdp_media_as_text (const GstSDPMedia * media)
     g_string_append_printf (lines, "k=%s", media->key.type);
     if (media->key.data)
       g_string_append_printf (lines, ":%s", media->key.data);
-    g_string_append_printf (lines, "\r\n");
+    g_string_append (lines, "\r\n");
   }
 
-  for (i = 0; i < gst_sdp_media_attributes_len (media); i++) {
-    const GstSDPAttribute *attr = gst_sdp_media_get_attribute (media, i);
+  for (i = 0; i < gst_sdp_media_attributes_len (media); i++)
+    append_attribute_text (gst_sdp_media_get_attribute (media, i), lines);
+}
 
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
+/**
+ * gst_sdp_media_as_text:
+ * @media: a #GstSDPMedia
+ *
+ * Convert the contents of @media to a text string.
+ *
+ * Returns: A dynamically allocated string representing the media.
+ */
+gchar *
+gst_sdp_media_as_text (const GstSDPMedia * media)
+{
+  GString *lines;
+
+  g_return_val_if_fail (media != NULL, NULL);
+
+  lines = g_string_new ("");
+  gst_sdp_media_append_text (media, lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -3078,14 +3084,28 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
         gst_sdp_media_set_key (c->media, str, p);
       break;
     case 'a':
-      read_string_del (str, sizeof (str), ':', &p);
+    {
+      GstSDPAttribute attr;
+      gchar *key;
+
+      /* copy the key and value straight from the line, there are many
+       * attributes in large descriptions */
+      while (g_ascii_isspace (*p))
+        p++;
+      key = p;
+      while (*p != ':' && *p != '\0')
+        p++;
+      attr.key = g_strndup (key, p - key);
       if (*p != '\0')
         p++;
+      attr.value = g_strdup (p);
+
       if (c->state == SDP_SESSION)
-        gst_sdp_message_add_attribute (c->msg, str, p);
+        g_array_append_val (c->msg->attributes, attr);
       else
-        gst_sdp_media_add_attribute (c->media, str, p);
+        g_array_append_val (c->media->attributes, attr);
       break;
+    }
     case 'm':
     {
       gchar *slash;
@@ -3358,24 +3378,41 @@ gst_sdp_message_dump (const GstSDPMessage * msg)
   return GST_SDP_OK;
 }
 
+/* parses the payload type at the start of an attribute value */
+static gboolean
+parse_attribute_pt (const gchar * value, gint * pt)
+{
+  gchar *end;
+
+  *pt = g_ascii_strtoll (value, &end, 10);
+
+  return end != value;
+}
+
 static const gchar *
 gst_sdp_get_attribute_for_pt (const GstSDPMedia * media, const gchar * name,
     gint pt)
 {
   guint i;
 
-  for (i = 0;; i++) {
-    const gchar *attr;
+  /* walk the attributes once, this is called for every payload type of media
+   * with many attributes */
+  for (i = 0; i < media->attributes->len; i++) {
+    const GstSDPAttribute *attr;
     gint val;
 
-    if ((attr = gst_sdp_media_get_attribute_val_n (media, name, i)) == NULL)
+    attr = &g_array_index (media->attributes, GstSDPAttribute, i);
+    if (strcmp (attr->key, name) != 0)
+      continue;
+
+    if (attr->value == NULL)
       break;
 
-    if (sscanf (attr, "%d ", &val) != 1)
+    if (!parse_attribute_pt (attr->value, &val))
       continue;
 
     if (val == pt)
-      return attr;
+      return attr->value;
   }
   return NULL;
 }
@@ -3493,21 +3530,31 @@ gst_sdp_media_add_rtcp_fb_attributes_from_media (const GstSDPMedia * media,
 {
   const gchar *rtcp_fb;
   gchar *p, *to_free;
-  gint payload, i;
+  gint payload;
   GstStructure *s;
+  guint i;
 
   g_return_val_if_fail (media != NULL, GST_SDP_EINVAL);
   g_return_val_if_fail (caps != NULL && GST_IS_CAPS (caps), GST_SDP_EINVAL);
 
   s = gst_caps_get_structure (caps, 0);
 
-  for (i = 0;; i++) {
+  for (i = 0; i < media->attributes->len; i++) {
+    const GstSDPAttribute *attr;
     gboolean all_formats = FALSE;
 
-    if ((rtcp_fb = gst_sdp_media_get_attribute_val_n (media,
-                "rtcp-fb", i)) == NULL)
+    attr = &g_array_index (media->attributes, GstSDPAttribute, i);
+    if (strcmp (attr->key, "rtcp-fb") != 0)
+      continue;
+
+    if ((rtcp_fb = attr->value) == NULL)
       break;
 
+    /* skip the attributes of other payloads without copying them */
+    if (rtcp_fb[0] != '*' && (!parse_attribute_pt (rtcp_fb, &payload) ||
+            payload != pt))
+      continue;
+
     /* p is now of the format <payload> attr... */
     to_free = p = g_strdup (rtcp_fb);
 
@@ -297,6 +297,7 @@
 #include <gst/video/video-event.h>
 #include <gst/video/gstvideopool.h>
 #include <gst/video/gstvideometa.h>
+#include <gst/base/gstqueuearray.h>
 #include <string.h>
 
 GST_DEBUG_CATEGORY (videodecoder_debug);
@@ -316,6 +317,9 @@ GST_DEBUG_CATEGORY (videodecoder_debug);
 #define REQUEST_SYNC_POINT_UNSET G_MAXUINT64
 #define DEFAULT_DETECT_REORDERING         TRUE
 
+/* number of recent decode times the statistics are calculated from */
+#define DECODE_TIMES_SIZE 128
+
 enum
 {
   PROP_0,
@@ -326,9 +330,33 @@ enum
   PROP_AUTOMATIC_REQUEST_SYNC_POINTS,
   PROP_AUTOMATIC_REQUEST_SYNC_POINT_FLAGS,
   PROP_DETECT_REORDERING,
+  PROP_STATS,
   PROP_LAST
 };
 
+typedef struct _Timestamp Timestamp;
+struct _Timestamp
+{
+  guint64 offset;
+  GstClockTime pts;
+  GstClockTime dts;
+  GstClockTime duration;
+  guint flags;
+};
+
+/* A frame handed to the frame threads, see
+ * gst_video_decoder_set_frame_threads() */
+typedef struct _FrameJob FrameJob;
+struct _FrameJob
+{
+  GstVideoCodecFrame *frame;
+  GstFlowReturn ret;
+  /* TRUE once decode_frame() returned */
+  gboolean done;
+  /* too late for QoS, to be dropped in order without decoding */
+  gboolean drop;
+};
+
 struct _GstVideoDecoderPrivate
 {
   /* FIXME introduce a context ? */
@@ -381,8 +409,8 @@ struct _GstVideoDecoderPrivate
   guint64 input_offset;
   /* relative offset of frame */
   guint64 frame_offset;
-  /* tracking ts and offsets */
-  GQueue timestamps;
+  /* tracking ts and offsets, of Timestamp */
+  GstQueueArray *timestamps;
 
   /* last outgoing ts */
   GstClockTime last_timestamp_out;
@@ -429,6 +457,19 @@ struct _GstVideoDecoderPrivate
   guint32 decode_frame_number;
 
   GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> link in frames */
+  GHashTable *frames_index;
+  GstVideoCodecFramePool *frame_pool;
+
+  /* frame threading */
+  guint n_frame_threads;
+  GThreadPool *frame_threads;
+  GMutex frame_jobs_lock;
+  GCond frame_jobs_cond;
+  /* of FrameJob in decoding order, protected by frame_jobs_lock */
+  GQueue frame_jobs;
+  guint frame_jobs_running;
+
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -443,6 +484,15 @@ struct _GstVideoDecoderPrivate
   guint dropped;
   guint processed;
 
+  /* wall time spent in handle_frame() / decode_frame(), OBJECT_LOCK */
+  GstClockTime avg_decode_time;
+  GstClockTime decode_times[DECODE_TIMES_SIZE];
+  guint64 n_decode_times;
+  /* thread running handle_frame() and the time it spent pushing downstream
+   * from finish_frame(), which is not accounted as decode time */
+  GThread *decode_thread;
+  GstClockTime decode_push_time;
+
   /* Outgoing byte size ? */
   gint64 bytes_out;
   gint64 time;
@@ -505,6 +555,9 @@ static void gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
 
 static GstFlowReturn gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
+static GstFlowReturn gst_video_decoder_collect_frame_jobs (GstVideoDecoder *
+    decoder, guint max_jobs);
+static void gst_video_decoder_discard_frame_jobs (GstVideoDecoder * decoder);
 
 static void gst_video_decoder_push_event_list (GstVideoDecoder * decoder,
     GList * events);
@@ -735,6 +788,30 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
           DEFAULT_DETECT_REORDERING,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoDecoder:stats:
+   *
+   * Various decoder statistics. This property returns a #GstStructure
+   * with name `application/x-video-decoder-stats` with the following fields:
+   *
+   * - "processed" G_TYPE_UINT64: number of frames that were finished
+   * - "dropped" G_TYPE_UINT64: number of frames that were dropped, e.g. for
+   *   QoS
+   * - "average-decode-time" G_TYPE_UINT64: moving average of the time
+   *   spent decoding a frame, in nanoseconds. This is the time the subclass
+   *   spent in #GstVideoDecoderClass.handle_frame() or
+   *   #GstVideoDecoderClass.decode_frame(), excluding the time spent pushing
+   *   the decoded frames downstream.
+   * - "decode-time-p50", "decode-time-p90", "decode-time-p99" and
+   *   "decode-time-max" G_TYPE_UINT64: percentiles of the time spent
+   *   decoding the recent frames, in nanoseconds
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics", "Various statistics",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   meta_tag_video_quark = g_quark_from_static_string (GST_META_TAG_VIDEO_STR);
 }
 
@@ -784,7 +861,14 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
   decoder->priv->needs_format = FALSE;
 
   g_queue_init (&decoder->priv->frames);
-  g_queue_init (&decoder->priv->timestamps);
+  decoder->priv->frames_index = g_hash_table_new (NULL, NULL);
+  decoder->priv->frame_pool = __gst_video_codec_frame_pool_new ();
+  decoder->priv->n_frame_threads = 1;
+  g_mutex_init (&decoder->priv->frame_jobs_lock);
+  g_cond_init (&decoder->priv->frame_jobs_cond);
+  g_queue_init (&decoder->priv->frame_jobs);
+  decoder->priv->timestamps =
+      gst_queue_array_new_for_struct (sizeof (Timestamp), 16);
 
   /* properties */
   decoder->priv->do_qos = DEFAULT_QOS;
@@ -913,6 +997,9 @@ gst_video_decoder_setcaps (GstVideoDecoder * decoder, GstCaps * caps)
   if (G_UNLIKELY (state == NULL))
     goto parse_fail;
 
+  /* frames still being decoded belong to the previous format */
+  gst_video_decoder_collect_frame_jobs (decoder, 0);
+
   if (decoder_class->set_format)
     ret = decoder_class->set_format (decoder, state);
 
@@ -962,6 +1049,11 @@ gst_video_decoder_finalize (GObject * object)
 
   g_rec_mutex_clear (&decoder->stream_lock);
 
+  if (decoder->priv->frame_threads)
+    g_thread_pool_free (decoder->priv->frame_threads, FALSE, TRUE);
+  g_mutex_clear (&decoder->priv->frame_jobs_lock);
+  g_cond_clear (&decoder->priv->frame_jobs_cond);
+
   if (decoder->priv->input_adapter) {
     g_object_unref (decoder->priv->input_adapter);
     decoder->priv->input_adapter = NULL;
@@ -971,6 +1063,10 @@ gst_video_decoder_finalize (GObject * object)
     decoder->priv->output_adapter = NULL;
   }
 
+  g_hash_table_unref (decoder->priv->frames_index);
+  __gst_video_codec_frame_pool_free (decoder->priv->frame_pool);
+  gst_queue_array_free (decoder->priv->timestamps);
+
   if (decoder->priv->input_state)
     gst_video_codec_state_unref (decoder->priv->input_state);
   if (decoder->priv->output_state)
@@ -989,6 +1085,66 @@ gst_video_decoder_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static gint
+compare_clock_times (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  GstClockTime ta = *(const GstClockTime *) a;
+  GstClockTime tb = *(const GstClockTime *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static GstStructure *
+gst_video_decoder_create_stats (GstVideoDecoder * dec)
+{
+  GstVideoDecoderPrivate *priv = dec->priv;
+  GstClockTime times[DECODE_TIMES_SIZE];
+  GstClockTime avg_decode_time;
+  guint n_times;
+
+  GST_OBJECT_LOCK (dec);
+  n_times = MIN (priv->n_decode_times, DECODE_TIMES_SIZE);
+  memcpy (times, priv->decode_times, n_times * sizeof (GstClockTime));
+  avg_decode_time = priv->avg_decode_time;
+  GST_OBJECT_UNLOCK (dec);
+
+  if (n_times == 0) {
+    times[0] = 0;
+    n_times = 1;
+  }
+  g_qsort_with_data (times, n_times, sizeof (GstClockTime),
+      compare_clock_times, NULL);
+
+  return gst_structure_new ("application/x-video-decoder-stats",
+      "processed", G_TYPE_UINT64, (guint64) priv->processed,
+      "dropped", G_TYPE_UINT64, (guint64) priv->dropped,
+      "average-decode-time", G_TYPE_UINT64, avg_decode_time,
+      "decode-time-p50", G_TYPE_UINT64, times[(n_times - 1) * 50 / 100],
+      "decode-time-p90", G_TYPE_UINT64, times[(n_times - 1) * 90 / 100],
+      "decode-time-p99", G_TYPE_UINT64, times[(n_times - 1) * 99 / 100],
+      "decode-time-max", G_TYPE_UINT64, times[n_times - 1], NULL);
+}
+
+/* Accounts the wall time handle_frame() or decode_frame() took for a
+ * frame, without the time spent pushing downstream. May be called from the
+ * frame threads. */
+static void
+gst_video_decoder_add_decode_time (GstVideoDecoder * dec,
+    GstClockTime decode_time)
+{
+  GstVideoDecoderPrivate *priv = dec->priv;
+
+  GST_OBJECT_LOCK (dec);
+  priv->decode_times[priv->n_decode_times % DECODE_TIMES_SIZE] = decode_time;
+  /* moving average over roughly the last 8 frames */
+  if (priv->n_decode_times == 0)
+    priv->avg_decode_time = decode_time;
+  else
+    priv->avg_decode_time = (7 * priv->avg_decode_time + decode_time) / 8;
+  priv->n_decode_times++;
+  GST_OBJECT_UNLOCK (dec);
+}
+
 static void
 gst_video_decoder_get_property (GObject * object, guint property_id,
     GValue * value, GParamSpec * pspec)
@@ -1018,6 +1174,9 @@ gst_video_decoder_get_property (GObject * object, guint property_id,
     case PROP_DETECT_REORDERING:
       g_value_set_boolean (value, priv->detect_reordering);
       break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_video_decoder_create_stats (dec));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -1068,6 +1227,12 @@ gst_video_decoder_flush (GstVideoDecoder * dec, gboolean hard)
 
   GST_LOG_OBJECT (dec, "flush hard %d", hard);
 
+  /* The subclass must not be decoding anything when it is flushed */
+  if (hard)
+    gst_video_decoder_discard_frame_jobs (dec);
+  else
+    ret = gst_video_decoder_collect_frame_jobs (dec, 0);
+
   /* Inform subclass */
   if (klass->reset) {
     GST_FIXME_OBJECT (dec, "GstVideoDecoder::reset() is deprecated");
@@ -1209,6 +1374,9 @@ gst_video_decoder_drain_out (GstVideoDecoder * dec, gboolean at_eos)
       ret = gst_video_decoder_parse_available (dec, TRUE, FALSE);
     }
 
+    /* and output all frames still being decoded by the frame threads */
+    ret = gst_video_decoder_collect_frame_jobs (dec, 0);
+
     if (at_eos) {
       if (decoder_class->finish)
         ret = decoder_class->finish (dec);
@@ -2026,6 +2194,19 @@ gst_video_decoder_src_query_default (GstVideoDecoder * dec, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += dec->priv->max_latency;
+
+        /* frame threads hold back up to one frame each */
+        if (dec->priv->n_frame_threads > 1 && dec->priv->output_state &&
+            dec->priv->output_state->info.fps_n > 0) {
+          GstClockTime frame_latency;
+
+          frame_latency = gst_util_uint64_scale (dec->priv->n_frame_threads,
+              GST_SECOND * dec->priv->output_state->info.fps_d,
+              dec->priv->output_state->info.fps_n);
+          min_latency += frame_latency;
+          if (max_latency != GST_CLOCK_TIME_NONE)
+            max_latency += frame_latency;
+        }
         GST_OBJECT_UNLOCK (dec);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -2212,28 +2393,12 @@ gst_video_decoder_sink_query (GstPad * pad, GstObject * parent,
   return ret;
 }
 
-typedef struct _Timestamp Timestamp;
-struct _Timestamp
-{
-  guint64 offset;
-  GstClockTime pts;
-  GstClockTime dts;
-  GstClockTime duration;
-  guint flags;
-};
-
-static void
-timestamp_free (Timestamp * ts)
-{
-  g_slice_free (Timestamp, ts);
-}
-
 static void
 gst_video_decoder_add_buffer_info (GstVideoDecoder * decoder,
     GstBuffer * buffer)
 {
   GstVideoDecoderPrivate *priv = decoder->priv;
-  Timestamp *ts;
+  Timestamp ts;
 
   if (!GST_BUFFER_PTS_IS_VALID (buffer) &&
       !GST_BUFFER_DTS_IS_VALID (buffer) &&
@@ -2244,26 +2409,25 @@ gst_video_decoder_add_buffer_info (GstVideoDecoder * decoder,
     return;
   }
 
-  ts = g_slice_new (Timestamp);
-
   GST_LOG_OBJECT (decoder,
       "adding PTS %" GST_TIME_FORMAT " DTS %" GST_TIME_FORMAT
       " (offset:%" G_GUINT64_FORMAT ")",
       GST_TIME_ARGS (GST_BUFFER_PTS (buffer)),
       GST_TIME_ARGS (GST_BUFFER_DTS (buffer)), priv->input_offset);
 
-  ts->offset = priv->input_offset;
-  ts->pts = GST_BUFFER_PTS (buffer);
-  ts->dts = GST_BUFFER_DTS (buffer);
-  ts->duration = GST_BUFFER_DURATION (buffer);
-  ts->flags = GST_BUFFER_FLAGS (buffer);
+  ts.offset = priv->input_offset;
+  ts.pts = GST_BUFFER_PTS (buffer);
+  ts.dts = GST_BUFFER_DTS (buffer);
+  ts.duration = GST_BUFFER_DURATION (buffer);
+  ts.flags = GST_BUFFER_FLAGS (buffer);
 
-  g_queue_push_tail (&priv->timestamps, ts);
+  gst_queue_array_push_tail_struct (priv->timestamps, &ts);
 
-  if (g_queue_get_length (&priv->timestamps) > 40) {
+  if (gst_queue_array_get_length (priv->timestamps) > 40) {
     GST_WARNING_OBJECT (decoder,
-        "decoder timestamp list getting long: %d timestamps,"
-        "possible internal leaking?", g_queue_get_length (&priv->timestamps));
+        "decoder timestamp list getting long: %u timestamps,"
+        "possible internal leaking?",
+        gst_queue_array_get_length (priv->timestamps));
   }
 }
 
@@ -2275,32 +2439,26 @@ gst_video_decoder_get_buffer_info_at_offset (GstVideoDecoder *
 #ifndef GST_DISABLE_GST_DEBUG
   guint64 got_offset = 0;
 #endif
+  GstQueueArray *timestamps = decoder->priv->timestamps;
   Timestamp *ts;
-  GList *g;
 
   *pts = GST_CLOCK_TIME_NONE;
   *dts = GST_CLOCK_TIME_NONE;
   *duration = GST_CLOCK_TIME_NONE;
   *flags = 0;
 
-  g = decoder->priv->timestamps.head;
-  while (g) {
-    ts = g->data;
-    if (ts->offset <= offset) {
-      GList *next = g->next;
+  while ((ts = gst_queue_array_peek_head_struct (timestamps))) {
+    if (ts->offset > offset)
+      break;
+
 #ifndef GST_DISABLE_GST_DEBUG
-      got_offset = ts->offset;
+    got_offset = ts->offset;
 #endif
-      *pts = ts->pts;
-      *dts = ts->dts;
-      *duration = ts->duration;
-      *flags = ts->flags;
-      g_queue_delete_link (&decoder->priv->timestamps, g);
-      g = next;
-      timestamp_free (ts);
-    } else {
-      break;
-    }
+    *pts = ts->pts;
+    *dts = ts->dts;
+    *duration = ts->duration;
+    *flags = ts->flags;
+    gst_queue_array_pop_head_struct (timestamps);
   }
 
   GST_LOG_OBJECT (decoder,
@@ -2321,6 +2479,45 @@ queue_clear_full (GQueue * queue, GDestroyNotify free_func)
 }
 #endif
 
+/* Pending frames are kept in order in priv->frames, and indexed by their
+ * system frame number for lookups from subclasses. */
+static void
+gst_video_decoder_frames_push (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = dec->priv;
+
+  g_queue_push_tail (&priv->frames, gst_video_codec_frame_ref (frame));
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
+}
+
+static GList *
+gst_video_decoder_frames_lookup (GstVideoDecoder * dec, guint32 frame_number)
+{
+  return g_hash_table_lookup (dec->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+}
+
+static gboolean
+gst_video_decoder_frames_remove (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = dec->priv;
+  GList *link;
+
+  link = gst_video_decoder_frames_lookup (dec, frame->system_frame_number);
+  if (!link || link->data != frame)
+    return FALSE;
+
+  g_hash_table_remove (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  g_queue_delete_link (&priv->frames, link);
+  gst_video_codec_frame_unref (frame);
+
+  return TRUE;
+}
+
 static void
 gst_video_decoder_clear_queues (GstVideoDecoder * dec)
 {
@@ -2339,6 +2536,7 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
+  g_hash_table_remove_all (priv->frames_index);
   g_queue_clear_full (&priv->frames,
       (GDestroyNotify) gst_video_codec_frame_unref);
 }
@@ -2356,6 +2554,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   if (full || flush_hard) {
     gst_segment_init (&decoder->input_segment, GST_FORMAT_UNDEFINED);
     gst_segment_init (&decoder->output_segment, GST_FORMAT_UNDEFINED);
+    gst_video_decoder_discard_frame_jobs (decoder);
     gst_video_decoder_clear_queues (decoder);
     decoder->priv->in_out_segment_sync = TRUE;
 
@@ -2412,6 +2611,11 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     priv->dropped = 0;
     priv->processed = 0;
 
+    GST_OBJECT_LOCK (decoder);
+    priv->avg_decode_time = 0;
+    priv->n_decode_times = 0;
+    GST_OBJECT_UNLOCK (decoder);
+
     priv->decode_frame_number = 0;
     priv->base_picture_number = 0;
 
@@ -2439,7 +2643,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   priv->frame_offset = 0;
   gst_adapter_clear (priv->input_adapter);
   gst_adapter_clear (priv->output_adapter);
-  g_queue_clear_full (&priv->timestamps, (GDestroyNotify) timestamp_free);
+  gst_queue_array_clear (priv->timestamps);
 
   GST_OBJECT_LOCK (decoder);
   priv->bytes_out = 0;
@@ -2909,6 +3113,10 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+      gst_video_decoder_discard_frame_jobs (decoder);
+      GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2968,9 +3176,7 @@ gst_video_decoder_new_frame (GstVideoDecoder * decoder)
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -3222,15 +3428,9 @@ void
 gst_video_decoder_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_queue_find (&dec->priv->frames, frame);
-  if (link) {
-    gst_video_codec_frame_unref (frame);
-    g_queue_delete_link (&dec->priv->frames, link);
-  }
+  gst_video_decoder_frames_remove (dec, frame);
   if (frame->events) {
     dec->priv->pending_events =
         g_list_concat (frame->events, dec->priv->pending_events);
@@ -3755,9 +3955,19 @@ gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
 
   /* release STREAM_LOCK not to block upstream
    * while pushing buffer downstream */
-  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
-  ret = gst_pad_push (decoder->srcpad, buf);
-  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  if (priv->decode_thread == g_thread_self ()) {
+    /* pushing from handle_frame(), don't count this as decode time */
+    GstClockTime push_start = gst_util_get_timestamp ();
+
+    GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+    ret = gst_pad_push (decoder->srcpad, buf);
+    GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+    priv->decode_push_time += gst_util_get_timestamp () - push_start;
+  } else {
+    GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+    ret = gst_pad_push (decoder->srcpad, buf);
+    GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  }
 
 done:
   return ret;
@@ -3930,6 +4140,156 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
   return ret;
 }
 
+static void
+gst_video_decoder_frame_thread_func (gpointer data, gpointer user_data)
+{
+  GstVideoDecoder *decoder = user_data;
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameJob *job = data;
+  GstClockTime start;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (decoder, "decoding frame %u",
+      job->frame->system_frame_number);
+
+  start = gst_util_get_timestamp ();
+  ret = decoder_class->decode_frame (decoder, job->frame);
+  gst_video_decoder_add_decode_time (decoder,
+      gst_util_get_timestamp () - start);
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  priv->frame_jobs_running--;
+  g_cond_broadcast (&priv->frame_jobs_cond);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Finishes the decoded frames at the head of the frame jobs in decoding
+ * order, and waits for more to be decoded until at most @max_jobs are
+ * left. Must be called with the stream lock held. */
+static GstFlowReturn
+gst_video_decoder_collect_frame_jobs (GstVideoDecoder * decoder, guint max_jobs)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while ((job = g_queue_peek_head (&priv->frame_jobs))) {
+    GstVideoCodecFrame *frame;
+    GstFlowReturn job_ret;
+    gboolean drop;
+
+    if (!job->done) {
+      if (priv->frame_jobs.length <= max_jobs)
+        break;
+      g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+      continue;
+    }
+
+    g_queue_pop_head (&priv->frame_jobs);
+    frame = job->frame;
+    job_ret = job->ret;
+    drop = job->drop;
+    g_slice_free (FrameJob, job);
+    g_mutex_unlock (&priv->frame_jobs_lock);
+
+    if (drop) {
+      job_ret = gst_video_decoder_drop_frame (decoder, frame);
+    } else if (job_ret == GST_FLOW_OK) {
+      job_ret = gst_video_decoder_finish_frame (decoder, frame);
+    } else {
+      guint32 frame_number = frame->system_frame_number;
+
+      gst_video_decoder_drop_frame (decoder, frame);
+      if (job_ret == GST_FLOW_ERROR)
+        GST_VIDEO_DECODER_ERROR (decoder, 1, STREAM, DECODE, (NULL),
+            ("Failed to decode frame %u", frame_number), job_ret);
+    }
+
+    /* report the first failure, but keep the output in order */
+    if (ret == GST_FLOW_OK)
+      ret = job_ret;
+
+    g_mutex_lock (&priv->frame_jobs_lock);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return ret;
+}
+
+/* Waits for the frame threads and releases the frames they decoded without
+ * output. Must be called with the stream lock held. */
+static void
+gst_video_decoder_discard_frame_jobs (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while (priv->frame_jobs_running > 0)
+    g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+
+  while ((job = g_queue_pop_head (&priv->frame_jobs))) {
+    g_mutex_unlock (&priv->frame_jobs_lock);
+    gst_video_decoder_release_frame (decoder, job->frame);
+    g_slice_free (FrameJob, job);
+    g_mutex_lock (&priv->frame_jobs_lock);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Hands @frame to the frame threads once its output buffer is allocated.
+ * Frames that are already too late are dropped without decoding. */
+static GstFlowReturn
+gst_video_decoder_dispatch_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstFlowReturn ret;
+  FrameJob *job;
+
+  /* bound the number of frames in flight */
+  ret = gst_video_decoder_collect_frame_jobs (decoder,
+      priv->n_frame_threads - 1);
+  if (ret != GST_FLOW_OK) {
+    gst_video_decoder_release_frame (decoder, frame);
+    return ret;
+  }
+
+  job = g_slice_new0 (FrameJob);
+  job->frame = frame;
+
+  if (priv->do_qos && gst_video_decoder_get_max_decode_time (decoder,
+          frame) < 0) {
+    GST_DEBUG_OBJECT (decoder, "frame %u is too late, not decoding",
+        frame->system_frame_number);
+    job->drop = TRUE;
+    job->done = TRUE;
+  } else {
+    ret = gst_video_decoder_allocate_output_frame (decoder, frame);
+    if (ret != GST_FLOW_OK) {
+      g_slice_free (FrameJob, job);
+      gst_video_decoder_release_frame (decoder, frame);
+      return ret;
+    }
+  }
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&priv->frame_jobs, job);
+  if (!job->done) {
+    priv->frame_jobs_running++;
+    g_thread_pool_push (priv->frame_threads, job, NULL);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  /* and output what was decoded meanwhile */
+  return gst_video_decoder_collect_frame_jobs (decoder,
+      priv->n_frame_threads);
+}
+
 /* Pass the frame in priv->current_frame through the
  * handle_frame() callback for decoding and passing to gvd_finish_frame(),
  * or dropping by passing to gvd_drop_frame() */
@@ -4014,9 +4374,9 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       "frame %p PTS %" GST_TIME_FORMAT ", DTS %" GST_TIME_FORMAT ", dist %d",
       frame, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts),
       frame->distance_from_sync);
-  /* FIXME: suboptimal way to add a unique frame to the list, in case of subframe mode. */
-  if (!g_queue_find (&priv->frames, frame)) {
-    g_queue_push_tail (&priv->frames, gst_video_codec_frame_ref (frame));
+  /* in subframe mode, the frame is already pending after the first subframe */
+  if (!gst_video_decoder_frames_lookup (decoder, frame->system_frame_number)) {
+    gst_video_decoder_frames_push (decoder, frame);
   } else {
     GST_LOG_OBJECT (decoder,
         "Do not add an existing frame used to decode subframes");
@@ -4028,7 +4388,28 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
   }
 
   /* do something with frame */
-  ret = decoder_class->handle_frame (decoder, frame);
+  if (priv->frame_threads && decoder_class->decode_frame
+      && priv->output_state && decoder->input_segment.rate > 0.0
+      && !priv->subframe_mode) {
+    ret = gst_video_decoder_dispatch_frame (decoder, frame);
+  } else {
+    /* frames decoded by the frame threads are output first */
+    if (priv->frame_jobs.length > 0)
+      ret = gst_video_decoder_collect_frame_jobs (decoder, 0);
+
+    if (ret == GST_FLOW_OK) {
+      GstClockTime start = gst_util_get_timestamp ();
+
+      priv->decode_thread = g_thread_self ();
+      priv->decode_push_time = 0;
+      ret = decoder_class->handle_frame (decoder, frame);
+      priv->decode_thread = NULL;
+      gst_video_decoder_add_decode_time (decoder,
+          gst_util_get_timestamp () - start - priv->decode_push_time);
+    } else {
+      gst_video_decoder_release_frame (decoder, frame);
+    }
+  }
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
 
@@ -4199,20 +4580,15 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
 GstVideoCodecFrame *
 gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
 {
-  GList *g;
+  GList *link;
   GstVideoCodecFrame *frame = NULL;
 
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames.head; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  link = gst_video_decoder_frames_lookup (decoder, frame_number);
+  if (link)
+    frame = gst_video_codec_frame_ref (link->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -4801,6 +5177,53 @@ gst_video_decoder_get_max_decode_time (GstVideoDecoder *
   return deadline;
 }
 
+/**
+ * gst_video_decoder_get_decode_budget:
+ * @decoder: a #GstVideoDecoder
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Determines how much time is left to decode @frame in time after the
+ * average time the recent frames took to decode, as measured by the base
+ * class around #GstVideoDecoderClass::handle_frame.
+ *
+ * A negative budget means that @frame will likely be late if it is decoded
+ * with full effort. Subclasses can use this to degrade gracefully, e.g. by
+ * skipping the loop filter or decoding reference frames only, before the
+ * frame would have to be dropped.
+ *
+ * Returns: the decode budget for @frame, or G_MAXINT64 if QoS is disabled or
+ * there is no QoS information yet.
+ *
+ * Since: 1.20
+ */
+GstClockTimeDiff
+gst_video_decoder_get_decode_budget (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstClockTimeDiff deadline;
+  GstClockTime avg_decode_time;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), G_MAXINT64);
+  g_return_val_if_fail (frame != NULL, G_MAXINT64);
+
+  if (!decoder->priv->do_qos)
+    return G_MAXINT64;
+
+  deadline = gst_video_decoder_get_max_decode_time (decoder, frame);
+  if (deadline == G_MAXINT64)
+    return G_MAXINT64;
+
+  GST_OBJECT_LOCK (decoder);
+  avg_decode_time = decoder->priv->avg_decode_time;
+  GST_OBJECT_UNLOCK (decoder);
+
+  GST_LOG_OBJECT (decoder, "frame %u deadline %" GST_STIME_FORMAT
+      ", average decode time %" GST_TIME_FORMAT, frame->system_frame_number,
+      GST_STIME_ARGS (deadline), GST_TIME_ARGS (avg_decode_time));
+
+  return deadline - (GstClockTimeDiff) avg_decode_time;
+}
+
 /**
  * gst_video_decoder_get_qos_proportion:
  * @decoder: a #GstVideoDecoder
@@ -5388,3 +5811,97 @@ gst_video_decoder_get_needs_sync_point (GstVideoDecoder * dec)
 
   return result;
 }
+
+/**
+ * gst_video_decoder_set_frame_threads:
+ * @dec: a #GstVideoDecoder
+ * @n_threads: number of frames to decode concurrently, or 0 for the number
+ *     of processors
+ *
+ * Configures the decoder to decode up to @n_threads frames concurrently with
+ * the #GstVideoDecoderClass::decode_frame virtual method. This is only
+ * suitable for streams in which every frame can be decoded independently,
+ * in the order of presentation, e.g. intra-only codecs.
+ *
+ * Frames are passed to #GstVideoDecoderClass::handle_frame as usual until
+ * an output state is set, in reverse playback and in subframe mode. Decoded
+ * frames are finished in decoding order, and frames that are already late
+ * are dropped without decoding if QoS is enabled. The reported latency is
+ * increased by one frame duration per thread.
+ *
+ * A value of 1 disables frame threading, which is the default.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_decoder_set_frame_threads (GstVideoDecoder * dec, guint n_threads)
+{
+  GstVideoDecoderPrivate *priv;
+  GThreadPool *frame_threads = NULL;
+
+  g_return_if_fail (GST_IS_VIDEO_DECODER (dec));
+
+  priv = dec->priv;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_VIDEO_DECODER_STREAM_LOCK (dec);
+  if (n_threads == priv->n_frame_threads) {
+    GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (dec, "using %u frame threads", n_threads);
+
+  gst_video_decoder_collect_frame_jobs (dec, 0);
+
+  if (n_threads > 1) {
+    GError *err = NULL;
+
+    frame_threads =
+        g_thread_pool_new (gst_video_decoder_frame_thread_func, dec,
+        n_threads, FALSE, &err);
+    if (!frame_threads) {
+      GST_WARNING_OBJECT (dec, "failed to create frame threads: %s",
+          err->message);
+      g_clear_error (&err);
+      n_threads = 1;
+    }
+  }
+
+  if (priv->frame_threads)
+    g_thread_pool_free (priv->frame_threads, FALSE, TRUE);
+  priv->frame_threads = frame_threads;
+
+  GST_OBJECT_LOCK (dec);
+  priv->n_frame_threads = n_threads;
+  GST_OBJECT_UNLOCK (dec);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+
+  gst_element_post_message (GST_ELEMENT_CAST (dec),
+      gst_message_new_latency (GST_OBJECT_CAST (dec)));
+}
+
+/**
+ * gst_video_decoder_get_frame_threads:
+ * @dec: a #GstVideoDecoder
+ *
+ * Returns: the number of frames decoded concurrently, see
+ *     gst_video_decoder_set_frame_threads()
+ *
+ * Since: 1.20
+ */
+guint
+gst_video_decoder_get_frame_threads (GstVideoDecoder * dec)
+{
+  guint result;
+
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (dec), 1);
+
+  GST_OBJECT_LOCK (dec);
+  result = dec->priv->n_frame_threads;
+  GST_OBJECT_UNLOCK (dec);
+
+  return result;
+}
@@ -358,8 +358,27 @@ struct _GstVideoDecoderClass
                                         GstClockTime timestamp,
                                         GstClockTime duration);
 
+  /**
+   * GstVideoDecoderClass::decode_frame:
+   * @decoder: The #GstVideoDecoder
+   * @frame: The frame to decode
+   *
+   * Decodes @frame into the already allocated
+   * #GstVideoCodecFrame.output_buffer when frame threading is enabled with
+   * gst_video_decoder_set_frame_threads(). Called from a worker thread
+   * without the stream lock held, possibly concurrently for several frames.
+   * The frame must not be finished or dropped by the subclass.
+   *
+   * Returns: #GST_FLOW_OK if the frame was decoded, #GST_FLOW_ERROR if it
+   * could not be decoded.
+   *
+   * Since: 1.20
+   */
+  GstFlowReturn (*decode_frame)   (GstVideoDecoder *decoder,
+                                   GstVideoCodecFrame *frame);
+
   /*< private >*/
-  gpointer padding[GST_PADDING_LARGE-7];
+  gpointer padding[GST_PADDING_LARGE-8];
 };
 
 /**
@@ -432,6 +451,13 @@ void     gst_video_decoder_set_needs_sync_point (GstVideoDecoder * dec,
 GST_VIDEO_API
 gboolean gst_video_decoder_get_needs_sync_point (GstVideoDecoder * dec);
 
+GST_VIDEO_API
+void     gst_video_decoder_set_frame_threads (GstVideoDecoder * dec,
+                                              guint n_threads);
+
+GST_VIDEO_API
+guint    gst_video_decoder_get_frame_threads (GstVideoDecoder * dec);
+
 GST_VIDEO_API
 void     gst_video_decoder_set_latency (GstVideoDecoder *decoder,
 					GstClockTime min_latency,
@@ -510,6 +536,10 @@ GST_VIDEO_API
 GstClockTimeDiff gst_video_decoder_get_max_decode_time (GstVideoDecoder *decoder,
 							GstVideoCodecFrame *frame);
 
+GST_VIDEO_API
+GstClockTimeDiff gst_video_decoder_get_decode_budget (GstVideoDecoder *decoder,
+                                                      GstVideoCodecFrame *frame);
+
 GST_VIDEO_API
 gdouble          gst_video_decoder_get_qos_proportion (GstVideoDecoder * decoder);
 
@@ -148,6 +148,19 @@ struct _GstVideoEncoderPrivate
   guint32 system_frame_number;
 
   GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> link in frames */
+  GHashTable *frames_index;
+  GstVideoCodecFramePool *frame_pool;
+
+  /* frame threading */
+  guint n_frame_threads;
+  GThreadPool *frame_threads;
+  GMutex frame_jobs_lock;
+  GCond frame_jobs_cond;
+  /* of FrameJob in input order, protected by frame_jobs_lock */
+  GQueue frame_jobs;
+  guint frame_jobs_running;
+
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -182,6 +195,19 @@ struct _GstVideoEncoderPrivate
   guint processed;
 };
 
+/* A frame handed to the frame threads, see
+ * gst_video_encoder_set_frame_threads() */
+typedef struct _FrameJob FrameJob;
+struct _FrameJob
+{
+  GstVideoCodecFrame *frame;
+  GstFlowReturn ret;
+  /* TRUE once encode_frame() returned */
+  gboolean done;
+  /* too late for QoS, to be dropped in order without encoding */
+  gboolean drop;
+};
+
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
 struct _ForcedKeyUnitEvent
 {
@@ -277,6 +303,13 @@ static gboolean gst_video_encoder_propose_allocation_default (GstVideoEncoder *
 static gboolean gst_video_encoder_negotiate_default (GstVideoEncoder * encoder);
 static gboolean gst_video_encoder_negotiate_unlocked (GstVideoEncoder *
     encoder);
+static GstFlowReturn gst_video_encoder_collect_frame_jobs (GstVideoEncoder *
+    encoder, guint max_jobs);
+static void gst_video_encoder_discard_frame_jobs (GstVideoEncoder * encoder);
+static void gst_video_encoder_release_frame (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame);
+static void gst_video_encoder_drop_frame (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame);
 
 static gboolean gst_video_encoder_sink_query_default (GstVideoEncoder * encoder,
     GstQuery * query);
@@ -456,6 +489,45 @@ queue_clear_full (GQueue * queue, GDestroyNotify free_func)
 }
 #endif
 
+/* Pending frames are kept in order in priv->frames, and indexed by their
+ * system frame number for lookups from subclasses. */
+static void
+gst_video_encoder_frames_push (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = enc->priv;
+
+  g_queue_push_tail (&priv->frames, gst_video_codec_frame_ref (frame));
+  g_hash_table_insert (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number), priv->frames.tail);
+}
+
+static GList *
+gst_video_encoder_frames_lookup (GstVideoEncoder * enc, guint32 frame_number)
+{
+  return g_hash_table_lookup (enc->priv->frames_index,
+      GUINT_TO_POINTER (frame_number));
+}
+
+static gboolean
+gst_video_encoder_frames_remove (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = enc->priv;
+  GList *link;
+
+  link = gst_video_encoder_frames_lookup (enc, frame->system_frame_number);
+  if (!link || link->data != frame)
+    return FALSE;
+
+  g_hash_table_remove (priv->frames_index,
+      GUINT_TO_POINTER (frame->system_frame_number));
+  g_queue_delete_link (&priv->frames, link);
+  gst_video_codec_frame_unref (frame);
+
+  return TRUE;
+}
+
 static gboolean
 gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
 {
@@ -464,6 +536,8 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
+  gst_video_encoder_discard_frame_jobs (encoder);
+
   priv->presentation_frame_number = 0;
   priv->distance_from_sync = 0;
 
@@ -536,6 +610,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
+  g_hash_table_remove_all (priv->frames_index);
   g_queue_clear_full (&priv->frames,
       (GDestroyNotify) gst_video_codec_frame_unref);
 
@@ -551,6 +626,9 @@ gst_video_encoder_flush (GstVideoEncoder * encoder)
   GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
   gboolean ret = TRUE;
 
+  /* The subclass must not be encoding anything when it is flushed */
+  gst_video_encoder_discard_frame_jobs (encoder);
+
   if (klass->flush)
     ret = klass->flush (encoder);
 
@@ -602,6 +680,12 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->new_headers = FALSE;
 
   g_queue_init (&priv->frames);
+  priv->frames_index = g_hash_table_new (NULL, NULL);
+  priv->frame_pool = __gst_video_codec_frame_pool_new ();
+  priv->n_frame_threads = 1;
+  g_mutex_init (&priv->frame_jobs_lock);
+  g_cond_init (&priv->frame_jobs_cond);
+  g_queue_init (&priv->frame_jobs);
   g_queue_init (&priv->force_key_unit);
 
   priv->min_latency = 0;
@@ -728,6 +812,7 @@ gst_video_encoder_setcaps (GstVideoEncoder * encoder, GstCaps * caps)
 {
   GstVideoEncoderClass *encoder_class;
   GstVideoCodecState *state;
+  GstFlowReturn flow_ret;
   gboolean ret = TRUE;
 
   encoder_class = GST_VIDEO_ENCODER_GET_CLASS (encoder);
@@ -755,6 +840,13 @@ gst_video_encoder_setcaps (GstVideoEncoder * encoder, GstCaps * caps)
     goto caps_not_changed;
   }
 
+  /* frames still being encoded belong to the previous format */
+  flow_ret = gst_video_encoder_collect_frame_jobs (encoder, 0);
+  if (flow_ret != GST_FLOW_OK) {
+    gst_video_codec_state_unref (state);
+    goto collect_failed;
+  }
+
   if (encoder_class->reset) {
     GST_FIXME_OBJECT (encoder, "GstVideoEncoder::reset() is deprecated");
     encoder_class->reset (encoder, TRUE);
@@ -793,6 +885,13 @@ parse_fail:
     GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
     return FALSE;
   }
+collect_failed:
+  {
+    GST_WARNING_OBJECT (encoder, "Failed to output pending frames: %s",
+        gst_flow_get_name (flow_ret));
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return FALSE;
+  }
 }
 
 /**
@@ -1009,6 +1108,14 @@ gst_video_encoder_finalize (GObject * object)
   encoder = GST_VIDEO_ENCODER (object);
   g_rec_mutex_clear (&encoder->stream_lock);
 
+  if (encoder->priv->frame_threads)
+    g_thread_pool_free (encoder->priv->frame_threads, FALSE, TRUE);
+  g_mutex_clear (&encoder->priv->frame_jobs_lock);
+  g_cond_clear (&encoder->priv->frame_jobs_cond);
+
+  g_hash_table_unref (encoder->priv->frames_index);
+  __gst_video_codec_frame_pool_free (encoder->priv->frame_pool);
+
   if (encoder->priv->allocator) {
     gst_object_unref (encoder->priv->allocator);
     encoder->priv->allocator = NULL;
@@ -1130,10 +1237,11 @@ gst_video_encoder_sink_event_default (GstVideoEncoder * encoder,
 
       GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
-      if (encoder_class->finish) {
+      /* output all frames still being encoded by the frame threads */
+      flow_ret = gst_video_encoder_collect_frame_jobs (encoder, 0);
+
+      if (flow_ret == GST_FLOW_OK && encoder_class->finish) {
         flow_ret = encoder_class->finish (encoder);
-      } else {
-        flow_ret = GST_FLOW_OK;
       }
 
       if (encoder->priv->current_frame_events) {
@@ -1460,6 +1568,19 @@ gst_video_encoder_src_query_default (GstVideoEncoder * enc, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += enc->priv->max_latency;
+
+        /* frame threads hold back up to one frame each */
+        if (priv->n_frame_threads > 1 && priv->input_state &&
+            priv->input_state->info.fps_n > 0) {
+          GstClockTime frame_latency;
+
+          frame_latency = gst_util_uint64_scale (priv->n_frame_threads,
+              GST_SECOND * priv->input_state->info.fps_d,
+              priv->input_state->info.fps_n);
+          min_latency += frame_latency;
+          if (max_latency != GST_CLOCK_TIME_NONE)
+            max_latency += frame_latency;
+        }
         GST_OBJECT_UNLOCK (enc);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -1502,9 +1623,7 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   GstVideoEncoderPrivate *priv = encoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = __gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -1526,6 +1645,142 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
 }
 
 
+static void
+gst_video_encoder_frame_thread_func (gpointer data, gpointer user_data)
+{
+  GstVideoEncoder *encoder = user_data;
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameJob *job = data;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (encoder, "encoding frame %u",
+      job->frame->system_frame_number);
+
+  ret = klass->encode_frame (encoder, job->frame);
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  job->ret = ret;
+  job->done = TRUE;
+  priv->frame_jobs_running--;
+  g_cond_broadcast (&priv->frame_jobs_cond);
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Finishes the encoded frames at the head of the frame jobs in input order,
+ * and waits for more to be encoded until at most @max_jobs are left.
+ * Must be called with the stream lock held. */
+static GstFlowReturn
+gst_video_encoder_collect_frame_jobs (GstVideoEncoder * encoder, guint max_jobs)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret = GST_FLOW_OK;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while ((job = g_queue_peek_head (&priv->frame_jobs))) {
+    GstVideoCodecFrame *frame;
+    GstFlowReturn job_ret;
+    gboolean drop;
+
+    if (!job->done) {
+      if (priv->frame_jobs.length <= max_jobs)
+        break;
+      g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+      continue;
+    }
+
+    g_queue_pop_head (&priv->frame_jobs);
+    frame = job->frame;
+    job_ret = job->ret;
+    drop = job->drop;
+    g_slice_free (FrameJob, job);
+    g_mutex_unlock (&priv->frame_jobs_lock);
+
+    if (drop) {
+      gst_video_encoder_drop_frame (encoder, frame);
+    } else if (job_ret == GST_FLOW_OK) {
+      job_ret = gst_video_encoder_finish_frame (encoder, frame);
+    } else {
+      if (job_ret == GST_FLOW_ERROR)
+        GST_ELEMENT_ERROR (encoder, STREAM, ENCODE, (NULL),
+            ("Failed to encode frame %u", frame->system_frame_number));
+      gst_video_encoder_drop_frame (encoder, frame);
+    }
+
+    /* report the first failure, but keep the output in order */
+    if (ret == GST_FLOW_OK)
+      ret = job_ret;
+
+    g_mutex_lock (&priv->frame_jobs_lock);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  return ret;
+}
+
+/* Waits for the frame threads and releases the frames they encoded without
+ * output. Must be called with the stream lock held. */
+static void
+gst_video_encoder_discard_frame_jobs (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameJob *job;
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  while (priv->frame_jobs_running > 0)
+    g_cond_wait (&priv->frame_jobs_cond, &priv->frame_jobs_lock);
+
+  while ((job = g_queue_pop_head (&priv->frame_jobs))) {
+    g_mutex_unlock (&priv->frame_jobs_lock);
+    gst_video_encoder_release_frame (encoder, job->frame);
+    g_slice_free (FrameJob, job);
+    g_mutex_lock (&priv->frame_jobs_lock);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+}
+
+/* Hands @frame to the frame threads. Frames that are already too late are
+ * dropped without encoding. */
+static GstFlowReturn
+gst_video_encoder_dispatch_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+  FrameJob *job;
+
+  /* bound the number of frames in flight */
+  ret = gst_video_encoder_collect_frame_jobs (encoder,
+      priv->n_frame_threads - 1);
+  if (ret != GST_FLOW_OK) {
+    gst_video_encoder_release_frame (encoder, frame);
+    return ret;
+  }
+
+  job = g_slice_new0 (FrameJob);
+  job->frame = frame;
+
+  if (gst_video_encoder_get_max_encode_time (encoder, frame) < 0) {
+    GST_DEBUG_OBJECT (encoder, "frame %u is too late, not encoding",
+        frame->system_frame_number);
+    job->drop = TRUE;
+    job->done = TRUE;
+  }
+
+  g_mutex_lock (&priv->frame_jobs_lock);
+  g_queue_push_tail (&priv->frame_jobs, job);
+  if (!job->done) {
+    priv->frame_jobs_running++;
+    g_thread_pool_push (priv->frame_threads, job, NULL);
+  }
+  g_mutex_unlock (&priv->frame_jobs_lock);
+
+  /* and output what was encoded meanwhile */
+  return gst_video_encoder_collect_frame_jobs (encoder,
+      priv->n_frame_threads);
+}
+
 static GstFlowReturn
 gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
@@ -1704,7 +1959,7 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   }
   GST_OBJECT_UNLOCK (encoder);
 
-  g_queue_push_tail (&priv->frames, gst_video_codec_frame_ref (frame));
+  gst_video_encoder_frames_push (encoder, frame);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1716,7 +1971,10 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       gst_segment_to_running_time (&encoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
-  ret = klass->handle_frame (encoder, frame);
+  if (priv->frame_threads && klass->encode_frame)
+    ret = gst_video_encoder_dispatch_frame (encoder, frame);
+  else
+    ret = klass->handle_frame (encoder, frame);
 
 done:
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
@@ -1768,6 +2026,10 @@ gst_video_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+      gst_video_encoder_discard_frame_jobs (encoder);
+      GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
       if (encoder_class->stop)
         stopped = encoder_class->stop (encoder);
 
@@ -2143,14 +2405,8 @@ static void
 gst_video_encoder_release_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
-  link = g_queue_find (&enc->priv->frames, frame);
-  if (link) {
-    gst_video_codec_frame_unref (frame);
-    g_queue_delete_link (&enc->priv->frames, link);
-  }
+  gst_video_encoder_frames_remove (enc, frame);
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
 }
@@ -2931,20 +3187,15 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
 GstVideoCodecFrame *
 gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
 {
-  GList *g;
+  GList *link;
   GstVideoCodecFrame *frame = NULL;
 
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames.head; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  link = gst_video_encoder_frames_lookup (encoder, frame_number);
+  if (link)
+    frame = gst_video_codec_frame_ref (link->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -3190,3 +3441,96 @@ gst_video_encoder_get_min_force_key_unit_interval (GstVideoEncoder * encoder)
 
   return interval;
 }
+
+/**
+ * gst_video_encoder_set_frame_threads:
+ * @encoder: the encoder
+ * @n_threads: number of frames to encode concurrently, or 0 for the number
+ *     of processors
+ *
+ * Configures the encoder to encode up to @n_threads frames concurrently with
+ * the #GstVideoEncoderClass::encode_frame virtual method instead of passing
+ * them to #GstVideoEncoderClass::handle_frame. This is only suitable for
+ * encoders that encode every frame independently, e.g. intra-only codecs.
+ *
+ * Encoded frames are finished in input order, and frames that are already
+ * late are dropped without encoding if QoS is enabled. The reported latency
+ * is increased by one frame duration per thread.
+ *
+ * A value of 1 disables frame threading, which is the default.
+ *
+ * Since: 1.20
+ */
+void
+gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder,
+    guint n_threads)
+{
+  GstVideoEncoderPrivate *priv;
+  GThreadPool *frame_threads = NULL;
+
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  priv = encoder->priv;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  if (n_threads == priv->n_frame_threads) {
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (encoder, "using %u frame threads", n_threads);
+
+  gst_video_encoder_collect_frame_jobs (encoder, 0);
+
+  if (n_threads > 1) {
+    GError *err = NULL;
+
+    frame_threads =
+        g_thread_pool_new (gst_video_encoder_frame_thread_func, encoder,
+        n_threads, FALSE, &err);
+    if (!frame_threads) {
+      GST_WARNING_OBJECT (encoder, "failed to create frame threads: %s",
+          err->message);
+      g_clear_error (&err);
+      n_threads = 1;
+    }
+  }
+
+  if (priv->frame_threads)
+    g_thread_pool_free (priv->frame_threads, FALSE, TRUE);
+  priv->frame_threads = frame_threads;
+
+  GST_OBJECT_LOCK (encoder);
+  priv->n_frame_threads = n_threads;
+  GST_OBJECT_UNLOCK (encoder);
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  gst_element_post_message (GST_ELEMENT_CAST (encoder),
+      gst_message_new_latency (GST_OBJECT_CAST (encoder)));
+}
+
+/**
+ * gst_video_encoder_get_frame_threads:
+ * @encoder: the encoder
+ *
+ * Returns: the number of frames encoded concurrently, see
+ *     gst_video_encoder_set_frame_threads()
+ *
+ * Since: 1.20
+ */
+guint
+gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder)
+{
+  guint n_threads;
+
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), 1);
+
+  GST_OBJECT_LOCK (encoder);
+  n_threads = encoder->priv->n_frame_threads;
+  GST_OBJECT_UNLOCK (encoder);
+
+  return n_threads;
+}
@@ -295,8 +295,29 @@ struct _GstVideoEncoderClass
                                    GstVideoCodecFrame *frame,
                                    GstMeta * meta);
 
+  /**
+   * GstVideoEncoderClass::encode_frame:
+   * @encoder: The #GstVideoEncoder
+   * @frame: The frame to encode
+   *
+   * Encodes @frame into a newly allocated #GstVideoCodecFrame.output_buffer
+   * when frame threading is enabled with
+   * gst_video_encoder_set_frame_threads(). Called from a worker thread
+   * without the stream lock held, possibly concurrently for several frames.
+   * The frame must not be finished or dropped by the subclass, and the
+   * output buffer must not be allocated with
+   * gst_video_encoder_allocate_output_buffer().
+   *
+   * Returns: #GST_FLOW_OK if the frame was encoded, #GST_FLOW_ERROR if it
+   * could not be encoded.
+   *
+   * Since: 1.20
+   */
+  GstFlowReturn (*encode_frame)   (GstVideoEncoder *encoder,
+                                   GstVideoCodecFrame *frame);
+
   /*< private >*/
-  gpointer       _gst_reserved[GST_PADDING_LARGE-4];
+  gpointer       _gst_reserved[GST_PADDING_LARGE-5];
 };
 
 GST_VIDEO_API
@@ -387,6 +408,13 @@ void                 gst_video_encoder_set_min_force_key_unit_interval (GstVideo
 GST_VIDEO_API
 GstClockTime         gst_video_encoder_get_min_force_key_unit_interval (GstVideoEncoder * encoder);
 
+GST_VIDEO_API
+void                 gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder,
+                                                          guint n_threads);
+
+GST_VIDEO_API
+guint                gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoEncoder, gst_object_unref)
 
 G_END_DECLS
@@ -23,6 +23,15 @@
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
 
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
 #define GST_CAT_DEFAULT gst_video_pool_debug
@@ -38,6 +47,12 @@ GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
  * Allows configuration of video-specific requirements such as
  * stride alignments or pixel padding, and can also be configured
  * to automatically add #GstVideoMeta to the buffers.
+ *
+ * Since 1.20, the system memory of the buffers can be backed by huge pages,
+ * placed on the local NUMA node and prefaulted at allocation with the
+ * #GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+ * #GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL and
+ * #GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT options.
  */
 
 /**
@@ -103,8 +118,20 @@ struct _GstVideoBufferPoolPrivate
   gboolean need_alignment;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  gboolean huge_pages;
+  gboolean prefault;
+  /* -1 if memory is not bound to a NUMA node */
+  gint numa_node;
+  /* TRUE if memory is mapped by the pool instead of the allocator */
+  gboolean map_memory;
 };
 
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+/* smallest page size that is in use, touching every such page faults in
+ * all pages with any bigger size as well */
+#define MIN_PAGE_SIZE 4096
+
 static void gst_video_buffer_pool_finalize (GObject * object);
 
 #define gst_video_buffer_pool_parent_class parent_class
@@ -115,11 +142,149 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT,
+    GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL, NULL
   };
   return options;
 }
 
+#if defined(__linux__) && defined(SYS_getcpu) && defined(SYS_mbind)
+#define VIDEO_POOL_MPOL_PREFERRED 1
+#define VIDEO_POOL_MAX_NUMA_NODES 256
+#define VIDEO_POOL_BITS_PER_LONG (8 * sizeof (unsigned long))
+
+static gint
+video_buffer_pool_get_numa_node (void)
+{
+  unsigned int cpu, node;
+
+  if (syscall (SYS_getcpu, &cpu, &node, NULL) < 0)
+    return -1;
+
+  return node < VIDEO_POOL_MAX_NUMA_NODES ? (gint) node : -1;
+}
+
+static void
+video_buffer_pool_bind_numa (GstVideoBufferPool * vpool, gpointer data,
+    gsize size)
+{
+  unsigned long nodemask[VIDEO_POOL_MAX_NUMA_NODES /
+      VIDEO_POOL_BITS_PER_LONG] = { 0, };
+  guint node = vpool->priv->numa_node;
+
+  nodemask[node / VIDEO_POOL_BITS_PER_LONG] |=
+      1UL << (node % VIDEO_POOL_BITS_PER_LONG);
+
+  /* the kernel expects the number of bits in the mask plus one */
+  if (syscall (SYS_mbind, data, size, VIDEO_POOL_MPOL_PREFERRED, nodemask,
+          (unsigned long) VIDEO_POOL_MAX_NUMA_NODES + 1, 0) < 0)
+    GST_DEBUG_OBJECT (vpool, "failed to bind memory to NUMA node %u", node);
+}
+#else
+static gint
+video_buffer_pool_get_numa_node (void)
+{
+  return -1;
+}
+
+#define video_buffer_pool_bind_numa(vpool, data, size)
+#endif
+
+#ifdef HAVE_MMAP
+typedef struct
+{
+  gpointer data;
+  gsize size;
+} MappedRegion;
+
+static void
+mapped_region_free (MappedRegion * region)
+{
+  munmap (region->data, region->size);
+  g_slice_free (MappedRegion, region);
+}
+
+/* Maps anonymous memory for a buffer of @size, backed by huge pages and
+ * bound to a NUMA node as configured. */
+static GstBuffer *
+video_buffer_pool_alloc_mapped (GstVideoBufferPool * vpool, gsize size)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  GstAllocationParams *params = &priv->params;
+  MappedRegion *region;
+  GstMemory *mem;
+  GstBuffer *buffer;
+  gpointer data = MAP_FAILED;
+  gsize maxsize;
+
+  maxsize = params->prefix + size + params->padding;
+  if (priv->huge_pages)
+    maxsize = GST_ROUND_UP_N (maxsize, HUGE_PAGE_SIZE);
+
+#ifdef MAP_HUGETLB
+  if (priv->huge_pages) {
+    data = mmap (NULL, maxsize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data == MAP_FAILED)
+      GST_LOG_OBJECT (vpool, "no reserved huge pages available");
+  }
+#endif
+
+  if (data == MAP_FAILED) {
+    data = mmap (NULL, maxsize, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      GST_WARNING_OBJECT (vpool, "failed to map %" G_GSIZE_FORMAT " bytes: %s",
+          maxsize, g_strerror (errno));
+      return NULL;
+    }
+#ifdef MADV_HUGEPAGE
+    if (priv->huge_pages && madvise (data, maxsize, MADV_HUGEPAGE) < 0)
+      GST_LOG_OBJECT (vpool, "transparent huge pages not available");
+#endif
+  }
+
+  /* binding only moves pages that are faulted in after this */
+  if (priv->numa_node >= 0)
+    video_buffer_pool_bind_numa (vpool, data, maxsize);
+
+  region = g_slice_new (MappedRegion);
+  region->data = data;
+  region->size = maxsize;
+
+  mem = gst_memory_new_wrapped (params->flags, data, maxsize, params->prefix,
+      size, region, (GDestroyNotify) mapped_region_free);
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, mem);
+
+  return buffer;
+}
+#endif
+
+static void
+video_buffer_pool_prefault (GstBuffer * buffer)
+{
+  guint i, n_mem;
+
+  n_mem = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+    GstMapInfo map;
+    gsize offset;
+
+    if (!gst_memory_map (mem, &map, GST_MAP_WRITE))
+      continue;
+
+    for (offset = 0; offset < map.size; offset += MIN_PAGE_SIZE)
+      ((volatile guint8 *) map.data)[offset] = 0;
+
+    gst_memory_unmap (mem, &map);
+  }
+}
+
 static gboolean
 video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
 {
@@ -169,6 +334,28 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
   priv->need_alignment = gst_buffer_pool_config_has_option (config,
       GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
 
+  priv->huge_pages = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  priv->prefault = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  if (gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL))
+    priv->numa_node = video_buffer_pool_get_numa_node ();
+  else
+    priv->numa_node = -1;
+
+  /* only system memory can be mapped by the pool itself */
+#ifdef HAVE_MMAP
+  priv->map_memory = (priv->huge_pages || priv->numa_node >= 0)
+      && (!allocator || g_strcmp0 (allocator->mem_type,
+              GST_ALLOCATOR_SYSMEM) == 0);
+#else
+  priv->map_memory = FALSE;
+#endif
+
+  GST_DEBUG_OBJECT (pool, "huge pages %d, prefault %d, NUMA node %d",
+      priv->huge_pages, priv->prefault, priv->numa_node);
+
   if (priv->need_alignment && priv->add_videometa) {
     /* get and apply the alignment to the info */
     gst_buffer_pool_config_get_video_alignment (config, &priv->video_align);
@@ -230,11 +417,19 @@ video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
 
   GST_DEBUG_OBJECT (pool, "alloc %" G_GSIZE_FORMAT, info->size);
 
-  *buffer =
-      gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
+#ifdef HAVE_MMAP
+  if (priv->map_memory)
+    *buffer = video_buffer_pool_alloc_mapped (vpool, info->size);
+  else
+#endif
+    *buffer =
+        gst_buffer_new_allocate (priv->allocator, info->size, &priv->params);
   if (*buffer == NULL)
     goto no_memory;
 
+  if (priv->prefault)
+    video_buffer_pool_prefault (*buffer);
+
   if (priv->add_videometa) {
     GST_DEBUG_OBJECT (pool, "adding GstVideoMeta");
 
@@ -295,6 +490,7 @@ static void
 gst_video_buffer_pool_init (GstVideoBufferPool * pool)
 {
   pool->priv = gst_video_buffer_pool_get_instance_private (pool);
+  pool->priv->numa_node = -1;
 }
 
 static void
@@ -45,6 +45,40 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to back the buffers with 2MB huge pages when the pool
+ * allocates system memory. Reserved huge pages are used if the system has
+ * some available, otherwise transparent huge pages are requested.
+ *
+ * Since: 1.20
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT:
+ *
+ * A bufferpool option to touch every page of the buffers when they are
+ * allocated, so that the first frames do not pay for the page faults. Used
+ * together with a minimum number of buffers, all frames are prefaulted when
+ * the pool is activated.
+ *
+ * Since: 1.20
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT "GstBufferPoolOptionVideoPrefault"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL:
+ *
+ * A bufferpool option to place the system memory of the buffers on the NUMA
+ * node of the thread that configures the pool, which is usually the
+ * streaming thread producing into the buffers.
+ *
+ * Since: 1.20
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL "GstBufferPoolOptionVideoNumaLocal"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
@@ -37,6 +37,97 @@ G_DEFINE_BOXED_TYPE (GstVideoCodecFrame, gst_video_codec_frame,
     (GBoxedCopyFunc) gst_video_codec_frame_ref,
     (GBoxedFreeFunc) gst_video_codec_frame_unref);
 
+/* Maximum number of unused frames kept around by a pool. This is enough for
+ * encoders with a long lookahead. */
+#define FRAME_POOL_MAX_FRAMES 64
+
+/* Frames keep a reference to the pool they come from so that they can be
+ * released after the element that owns the pool is gone. */
+struct _GstVideoCodecFramePool
+{
+  gint ref_count;
+  GMutex lock;
+  gboolean active;
+  guint n_frames;
+  GstVideoCodecFrame *frames[FRAME_POOL_MAX_FRAMES];
+};
+
+GstVideoCodecFramePool *
+__gst_video_codec_frame_pool_new (void)
+{
+  GstVideoCodecFramePool *pool = g_new0 (GstVideoCodecFramePool, 1);
+
+  pool->ref_count = 1;
+  g_mutex_init (&pool->lock);
+  pool->active = TRUE;
+
+  return pool;
+}
+
+static void
+gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool)
+{
+  if (g_atomic_int_dec_and_test (&pool->ref_count)) {
+    g_mutex_clear (&pool->lock);
+    g_free (pool);
+  }
+}
+
+void
+__gst_video_codec_frame_pool_free (GstVideoCodecFramePool * pool)
+{
+  guint i;
+
+  g_mutex_lock (&pool->lock);
+  pool->active = FALSE;
+  for (i = 0; i < pool->n_frames; i++)
+    g_slice_free (GstVideoCodecFrame, pool->frames[i]);
+  pool->n_frames = 0;
+  g_mutex_unlock (&pool->lock);
+
+  gst_video_codec_frame_pool_unref (pool);
+}
+
+GstVideoCodecFrame *
+__gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame = NULL;
+
+  g_mutex_lock (&pool->lock);
+  if (pool->n_frames > 0)
+    frame = pool->frames[--pool->n_frames];
+  g_mutex_unlock (&pool->lock);
+
+  /* pooled frames are cleared when released */
+  if (frame == NULL)
+    frame = g_slice_new0 (GstVideoCodecFrame);
+
+  frame->ref_count = 1;
+  frame->abidata.ABI.pool = pool;
+  g_atomic_int_inc (&pool->ref_count);
+
+  return frame;
+}
+
+static void
+gst_video_codec_frame_pool_release (GstVideoCodecFramePool * pool,
+    GstVideoCodecFrame * frame)
+{
+  memset (frame, 0, sizeof (GstVideoCodecFrame));
+
+  g_mutex_lock (&pool->lock);
+  if (pool->active && pool->n_frames < FRAME_POOL_MAX_FRAMES) {
+    pool->frames[pool->n_frames++] = frame;
+    frame = NULL;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    g_slice_free (GstVideoCodecFrame, frame);
+
+  gst_video_codec_frame_pool_unref (pool);
+}
+
 static void
 _gst_video_codec_frame_free (GstVideoCodecFrame * frame)
 {
@@ -58,7 +149,10 @@ _gst_video_codec_frame_free (GstVideoCodecFrame * frame)
   if (frame->user_data_destroy_notify)
     frame->user_data_destroy_notify (frame->user_data);
 
-  g_slice_free (GstVideoCodecFrame, frame);
+  if (frame->abidata.ABI.pool)
+    gst_video_codec_frame_pool_release (frame->abidata.ABI.pool, frame);
+  else
+    g_slice_free (GstVideoCodecFrame, frame);
 }
 
 /**
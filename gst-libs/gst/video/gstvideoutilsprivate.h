@@ -46,6 +46,18 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Per-element pool of GstVideoCodecFrame structures */
+typedef struct _GstVideoCodecFramePool GstVideoCodecFramePool;
+
+G_GNUC_INTERNAL
+GstVideoCodecFramePool *__gst_video_codec_frame_pool_new (void);
+
+G_GNUC_INTERNAL
+void __gst_video_codec_frame_pool_free (GstVideoCodecFramePool * pool);
+
+G_GNUC_INTERNAL
+GstVideoCodecFrame *__gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,43 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_BLEND_PRIVATE_H__
+#define __GST_VIDEO_BLEND_PRIVATE_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+gboolean    gst_video_blend_can_use_prepared (GstVideoFrame * dest);
+
+G_GNUC_INTERNAL
+GstBuffer * gst_video_blend_prepare_source   (GstVideoFrame * src,
+                                              gboolean dest_is_rgb,
+                                              gfloat global_alpha);
+
+G_GNUC_INTERNAL
+gboolean    gst_video_blend_prepared         (GstVideoFrame * dest,
+                                              GstBuffer * prepared,
+                                              gint width, gint height,
+                                              gint x, gint y);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_BLEND_PRIVATE_H__ */
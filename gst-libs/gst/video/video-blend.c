@@ -28,6 +28,7 @@
 #endif
 
 #include "video-blend.h"
+#include "video-blend-private.h"
 #include "video-orc.h"
 
 #include <string.h>
@@ -59,6 +60,8 @@ ensure_debug_category (void)
 
 #endif /* GST_DISABLE_GST_DEBUG */
 
+typedef void (*MatrixFunc) (guint8 * tmpline, guint width);
+
 static void
 matrix_identity (guint8 * tmpline, guint width)
 {
@@ -136,6 +139,27 @@ matrix_yuv_to_rgb (guint8 * tmpline, guint width)
   }
 }
 
+/* Returns the function converting unpacked lines of @src_info to the
+ * colour space of the destination. Resets @src_premultiplied_alpha if the
+ * conversion also unpremultiplies the source pixels. */
+static MatrixFunc
+get_matrix (const GstVideoInfo * src_info, gboolean dest_is_rgb,
+    gboolean * src_premultiplied_alpha)
+{
+  if (GST_VIDEO_INFO_IS_RGB (src_info) == dest_is_rgb)
+    return matrix_identity;
+
+  if (!GST_VIDEO_INFO_IS_RGB (src_info))
+    return matrix_yuv_to_rgb;
+
+  if (*src_premultiplied_alpha) {
+    *src_premultiplied_alpha = FALSE;
+    return matrix_prea_rgb_to_yuv;
+  }
+
+  return matrix_rgb_to_yuv;
+}
+
 /**
  * gst_video_blend_scale_linear_RGBA:
  * @src: the #GstVideoInfo describing the video data in @src_buffer
@@ -303,7 +327,7 @@ gst_video_blend (GstVideoFrame * dest,
   guint8 *tmpdestline = NULL, *tmpsrcline = NULL;
   gboolean src_premultiplied_alpha, dest_premultiplied_alpha;
   gint bpp;
-  void (*matrix) (guint8 * tmpline, guint width);
+  MatrixFunc matrix;
   const GstVideoFormatInfo *sinfo, *dinfo, *dunpackinfo, *sunpackinfo;
 
   g_assert (dest != NULL);
@@ -354,19 +378,8 @@ gst_video_blend (GstVideoFrame * dest,
 
   global_alpha_val = (bpp == 4) ? 255.0 * global_alpha : 65535.0 * global_alpha;
 
-  matrix = matrix_identity;
-  if (GST_VIDEO_INFO_IS_RGB (&src->info) != GST_VIDEO_INFO_IS_RGB (&dest->info)) {
-    if (GST_VIDEO_INFO_IS_RGB (&src->info)) {
-      if (src_premultiplied_alpha) {
-        matrix = matrix_prea_rgb_to_yuv;
-        src_premultiplied_alpha = FALSE;
-      } else {
-        matrix = matrix_rgb_to_yuv;
-      }
-    } else {
-      matrix = matrix_yuv_to_rgb;
-    }
-  }
+  matrix = get_matrix (&src->info, GST_VIDEO_INFO_IS_RGB (&dest->info),
+      &src_premultiplied_alpha);
 
   /* If we're here we know that the overlay image fully or
    * partially overlaps with the video frame */
@@ -520,3 +533,198 @@ nothing_to_do:
     return TRUE;
   }
 }
+
+/* Prepared source pixels are stored as four 16 bit values per pixel: the
+ * inverse of the source alpha, followed by the three colour components
+ * multiplied with the source alpha and scaled by 255. Blending them onto an
+ * opaque destination then is one multiply-add and a division per component,
+ * giving exactly the same results as gst_video_blend(). */
+#define PREPARED_PIXEL_SIZE (4 * sizeof (guint16))
+
+/* Whether gst_video_blend_prepared() can blend onto @dest. This is the case
+ * for all formats without alpha channel that are unpacked to 8 bits. */
+gboolean
+gst_video_blend_can_use_prepared (GstVideoFrame * dest)
+{
+  const GstVideoFormatInfo *dinfo, *dunpackinfo;
+
+  dinfo = dest->info.finfo;
+  if (dinfo == NULL || GST_VIDEO_FORMAT_INFO_HAS_ALPHA (dinfo))
+    return FALSE;
+
+  dunpackinfo = gst_video_format_get_info (dinfo->unpack_format);
+
+  return dunpackinfo != NULL && GST_VIDEO_FORMAT_INFO_BITS (dunpackinfo) == 8;
+}
+
+/* Converts @src to the colour space of the destination and applies the
+ * per-pixel and @global_alpha once, so that it can be blended any number of
+ * times with gst_video_blend_prepared(). Returns %NULL if the format of @src
+ * is not supported. */
+GstBuffer *
+gst_video_blend_prepare_source (GstVideoFrame * src, gboolean dest_is_rgb,
+    gfloat global_alpha)
+{
+  const GstVideoFormatInfo *sinfo, *sunpackinfo;
+  gboolean src_premultiplied_alpha;
+  gint i, j, width, height, global_alpha_val;
+  MatrixFunc matrix;
+  guint8 *tmpsrcline;
+  guint16 *prepared;
+  GstBuffer *buffer;
+  GstMapInfo map;
+
+  ensure_debug_category ();
+
+  sinfo = gst_video_format_get_info (GST_VIDEO_FRAME_FORMAT (src));
+  if (sinfo == NULL)
+    return NULL;
+
+  sunpackinfo = gst_video_format_get_info (sinfo->unpack_format);
+  if (sunpackinfo == NULL || GST_VIDEO_FORMAT_INFO_BITS (sunpackinfo) != 8)
+    return NULL;
+
+  src_premultiplied_alpha =
+      GST_VIDEO_INFO_FLAGS (&src->info) & GST_VIDEO_FLAG_PREMULTIPLIED_ALPHA;
+  matrix = get_matrix (&src->info, dest_is_rgb, &src_premultiplied_alpha);
+  global_alpha_val = 255.0 * global_alpha;
+
+  width = GST_VIDEO_FRAME_WIDTH (src);
+  height = GST_VIDEO_FRAME_HEIGHT (src);
+
+  GST_LOG ("preparing %dx%d source for blending onto %s", width, height,
+      dest_is_rgb ? "RGB" : "YUV");
+
+  buffer = gst_buffer_new_allocate (NULL, width * height * PREPARED_PIXEL_SIZE,
+      NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  prepared = (guint16 *) map.data;
+
+  tmpsrcline = g_malloc (sizeof (guint8) * (width + 8) * 4);
+
+  for (i = 0; i < height; i++) {
+    sinfo->unpack_func (sinfo, 0, tmpsrcline, src->data, src->info.stride,
+        0, i, width);
+    matrix (tmpsrcline, width);
+
+    for (j = 0; j < width * 4; j += 4, prepared += 4) {
+      guint asrc, factor;
+
+      asrc = ((guint) tmpsrcline[j]) * global_alpha_val / 255;
+      if (asrc == 0) {
+        prepared[0] = 255;
+        prepared[1] = prepared[2] = prepared[3] = 0;
+        continue;
+      }
+
+      factor = src_premultiplied_alpha ? global_alpha_val : asrc;
+      prepared[0] = 255 - asrc;
+      prepared[1] = tmpsrcline[j + 1] * factor;
+      prepared[2] = tmpsrcline[j + 2] * factor;
+      prepared[3] = tmpsrcline[j + 3] * factor;
+    }
+  }
+
+  g_free (tmpsrcline);
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+}
+
+/* Kept free of branches so that the compiler can vectorize it */
+static void
+blend_prepared_line (guint8 * dest, const guint16 * src, gint width)
+{
+  gint j;
+
+  for (j = 0; j < width * 4; j += 4) {
+    guint ia = src[j];
+    guint c1 = (src[j + 1] + dest[j + 1] * ia) / 255;
+    guint c2 = (src[j + 2] + dest[j + 2] * ia) / 255;
+    guint c3 = (src[j + 3] + dest[j + 3] * ia) / 255;
+
+    dest[j + 1] = MIN (c1, 255);
+    dest[j + 2] = MIN (c2, 255);
+    dest[j + 3] = MIN (c3, 255);
+  }
+}
+
+/* Blends @prepared, as returned by gst_video_blend_prepare_source() for a
+ * @width x @height source, onto @dest at @x, @y. @dest must be supported by
+ * gst_video_blend_can_use_prepared(). */
+gboolean
+gst_video_blend_prepared (GstVideoFrame * dest, GstBuffer * prepared,
+    gint width, gint height, gint x, gint y)
+{
+  const GstVideoFormatInfo *dinfo;
+  gint i, dest_width, dest_height, src_width, src_height;
+  gint src_xoff = 0, src_yoff = 0;
+  const guint16 *src;
+  guint8 *tmpdestline;
+  GstMapInfo map;
+
+  g_return_val_if_fail (gst_video_blend_can_use_prepared (dest), FALSE);
+
+  ensure_debug_category ();
+
+  dinfo = dest->info.finfo;
+  dest_width = GST_VIDEO_FRAME_WIDTH (dest);
+  dest_height = GST_VIDEO_FRAME_HEIGHT (dest);
+
+  GST_LOG ("blend prepared %dx%d onto dest %dx%d @ %d,%d", width, height,
+      dest_width, dest_height, x, y);
+
+  /* In case overlay is completely outside the video, don't render */
+  if (x + width <= 0 || y + height <= 0 || x >= dest_width
+      || y >= dest_height)
+    return TRUE;
+
+  if (!gst_buffer_map (prepared, &map, GST_MAP_READ))
+    return FALSE;
+
+  if (map.size < width * height * PREPARED_PIXEL_SIZE) {
+    gst_buffer_unmap (prepared, &map);
+    return FALSE;
+  }
+
+  src_width = width;
+  src_height = height;
+
+  /* clip the source image to the video surface */
+  if (x < 0) {
+    src_xoff = -x;
+    src_width -= src_xoff;
+    x = 0;
+  }
+
+  if (y < 0) {
+    src_yoff = -y;
+    src_height -= src_yoff;
+    y = 0;
+  }
+
+  if (x + src_width > dest_width)
+    src_width = dest_width - x;
+
+  if (y + src_height > dest_height)
+    src_height = dest_height - y;
+
+  tmpdestline = g_malloc (sizeof (guint8) * (dest_width + 8) * 4);
+  src = (const guint16 *) map.data;
+
+  for (i = y; i < y + src_height; i++, src_yoff++) {
+    dinfo->unpack_func (dinfo, 0, tmpdestline, dest->data, dest->info.stride,
+        0, i, dest_width);
+
+    blend_prepared_line (tmpdestline + 4 * x,
+        src + (src_yoff * width + src_xoff) * 4, src_width);
+
+    dinfo->pack_func (dinfo, 0, tmpdestline, dest_width,
+        dest->data, dest->info.stride, dest->info.chroma_site, i, dest_width);
+  }
+
+  g_free (tmpdestline);
+  gst_buffer_unmap (prepared, &map);
+
+  return TRUE;
+}
@@ -37,6 +37,7 @@
 #include <gst/base/base.h>
 
 #include "video-orc.h"
+#include "video-format-x86-sse2.h"
 
 /**
  * SECTION:videoconverter
@@ -6087,6 +6088,142 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   convert_fill_border (convert, dest);
 }
 
+typedef struct
+{
+  const GstVideoFormatInfo *finfo;
+  const guint8 *s[2];
+  guint8 *d[2];
+  gint sstride[2];
+  gint dstride[2];
+  gint width, height;
+  gint ty_start, ty_end;
+} FDetileTask;
+
+#define DETILE_LINES(tw)                                        \
+  G_STMT_START {                                                \
+    for (i = 0; i < n_rows; i++)                                \
+      memcpy (dl + (gsize) i * dstride, tile + i * (tw), (tw)); \
+  } G_STMT_END
+
+/* Copy @n_rows lines, starting at line @row in the tiles, of the tile row @ty
+ * of a tiled plane to @d. Tiles are copied one after the other so that the
+ * source is read sequentially, the copies of whole tile lines have a
+ * constant size so that they are inlined. */
+static void
+detile_tile_row (GstVideoTileMode mode, gint ws, gint hs, const guint8 * s,
+    gint sstride, gint ty, gint row, gint n_rows, guint8 * d, gint dstride,
+    gint width)
+{
+  gint tile_width = 1 << ws;
+  gint ts = ws + hs;
+  gint x_tiles = GST_VIDEO_TILE_X_TILES (sstride);
+  gint y_tiles = GST_VIDEO_TILE_Y_TILES (sstride);
+  gint tx, ntx, i;
+
+  ntx = (width + tile_width - 1) >> ws;
+  tx = 0;
+
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+  /* the 4 bytes lines of 4x4 tiles are too small to be copied one by one,
+   * transpose groups of 4 tiles instead */
+  if (mode == GST_VIDEO_TILE_MODE_LINEAR && tile_width == 4)
+    tx = video_format_detile_4x4_sse2 (d, dstride,
+        s + (((gsize) ty * x_tiles) << ts), row, n_rows, width >> ws);
+#endif
+
+  for (; tx < ntx; tx++) {
+    const guint8 *tile;
+    guint8 *dl = d + (tx << ws);
+    gint w = MIN (tile_width, width - (tx << ws));
+
+    tile = s + ((gsize) gst_video_tile_get_index (mode, tx, ty, x_tiles,
+            y_tiles) << ts);
+    tile += row << ws;
+
+    if (w == 64)
+      DETILE_LINES (64);
+    else if (w == 32)
+      DETILE_LINES (32);
+    else
+      for (i = 0; i < n_rows; i++)
+        memcpy (dl + (gsize) i * dstride, tile + (i << ws), w);
+  }
+}
+
+#undef DETILE_LINES
+
+static void
+convert_NV12_TILED_NV12_task (FDetileTask * task)
+{
+  GstVideoTileMode mode = GST_VIDEO_FORMAT_INFO_TILE_MODE (task->finfo);
+  gint ws = GST_VIDEO_FORMAT_INFO_TILE_WS (task->finfo);
+  gint hs = GST_VIDEO_FORMAT_INFO_TILE_HS (task->finfo);
+  gint uv_width = GST_ROUND_UP_2 (task->width);
+  gint uv_height = (task->height + 1) >> 1;
+  gint ty, y, n_rows;
+
+  for (ty = task->ty_start; ty < task->ty_end; ty++) {
+    y = ty << hs;
+    n_rows = MIN (1 << hs, task->height - y);
+    detile_tile_row (mode, ws, hs, task->s[0], task->sstride[0], ty, 0,
+        n_rows, task->d[0] + (gsize) y * task->dstride[0], task->dstride[0],
+        task->width);
+
+    /* a UV tile holds the chroma of two Y tile rows, one in each half */
+    y >>= 1;
+    n_rows = MIN (1 << (hs - 1), uv_height - y);
+    detile_tile_row (mode, ws, hs, task->s[1], task->sstride[1], ty >> 1,
+        (ty & 1) << (hs - 1), n_rows,
+        task->d[1] + (gsize) y * task->dstride[1], task->dstride[1],
+        uv_width);
+  }
+}
+
+static void
+convert_NV12_TILED_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  gint hs = GST_VIDEO_FORMAT_INFO_TILE_HS (src->info.finfo);
+  FDetileTask *tasks;
+  FDetileTask **tasks_p;
+  gint n_threads;
+  gint n_tile_rows, tile_rows_per_thread;
+  gint i, j;
+
+  /* split on whole tile rows so that every tile is read by one thread */
+  n_tile_rows = (height + (1 << hs) - 1) >> hs;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FDetileTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FDetileTask *, convert->tasks_p[0], n_threads);
+
+  tile_rows_per_thread = (n_tile_rows + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].finfo = src->info.finfo;
+    for (j = 0; j < 2; j++) {
+      tasks[i].s[j] = GST_VIDEO_FRAME_PLANE_DATA (src, j);
+      tasks[i].sstride[j] = GST_VIDEO_FRAME_PLANE_STRIDE (src, j);
+      tasks[i].d[j] = GST_VIDEO_FRAME_PLANE_DATA (dest, j);
+      tasks[i].dstride[j] = GST_VIDEO_FRAME_PLANE_STRIDE (dest, j);
+    }
+    tasks[i].width = width;
+    tasks[i].height = height;
+    tasks[i].ty_start = MIN (i * tile_rows_per_thread, n_tile_rows);
+    tasks[i].ty_end = MIN ((i + 1) * tile_rows_per_thread, n_tile_rows);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_TILED_NV12_task,
+      (gpointer) tasks_p);
+}
+
 static void
 memset_u24 (guint8 * data, guint8 col[3], unsigned int n)
 {
@@ -7462,6 +7599,14 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_NV24, GST_VIDEO_FORMAT_NV24, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* tiled -> semiplanar */
+  {GST_VIDEO_FORMAT_NV12_64Z32, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_TILED_NV12},
+  {GST_VIDEO_FORMAT_NV12_4L4, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_TILED_NV12},
+  {GST_VIDEO_FORMAT_NV12_32L32, GST_VIDEO_FORMAT_NV12, FALSE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_TILED_NV12},
+
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
   {GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_ARGB, TRUE, TRUE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, 0, 0, convert_AYUV_ARGB},
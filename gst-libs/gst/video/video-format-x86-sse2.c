@@ -0,0 +1,266 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "video-format-x86-sse2.h"
+
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+#include <emmintrin.h>
+
+/* x86 is little endian, swap the bytes of big endian values */
+static inline __m128i
+swap_16 (__m128i v, gboolean be)
+{
+  if (!be)
+    return v;
+
+  return _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+}
+
+/* scale to 16 bits and replicate the most significant bits in the lower bits
+ * when @fill is all ones */
+static inline __m128i
+scale_up_16 (__m128i v, __m128i shift, __m128i depth, __m128i fill)
+{
+  v = _mm_sll_epi16 (v, shift);
+  return _mm_or_si128 (v, _mm_and_si128 (_mm_srl_epi16 (v, depth), fill));
+}
+
+/* interleave 8 pixels of Y with the UV pairs in @uv_lo and @uv_hi into
+ * AYUV64 */
+static inline void
+store_ayuv64 (guint16 * d, __m128i y, __m128i uv_lo, __m128i uv_hi)
+{
+  const __m128i alpha = _mm_set1_epi16 (-1);
+  __m128i ay_lo, ay_hi;
+
+  ay_lo = _mm_unpacklo_epi16 (alpha, y);
+  ay_hi = _mm_unpackhi_epi16 (alpha, y);
+
+  _mm_storeu_si128 ((__m128i *) (d + 0), _mm_unpacklo_epi32 (ay_lo, uv_lo));
+  _mm_storeu_si128 ((__m128i *) (d + 8), _mm_unpackhi_epi32 (ay_lo, uv_lo));
+  _mm_storeu_si128 ((__m128i *) (d + 16), _mm_unpacklo_epi32 (ay_hi, uv_hi));
+  _mm_storeu_si128 ((__m128i *) (d + 24), _mm_unpackhi_epi32 (ay_hi, uv_hi));
+}
+
+/* split 8 pixels of AYUV64 into the Y values and the UV pairs of the
+ * pixels */
+static inline void
+load_ayuv64 (const guint16 * s, __m128i * y, __m128i * uv_lo,
+    __m128i * uv_hi)
+{
+  __m128i p0, p1, p2, p3, t0, t1, t2, t3;
+
+  p0 = _mm_loadu_si128 ((const __m128i *) (s + 0));
+  p1 = _mm_loadu_si128 ((const __m128i *) (s + 8));
+  p2 = _mm_loadu_si128 ((const __m128i *) (s + 16));
+  p3 = _mm_loadu_si128 ((const __m128i *) (s + 24));
+
+  /* AY0 AY2 UV0 UV2, AY1 AY3 UV1 UV3, ... */
+  t0 = _mm_unpacklo_epi32 (p0, p1);
+  t1 = _mm_unpackhi_epi32 (p0, p1);
+  t2 = _mm_unpacklo_epi32 (p2, p3);
+  t3 = _mm_unpackhi_epi32 (p2, p3);
+
+  /* AY0 AY1 AY2 AY3 and UV0 UV1 UV2 UV3 */
+  p0 = _mm_unpacklo_epi32 (t0, t1);
+  p1 = _mm_unpackhi_epi32 (t0, t1);
+  p2 = _mm_unpacklo_epi32 (t2, t3);
+  p3 = _mm_unpackhi_epi32 (t2, t3);
+
+  /* keep the Y of each AY pair */
+  p0 = _mm_srai_epi32 (p0, 16);
+  p2 = _mm_srai_epi32 (p2, 16);
+  *y = _mm_packs_epi32 (p0, p2);
+  *uv_lo = p1;
+  *uv_hi = p3;
+}
+
+/* keep the even 16 bits values of @a and @b */
+static inline __m128i
+pack_even_16 (__m128i a, __m128i b)
+{
+  a = _mm_srai_epi32 (_mm_slli_epi32 (a, 16), 16);
+  b = _mm_srai_epi32 (_mm_slli_epi32 (b, 16), 16);
+
+  return _mm_packs_epi32 (a, b);
+}
+
+gint
+video_format_unpack_yuv_planar_16_sse2 (guint16 * d, const guint16 * sy,
+    const guint16 * su, const guint16 * sv, gint width, gint w_sub,
+    gint depth, gboolean be, gboolean truncate_range)
+{
+  __m128i shift = _mm_cvtsi32_si128 (16 - depth);
+  __m128i vdepth = _mm_cvtsi32_si128 (depth);
+  __m128i fill = truncate_range ? _mm_setzero_si128 () : _mm_set1_epi16 (-1);
+  __m128i y, u, v, uv_lo, uv_hi;
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    y = _mm_loadu_si128 ((const __m128i *) (sy + i));
+    if (w_sub) {
+      u = _mm_loadl_epi64 ((const __m128i *) (su + i / 2));
+      v = _mm_loadl_epi64 ((const __m128i *) (sv + i / 2));
+      u = _mm_unpacklo_epi16 (u, u);
+      v = _mm_unpacklo_epi16 (v, v);
+    } else {
+      u = _mm_loadu_si128 ((const __m128i *) (su + i));
+      v = _mm_loadu_si128 ((const __m128i *) (sv + i));
+    }
+
+    y = scale_up_16 (swap_16 (y, be), shift, vdepth, fill);
+    u = scale_up_16 (swap_16 (u, be), shift, vdepth, fill);
+    v = scale_up_16 (swap_16 (v, be), shift, vdepth, fill);
+
+    uv_lo = _mm_unpacklo_epi16 (u, v);
+    uv_hi = _mm_unpackhi_epi16 (u, v);
+
+    store_ayuv64 (d + i * 4, y, uv_lo, uv_hi);
+  }
+  return i;
+}
+
+gint
+video_format_pack_yuv_planar_16_sse2 (guint16 * dy, guint16 * du,
+    guint16 * dv, const guint16 * s, gint width, gint w_sub, gboolean chroma,
+    gint depth, gboolean be)
+{
+  __m128i shift = _mm_cvtsi32_si128 (16 - depth);
+  __m128i y, u, v, uv_lo, uv_hi;
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    load_ayuv64 (s + i * 4, &y, &uv_lo, &uv_hi);
+
+    y = _mm_srl_epi16 (y, shift);
+    _mm_storeu_si128 ((__m128i *) (dy + i), swap_16 (y, be));
+
+    if (!chroma)
+      continue;
+
+    /* U0 V0 U1 V1 ... into U0 U1 ... and V0 V1 ... */
+    u = pack_even_16 (uv_lo, uv_hi);
+    v = pack_even_16 (_mm_srli_epi32 (uv_lo, 16), _mm_srli_epi32 (uv_hi, 16));
+    u = swap_16 (_mm_srl_epi16 (u, shift), be);
+    v = swap_16 (_mm_srl_epi16 (v, shift), be);
+
+    if (w_sub) {
+      /* take the chroma of the even pixels */
+      u = pack_even_16 (u, u);
+      v = pack_even_16 (v, v);
+      _mm_storel_epi64 ((__m128i *) (du + i / 2), u);
+      _mm_storel_epi64 ((__m128i *) (dv + i / 2), v);
+    } else {
+      _mm_storeu_si128 ((__m128i *) (du + i), u);
+      _mm_storeu_si128 ((__m128i *) (dv + i), v);
+    }
+  }
+  return i;
+}
+
+gint
+video_format_unpack_yuv_semi_planar_16_sse2 (guint16 * d,
+    const guint16 * sy, const guint16 * suv, gint width, gint depth,
+    gboolean be, gboolean truncate_range)
+{
+  __m128i shift = _mm_cvtsi32_si128 (0);
+  __m128i vdepth = _mm_cvtsi32_si128 (depth);
+  __m128i fill = truncate_range ? _mm_setzero_si128 () : _mm_set1_epi16 (-1);
+  __m128i y, uv;
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    y = _mm_loadu_si128 ((const __m128i *) (sy + i));
+    uv = _mm_loadu_si128 ((const __m128i *) (suv + i));
+
+    y = scale_up_16 (swap_16 (y, be), shift, vdepth, fill);
+    uv = scale_up_16 (swap_16 (uv, be), shift, vdepth, fill);
+
+    store_ayuv64 (d + i * 4, y, _mm_unpacklo_epi32 (uv, uv),
+        _mm_unpackhi_epi32 (uv, uv));
+  }
+  return i;
+}
+
+gint
+video_format_pack_yuv_semi_planar_16_sse2 (guint16 * dy, guint16 * duv,
+    const guint16 * s, gint width, gboolean chroma, gint depth, gboolean be)
+{
+  __m128i mask = _mm_set1_epi16 ((gint16) (0xffff << (16 - depth)));
+  __m128i y, uv, uv_lo, uv_hi;
+  gint i;
+
+  for (i = 0; i + 8 <= width; i += 8) {
+    load_ayuv64 (s + i * 4, &y, &uv_lo, &uv_hi);
+
+    y = _mm_and_si128 (y, mask);
+    _mm_storeu_si128 ((__m128i *) (dy + i), swap_16 (y, be));
+
+    if (!chroma)
+      continue;
+
+    /* take the UV pairs of the even pixels */
+    uv = _mm_unpacklo_epi64 (_mm_shuffle_epi32 (uv_lo, _MM_SHUFFLE (3, 1,
+                2, 0)), _mm_shuffle_epi32 (uv_hi, _MM_SHUFFLE (3, 1, 2, 0)));
+    uv = _mm_and_si128 (uv, mask);
+    _mm_storeu_si128 ((__m128i *) (duv + i), swap_16 (uv, be));
+  }
+  return i;
+}
+
+
+gint
+video_format_detile_4x4_sse2 (guint8 * d, gint dstride, const guint8 * s,
+    gint row, gint n_rows, gint n_tiles)
+{
+  __m128i t0, t1, t2, t3, r01_lo, r23_lo, r01_hi, r23_hi;
+  __m128i rows[4];
+  gint i, j;
+
+  /* the 4 tiles are consecutive, each holds 4 lines of 4 bytes. A transpose
+   * of the 32 bits lanes gives 4 lines of 16 bytes */
+  for (i = 0; i + 4 <= n_tiles; i += 4) {
+    t0 = _mm_loadu_si128 ((const __m128i *) (s + 0));
+    t1 = _mm_loadu_si128 ((const __m128i *) (s + 16));
+    t2 = _mm_loadu_si128 ((const __m128i *) (s + 32));
+    t3 = _mm_loadu_si128 ((const __m128i *) (s + 48));
+
+    r01_lo = _mm_unpacklo_epi32 (t0, t1);
+    r23_lo = _mm_unpackhi_epi32 (t0, t1);
+    r01_hi = _mm_unpacklo_epi32 (t2, t3);
+    r23_hi = _mm_unpackhi_epi32 (t2, t3);
+
+    rows[0] = _mm_unpacklo_epi64 (r01_lo, r01_hi);
+    rows[1] = _mm_unpackhi_epi64 (r01_lo, r01_hi);
+    rows[2] = _mm_unpacklo_epi64 (r23_lo, r23_hi);
+    rows[3] = _mm_unpackhi_epi64 (r23_lo, r23_hi);
+
+    for (j = 0; j < n_rows; j++)
+      _mm_storeu_si128 ((__m128i *) (d + (gsize) j * dstride), rows[row + j]);
+
+    s += 64;
+    d += 16;
+  }
+  return i;
+}
+
+#endif
@@ -0,0 +1,63 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef VIDEO_FORMAT_X86_SSE2_H
+#define VIDEO_FORMAT_X86_SSE2_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#if defined (HAVE_EMMINTRIN_H) && defined (__SSE2__)
+#define HAVE_VIDEO_FORMAT_SSE2 1
+
+/* These convert lines between the 10, 12 and 16 bits YUV formats and
+ * AYUV64. They handle the first pixels of the line in blocks of 8 and return
+ * the number of pixels they handled, the caller converts the remaining
+ * ones. Lines start at an even pixel. */
+
+G_GNUC_INTERNAL
+gint video_format_unpack_yuv_planar_16_sse2 (guint16 * d,
+    const guint16 * sy, const guint16 * su, const guint16 * sv, gint width,
+    gint w_sub, gint depth, gboolean be, gboolean truncate_range);
+
+G_GNUC_INTERNAL
+gint video_format_pack_yuv_planar_16_sse2 (guint16 * dy, guint16 * du,
+    guint16 * dv, const guint16 * s, gint width, gint w_sub,
+    gboolean chroma, gint depth, gboolean be);
+
+G_GNUC_INTERNAL
+gint video_format_unpack_yuv_semi_planar_16_sse2 (guint16 * d,
+    const guint16 * sy, const guint16 * suv, gint width, gint depth,
+    gboolean be, gboolean truncate_range);
+
+G_GNUC_INTERNAL
+gint video_format_pack_yuv_semi_planar_16_sse2 (guint16 * dy,
+    guint16 * duv, const guint16 * s, gint width, gboolean chroma,
+    gint depth, gboolean be);
+
+/* Copies lines @row to @row + @n_rows - 1 of the 4x4 tiles of a linear tile
+ * row to @d, in groups of 4 tiles, and returns the number of tiles copied. */
+G_GNUC_INTERNAL
+gint video_format_detile_4x4_sse2 (guint8 * d, gint dstride,
+    const guint8 * s, gint row, gint n_rows, gint n_tiles);
+#endif
+
+G_END_DECLS
+
+#endif /* VIDEO_FORMAT_X86_SSE2_H */
@@ -28,6 +28,7 @@
 
 #include "video-format.h"
 #include "video-orc.h"
+#include "video-format-x86-sse2.h"
 
 #ifndef restrict
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
@@ -554,7 +555,205 @@ pack_copy4 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   memcpy (d, src, width * 4);
 }
 
+/* Line conversion of the planar and semi-planar YUV formats with 10, 12 or
+ * 16 bits per component. @w_sub, @depth and @be are constant at every call
+ * site so that they are folded when inlined, the SSE2 functions convert
+ * blocks of 8 pixels and the loops here handle what is left. */
+#define READ_UINT16(p,be) \
+    ((be) ? GUINT16_FROM_BE (*(p)) : GUINT16_FROM_LE (*(p)))
+#define WRITE_UINT16(p,v,be) \
+    (*(p) = (be) ? GUINT16_TO_BE (v) : GUINT16_TO_LE (v))
+
+/* scale a value with @depth significant bits starting at bit @shift to 16
+ * bits and replicate the most significant bits in the lower bits when @fill
+ * is 0xffff */
+static inline guint16
+scale_up_16 (guint16 v, gint shift, gint depth, guint16 fill)
+{
+  v <<= shift;
+  return v | ((v >> depth) & fill);
+}
+
+static inline void
+unpack_yuv_planar_16 (GstVideoPackFlags flags, guint16 * restrict d,
+    const guint16 * restrict sy, const guint16 * restrict su,
+    const guint16 * restrict sv, gint x, gint width, gint w_sub, gint depth,
+    gboolean be)
+{
+  gboolean truncate_range = (flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) != 0;
+  guint16 fill = truncate_range ? 0 : 0xffff;
+  gint i = 0, shift = 16 - depth;
+
+  sy += x;
+  su += x >> w_sub;
+  sv += x >> w_sub;
+
+  if (w_sub && (x & 1)) {
+    d[0] = 0xffff;
+    d[1] = scale_up_16 (READ_UINT16 (sy, be), shift, depth, fill);
+    d[2] = scale_up_16 (READ_UINT16 (su, be), shift, depth, fill);
+    d[3] = scale_up_16 (READ_UINT16 (sv, be), shift, depth, fill);
+    d += 4;
+    sy++;
+    su++;
+    sv++;
+    width--;
+  }
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+  i = video_format_unpack_yuv_planar_16_sse2 (d, sy, su, sv, width, w_sub,
+      depth, be, truncate_range);
+#endif
+
+  for (; i < width; i++) {
+    d[i * 4 + 0] = 0xffff;
+    d[i * 4 + 1] = scale_up_16 (READ_UINT16 (sy + i, be), shift, depth, fill);
+    d[i * 4 + 2] =
+        scale_up_16 (READ_UINT16 (su + (i >> w_sub), be), shift, depth, fill);
+    d[i * 4 + 3] =
+        scale_up_16 (READ_UINT16 (sv + (i >> w_sub), be), shift, depth, fill);
+  }
+}
+
+static inline void
+pack_yuv_planar_16 (guint16 * restrict dy, guint16 * restrict du,
+    guint16 * restrict dv, const guint16 * restrict s, gint width,
+    gint w_sub, gboolean chroma, gint depth, gboolean be)
+{
+  gint i = 0, shift = 16 - depth;
+
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+  i = video_format_pack_yuv_planar_16_sse2 (dy, du, dv, s, width, w_sub,
+      chroma, depth, be);
+#endif
+
+  for (; i < width; i++) {
+    WRITE_UINT16 (dy + i, s[i * 4 + 1] >> shift, be);
+
+    /* subsampled chroma is taken from the even pixels */
+    if (chroma && (i & w_sub) == 0) {
+      WRITE_UINT16 (du + (i >> w_sub), s[i * 4 + 2] >> shift, be);
+      WRITE_UINT16 (dv + (i >> w_sub), s[i * 4 + 3] >> shift, be);
+    }
+  }
+}
+
+static inline void
+unpack_yuv_semi_planar_16 (GstVideoPackFlags flags, guint16 * restrict d,
+    const guint16 * restrict sy, const guint16 * restrict suv, gint x,
+    gint width, gint depth, gboolean be)
+{
+  gboolean truncate_range = (flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) != 0;
+  guint16 fill = truncate_range ? 0 : 0xffff;
+  gint i = 0;
+
+  sy += x;
+  suv += x & ~1;
+
+  if (x & 1) {
+    d[0] = 0xffff;
+    d[1] = scale_up_16 (READ_UINT16 (sy, be), 0, depth, fill);
+    d[2] = scale_up_16 (READ_UINT16 (suv, be), 0, depth, fill);
+    d[3] = scale_up_16 (READ_UINT16 (suv + 1, be), 0, depth, fill);
+    d += 4;
+    sy++;
+    suv += 2;
+    width--;
+  }
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+  i = video_format_unpack_yuv_semi_planar_16_sse2 (d, sy, suv, width, depth,
+      be, truncate_range);
+#endif
+
+  for (; i < width; i++) {
+    d[i * 4 + 0] = 0xffff;
+    d[i * 4 + 1] = scale_up_16 (READ_UINT16 (sy + i, be), 0, depth, fill);
+    d[i * 4 + 2] =
+        scale_up_16 (READ_UINT16 (suv + (i & ~1), be), 0, depth, fill);
+    d[i * 4 + 3] =
+        scale_up_16 (READ_UINT16 (suv + (i & ~1) + 1, be), 0, depth, fill);
+  }
+}
+
+static inline void
+pack_yuv_semi_planar_16 (guint16 * restrict dy, guint16 * restrict duv,
+    const guint16 * restrict s, gint width, gboolean chroma, gint depth,
+    gboolean be)
+{
+  guint16 mask = 0xffff << (16 - depth);
+  gint i = 0;
+
+#ifdef HAVE_VIDEO_FORMAT_SSE2
+  i = video_format_pack_yuv_semi_planar_16_sse2 (dy, duv, s, width, chroma,
+      depth, be);
+#endif
+
+  for (; i < width; i++) {
+    WRITE_UINT16 (dy + i, s[i * 4 + 1] & mask, be);
+
+    if (chroma && (i & 1) == 0) {
+      WRITE_UINT16 (duv + i + 0, s[i * 4 + 2] & mask, be);
+      WRITE_UINT16 (duv + i + 1, s[i * 4 + 3] & mask, be);
+    }
+  }
+}
+
 #define PACK_v210 GST_VIDEO_FORMAT_AYUV64, unpack_v210, 1, pack_v210
+/* unpack one group of 6 pixels */
+static inline void
+unpack_v210_group (guint16 * restrict d, const guint8 * restrict s,
+    guint16 fill)
+{
+  guint32 a0, a1, a2, a3;
+  guint16 y0, y1, y2, y3, y4, y5;
+  guint16 u0, u2, u4;
+  guint16 v0, v2, v4;
+
+  a0 = GST_READ_UINT32_LE (s + 0);
+  a1 = GST_READ_UINT32_LE (s + 4);
+  a2 = GST_READ_UINT32_LE (s + 8);
+  a3 = GST_READ_UINT32_LE (s + 12);
+
+  u0 = scale_up_16 ((a0 >> 0) & 0x3ff, 6, 10, fill);
+  y0 = scale_up_16 ((a0 >> 10) & 0x3ff, 6, 10, fill);
+  v0 = scale_up_16 ((a0 >> 20) & 0x3ff, 6, 10, fill);
+  y1 = scale_up_16 ((a1 >> 0) & 0x3ff, 6, 10, fill);
+
+  u2 = scale_up_16 ((a1 >> 10) & 0x3ff, 6, 10, fill);
+  y2 = scale_up_16 ((a1 >> 20) & 0x3ff, 6, 10, fill);
+  v2 = scale_up_16 ((a2 >> 0) & 0x3ff, 6, 10, fill);
+  y3 = scale_up_16 ((a2 >> 10) & 0x3ff, 6, 10, fill);
+
+  u4 = scale_up_16 ((a2 >> 20) & 0x3ff, 6, 10, fill);
+  y4 = scale_up_16 ((a3 >> 0) & 0x3ff, 6, 10, fill);
+  v4 = scale_up_16 ((a3 >> 10) & 0x3ff, 6, 10, fill);
+  y5 = scale_up_16 ((a3 >> 20) & 0x3ff, 6, 10, fill);
+
+  d[0] = 0xffff;
+  d[1] = y0;
+  d[2] = u0;
+  d[3] = v0;
+  d[4] = 0xffff;
+  d[5] = y1;
+  d[6] = u0;
+  d[7] = v0;
+  d[8] = 0xffff;
+  d[9] = y2;
+  d[10] = u2;
+  d[11] = v2;
+  d[12] = 0xffff;
+  d[13] = y3;
+  d[14] = u2;
+  d[15] = v2;
+  d[16] = 0xffff;
+  d[17] = y4;
+  d[18] = u4;
+  d[19] = v4;
+  d[20] = 0xffff;
+  d[21] = y5;
+  d[22] = u4;
+  d[23] = v4;
+}
+
 static void
 unpack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
@@ -563,87 +762,22 @@ unpack_v210 (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   int i;
   const guint8 *restrict s = GET_LINE (y);
   guint16 *restrict d = dest;
-  guint32 a0, a1, a2, a3;
-  guint16 y0, y1, y2, y3, y4, y5;
-  guint16 u0, u2, u4;
-  guint16 v0, v2, v4;
+  guint16 fill;
+
+  fill = (flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) ? 0 : 0xffff;
 
   /* FIXME */
   s += x * 2;
 
-  for (i = 0; i < width; i += 6) {
-    a0 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 0);
-    a1 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 4);
-    a2 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 8);
-    a3 = GST_READ_UINT32_LE (s + (i / 6) * 16 + 12);
-
-    u0 = ((a0 >> 0) & 0x3ff) << 6;
-    y0 = ((a0 >> 10) & 0x3ff) << 6;
-    v0 = ((a0 >> 20) & 0x3ff) << 6;
-    y1 = ((a1 >> 0) & 0x3ff) << 6;
-
-    u2 = ((a1 >> 10) & 0x3ff) << 6;
-    y2 = ((a1 >> 20) & 0x3ff) << 6;
-    v2 = ((a2 >> 0) & 0x3ff) << 6;
-    y3 = ((a2 >> 10) & 0x3ff) << 6;
-
-    u4 = ((a2 >> 20) & 0x3ff) << 6;
-    y4 = ((a3 >> 0) & 0x3ff) << 6;
-    v4 = ((a3 >> 10) & 0x3ff) << 6;
-    y5 = ((a3 >> 20) & 0x3ff) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      y0 |= (y0 >> 10);
-      y1 |= (y1 >> 10);
-      u0 |= (u0 >> 10);
-      v0 |= (v0 >> 10);
-
-      y2 |= (y2 >> 10);
-      y3 |= (y3 >> 10);
-      u2 |= (u2 >> 10);
-      v2 |= (v2 >> 10);
-
-      y4 |= (y4 >> 10);
-      y5 |= (y5 >> 10);
-      u4 |= (u4 >> 10);
-      v4 |= (v4 >> 10);
-    }
+  for (i = 0; i + 6 <= width; i += 6)
+    unpack_v210_group (d + i * 4, s + (i / 6) * 16, fill);
 
-    d[4 * (i + 0) + 0] = 0xffff;
-    d[4 * (i + 0) + 1] = y0;
-    d[4 * (i + 0) + 2] = u0;
-    d[4 * (i + 0) + 3] = v0;
+  /* lines are padded to complete groups */
+  if (i < width) {
+    guint16 last[6 * 4];
 
-    if (i < width - 1) {
-      d[4 * (i + 1) + 0] = 0xffff;
-      d[4 * (i + 1) + 1] = y1;
-      d[4 * (i + 1) + 2] = u0;
-      d[4 * (i + 1) + 3] = v0;
-    }
-    if (i < width - 2) {
-      d[4 * (i + 2) + 0] = 0xffff;
-      d[4 * (i + 2) + 1] = y2;
-      d[4 * (i + 2) + 2] = u2;
-      d[4 * (i + 2) + 3] = v2;
-    }
-    if (i < width - 3) {
-      d[4 * (i + 3) + 0] = 0xffff;
-      d[4 * (i + 3) + 1] = y3;
-      d[4 * (i + 3) + 2] = u2;
-      d[4 * (i + 3) + 3] = v2;
-    }
-    if (i < width - 4) {
-      d[4 * (i + 4) + 0] = 0xffff;
-      d[4 * (i + 4) + 1] = y4;
-      d[4 * (i + 4) + 2] = u4;
-      d[4 * (i + 4) + 3] = v4;
-    }
-    if (i < width - 5) {
-      d[4 * (i + 5) + 0] = 0xffff;
-      d[4 * (i + 5) + 1] = y5;
-      d[4 * (i + 5) + 2] = u4;
-      d[4 * (i + 5) + 3] = v4;
-    }
+    unpack_v210_group (last, s + (i / 6) * 16, fill);
+    memcpy (d + i * 4, last, (width - i) * 4 * sizeof (guint16));
   }
 }
 
@@ -3066,32 +3200,8 @@ unpack_Y444_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  guint16 *restrict sy = GET_Y_LINE (y);
-  guint16 *restrict su = GET_U_LINE (y);
-  guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x;
-  sv += x;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 6;
-    U = GST_READ_UINT16_LE (su + i) << 6;
-    V = GST_READ_UINT16_LE (sv + i) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 0, 10, FALSE);
 }
 
 static void
@@ -3100,22 +3210,8 @@ pack_Y444_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width; i++) {
-    Y = (s[i * 4 + 1]) >> 6;
-    U = (s[i * 4 + 2]) >> 6;
-    V = (s[i * 4 + 3]) >> 6;
-
-    GST_WRITE_UINT16_LE (dy + i, Y);
-    GST_WRITE_UINT16_LE (du + i, U);
-    GST_WRITE_UINT16_LE (dv + i, V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 0, TRUE, 10, FALSE);
 }
 
 #define PACK_Y444_10BE GST_VIDEO_FORMAT_AYUV64, unpack_Y444_10BE, 1, pack_Y444_10BE
@@ -3124,32 +3220,8 @@ unpack_Y444_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x;
-  sv += x;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 6;
-    U = GST_READ_UINT16_BE (su + i) << 6;
-    V = GST_READ_UINT16_BE (sv + i) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 0, 10, TRUE);
 }
 
 static void
@@ -3158,22 +3230,8 @@ pack_Y444_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width; i++) {
-    Y = s[i * 4 + 1] >> 6;
-    U = s[i * 4 + 2] >> 6;
-    V = s[i * 4 + 3] >> 6;
-
-    GST_WRITE_UINT16_BE (dy + i, Y);
-    GST_WRITE_UINT16_BE (du + i, U);
-    GST_WRITE_UINT16_BE (dv + i, V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 0, TRUE, 10, TRUE);
 }
 
 #define PACK_I420_10LE GST_VIDEO_FORMAT_AYUV64, unpack_I420_10LE, 1, pack_I420_10LE
@@ -3182,39 +3240,10 @@ unpack_I420_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (uv);
-  const guint16 *restrict sv = GET_V_LINE (uv);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 6;
-    U = GST_READ_UINT16_LE (su + (i >> 1)) << 6;
-    V = GST_READ_UINT16_LE (sv + (i >> 1)) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
 
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (uv),
+      GET_V_LINE (uv), x, width, 1, 10, FALSE);
 }
 
 static void
@@ -3223,41 +3252,10 @@ pack_I420_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (uv);
-  guint16 *restrict dv = GET_V_LINE (uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width - 1; i += 2) {
-      Y0 = s[i * 4 + 1] >> 6;
-      Y1 = s[i * 4 + 5] >> 6;
-      U = s[i * 4 + 2] >> 6;
-      V = s[i * 4 + 3] >> 6;
-
-      GST_WRITE_UINT16_LE (dy + i + 0, Y0);
-      GST_WRITE_UINT16_LE (dy + i + 1, Y1);
-      GST_WRITE_UINT16_LE (du + (i >> 1), U);
-      GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-    }
-    if (i == width - 1) {
-      Y0 = s[i * 4 + 1] >> 6;
-      U = s[i * 4 + 2] >> 6;
-      V = s[i * 4 + 3] >> 6;
 
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-      GST_WRITE_UINT16_LE (du + (i >> 1), U);
-      GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] >> 6;
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-    }
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (uv), GET_V_LINE (uv), src,
+      width, 1, IS_CHROMA_LINE_420 (y, flags), 10, FALSE);
 }
 
 #define PACK_I420_10BE GST_VIDEO_FORMAT_AYUV64, unpack_I420_10BE, 1, pack_I420_10BE
@@ -3266,40 +3264,11 @@ unpack_I420_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (uv);
-  const guint16 *restrict sv = GET_V_LINE (uv);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
 
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 6;
-    U = GST_READ_UINT16_BE (su + (i >> 1)) << 6;
-    V = GST_READ_UINT16_BE (sv + (i >> 1)) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
-}
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (uv),
+      GET_V_LINE (uv), x, width, 1, 10, TRUE);
+}
 
 static void
 pack_I420_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
@@ -3307,41 +3276,10 @@ pack_I420_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (uv);
-  guint16 *restrict dv = GET_V_LINE (uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width - 1; i += 2) {
-      Y0 = s[i * 4 + 1] >> 6;
-      Y1 = s[i * 4 + 5] >> 6;
-      U = s[i * 4 + 2] >> 6;
-      V = s[i * 4 + 3] >> 6;
 
-      GST_WRITE_UINT16_BE (dy + i + 0, Y0);
-      GST_WRITE_UINT16_BE (dy + i + 1, Y1);
-      GST_WRITE_UINT16_BE (du + (i >> 1), U);
-      GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-    }
-    if (i == width - 1) {
-      Y0 = s[i * 4 + 1] >> 6;
-      U = s[i * 4 + 2] >> 6;
-      V = s[i * 4 + 3] >> 6;
-
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-      GST_WRITE_UINT16_BE (du + (i >> 1), U);
-      GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] >> 6;
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-    }
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (uv), GET_V_LINE (uv), src,
+      width, 1, IS_CHROMA_LINE_420 (y, flags), 10, TRUE);
 }
 
 #define PACK_I422_10LE GST_VIDEO_FORMAT_AYUV64, unpack_I422_10LE, 1, pack_I422_10LE
@@ -3350,38 +3288,8 @@ unpack_I422_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 6;
-    U = GST_READ_UINT16_LE (su + (i >> 1)) << 6;
-    V = GST_READ_UINT16_LE (sv + (i >> 1)) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 1, 10, FALSE);
 }
 
 static void
@@ -3390,33 +3298,8 @@ pack_I422_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width - 1; i += 2) {
-    Y0 = s[i * 4 + 1] >> 6;
-    Y1 = s[i * 4 + 5] >> 6;
-    U = s[i * 4 + 2] >> 6;
-    V = s[i * 4 + 3] >> 6;
-
-    GST_WRITE_UINT16_LE (dy + i + 0, Y0);
-    GST_WRITE_UINT16_LE (dy + i + 1, Y1);
-    GST_WRITE_UINT16_LE (du + (i >> 1), U);
-    GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-  }
-  if (i == width - 1) {
-    Y0 = s[i * 4 + 1] >> 6;
-    U = s[i * 4 + 2] >> 6;
-    V = s[i * 4 + 3] >> 6;
-
-    GST_WRITE_UINT16_LE (dy + i, Y0);
-    GST_WRITE_UINT16_LE (du + (i >> 1), U);
-    GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 1, TRUE, 10, FALSE);
 }
 
 #define PACK_I422_10BE GST_VIDEO_FORMAT_AYUV64, unpack_I422_10BE, 1, pack_I422_10BE
@@ -3425,38 +3308,8 @@ unpack_I422_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 6;
-    U = GST_READ_UINT16_BE (su + (i >> 1)) << 6;
-    V = GST_READ_UINT16_BE (sv + (i >> 1)) << 6;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 1, 10, TRUE);
 }
 
 static void
@@ -3465,33 +3318,8 @@ pack_I422_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width - 1; i += 2) {
-    Y0 = s[i * 4 + 1] >> 6;
-    Y1 = s[i * 4 + 5] >> 6;
-    U = s[i * 4 + 2] >> 6;
-    V = s[i * 4 + 3] >> 6;
-
-    GST_WRITE_UINT16_BE (dy + i + 0, Y0);
-    GST_WRITE_UINT16_BE (dy + i + 1, Y1);
-    GST_WRITE_UINT16_BE (du + (i >> 1), U);
-    GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-  }
-  if (i == width - 1) {
-    Y0 = s[i * 4 + 1] >> 6;
-    U = s[i * 4 + 2] >> 6;
-    V = s[i * 4 + 3] >> 6;
-
-    GST_WRITE_UINT16_BE (dy + i, Y0);
-    GST_WRITE_UINT16_BE (du + (i >> 1), U);
-    GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 1, TRUE, 10, TRUE);
 }
 
 #define PACK_Y444_12LE GST_VIDEO_FORMAT_AYUV64, unpack_Y444_12LE, 1, pack_Y444_12LE
@@ -3500,32 +3328,8 @@ unpack_Y444_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  guint16 *restrict sy = GET_Y_LINE (y);
-  guint16 *restrict su = GET_U_LINE (y);
-  guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x;
-  sv += x;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 4;
-    U = GST_READ_UINT16_LE (su + i) << 4;
-    V = GST_READ_UINT16_LE (sv + i) << 4;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 0, 12, FALSE);
 }
 
 static void
@@ -3534,22 +3338,8 @@ pack_Y444_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width; i++) {
-    Y = (s[i * 4 + 1]) >> 4;
-    U = (s[i * 4 + 2]) >> 4;
-    V = (s[i * 4 + 3]) >> 4;
-
-    GST_WRITE_UINT16_LE (dy + i, Y);
-    GST_WRITE_UINT16_LE (du + i, U);
-    GST_WRITE_UINT16_LE (dv + i, V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 0, TRUE, 12, FALSE);
 }
 
 #define PACK_Y444_12BE GST_VIDEO_FORMAT_AYUV64, unpack_Y444_12BE, 1, pack_Y444_12BE
@@ -3558,32 +3348,8 @@ unpack_Y444_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x;
-  sv += x;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 4;
-    U = GST_READ_UINT16_BE (su + i) << 4;
-    V = GST_READ_UINT16_BE (sv + i) << 4;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 0, 12, TRUE);
 }
 
 static void
@@ -3592,22 +3358,8 @@ pack_Y444_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width; i++) {
-    Y = s[i * 4 + 1] >> 4;
-    U = s[i * 4 + 2] >> 4;
-    V = s[i * 4 + 3] >> 4;
-
-    GST_WRITE_UINT16_BE (dy + i, Y);
-    GST_WRITE_UINT16_BE (du + i, U);
-    GST_WRITE_UINT16_BE (dv + i, V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 0, TRUE, 12, TRUE);
 }
 
 #define PACK_I420_12LE GST_VIDEO_FORMAT_AYUV64, unpack_I420_12LE, 1, pack_I420_12LE
@@ -3616,206 +3368,56 @@ unpack_I420_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (uv);
-  const guint16 *restrict sv = GET_V_LINE (uv);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 4;
-    U = GST_READ_UINT16_LE (su + (i >> 1)) << 4;
-    V = GST_READ_UINT16_LE (sv + (i >> 1)) << 4;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
 
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (uv),
+      GET_V_LINE (uv), x, width, 1, 12, FALSE);
 }
 
 static void
 pack_I420_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gpointer src, gint sstride, gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
-    gint y, gint width)
-{
-  int i;
-  gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (uv);
-  guint16 *restrict dv = GET_V_LINE (uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width - 1; i += 2) {
-      Y0 = s[i * 4 + 1] >> 4;
-      Y1 = s[i * 4 + 5] >> 4;
-      U = s[i * 4 + 2] >> 4;
-      V = s[i * 4 + 3] >> 4;
-
-      GST_WRITE_UINT16_LE (dy + i + 0, Y0);
-      GST_WRITE_UINT16_LE (dy + i + 1, Y1);
-      GST_WRITE_UINT16_LE (du + (i >> 1), U);
-      GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-    }
-    if (i == width - 1) {
-      Y0 = s[i * 4 + 1] >> 4;
-      U = s[i * 4 + 2] >> 4;
-      V = s[i * 4 + 3] >> 4;
-
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-      GST_WRITE_UINT16_LE (du + (i >> 1), U);
-      GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] >> 4;
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-    }
-  }
-}
-
-#define PACK_I420_12BE GST_VIDEO_FORMAT_AYUV64, unpack_I420_12BE, 1, pack_I420_12BE
-static void
-unpack_I420_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
-    gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
-    const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
-{
-  int i;
-  gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (uv);
-  const guint16 *restrict sv = GET_V_LINE (uv);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 4;
-    U = GST_READ_UINT16_BE (su + (i >> 1)) << 4;
-    V = GST_READ_UINT16_BE (sv + (i >> 1)) << 4;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
-}
-
-static void
-pack_I420_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
-    const gpointer src, gint sstride, gpointer data[GST_VIDEO_MAX_PLANES],
-    const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
-    gint y, gint width)
-{
-  int i;
-  gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (uv);
-  guint16 *restrict dv = GET_V_LINE (uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width - 1; i += 2) {
-      Y0 = s[i * 4 + 1] >> 4;
-      Y1 = s[i * 4 + 5] >> 4;
-      U = s[i * 4 + 2] >> 4;
-      V = s[i * 4 + 3] >> 4;
-
-      GST_WRITE_UINT16_BE (dy + i + 0, Y0);
-      GST_WRITE_UINT16_BE (dy + i + 1, Y1);
-      GST_WRITE_UINT16_BE (du + (i >> 1), U);
-      GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-    }
-    if (i == width - 1) {
-      Y0 = s[i * 4 + 1] >> 4;
-      U = s[i * 4 + 2] >> 4;
-      V = s[i * 4 + 3] >> 4;
-
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-      GST_WRITE_UINT16_BE (du + (i >> 1), U);
-      GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] >> 4;
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-    }
-  }
+    gint y, gint width)
+{
+  gint uv = GET_UV_420 (y, flags);
+
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (uv), GET_V_LINE (uv), src,
+      width, 1, IS_CHROMA_LINE_420 (y, flags), 12, FALSE);
 }
 
-#define PACK_I422_12LE GST_VIDEO_FORMAT_AYUV64, unpack_I422_12LE, 1, pack_I422_12LE
+#define PACK_I420_12BE GST_VIDEO_FORMAT_AYUV64, unpack_I420_12BE, 1, pack_I420_12BE
 static void
-unpack_I422_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
+unpack_I420_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
+  gint uv = GET_UV_420 (y, flags);
 
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_LE (sy + i) << 4;
-    U = GST_READ_UINT16_LE (su + (i >> 1)) << 4;
-    V = GST_READ_UINT16_LE (sv + (i >> 1)) << 4;
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (uv),
+      GET_V_LINE (uv), x, width, 1, 12, TRUE);
+}
 
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
+static void
+pack_I420_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
+    const gpointer src, gint sstride, gpointer data[GST_VIDEO_MAX_PLANES],
+    const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
+    gint y, gint width)
+{
+  gint uv = GET_UV_420 (y, flags);
 
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (uv), GET_V_LINE (uv), src,
+      width, 1, IS_CHROMA_LINE_420 (y, flags), 12, TRUE);
+}
 
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+#define PACK_I422_12LE GST_VIDEO_FORMAT_AYUV64, unpack_I422_12LE, 1, pack_I422_12LE
+static void
+unpack_I422_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
+    gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
+    const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
+{
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 1, 12, FALSE);
 }
 
 static void
@@ -3824,33 +3426,8 @@ pack_I422_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width - 1; i += 2) {
-    Y0 = s[i * 4 + 1] >> 4;
-    Y1 = s[i * 4 + 5] >> 4;
-    U = s[i * 4 + 2] >> 4;
-    V = s[i * 4 + 3] >> 4;
-
-    GST_WRITE_UINT16_LE (dy + i + 0, Y0);
-    GST_WRITE_UINT16_LE (dy + i + 1, Y1);
-    GST_WRITE_UINT16_LE (du + (i >> 1), U);
-    GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-  }
-  if (i == width - 1) {
-    Y0 = s[i * 4 + 1] >> 4;
-    U = s[i * 4 + 2] >> 4;
-    V = s[i * 4 + 3] >> 4;
-
-    GST_WRITE_UINT16_LE (dy + i, Y0);
-    GST_WRITE_UINT16_LE (du + (i >> 1), U);
-    GST_WRITE_UINT16_LE (dv + (i >> 1), V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 1, TRUE, 12, FALSE);
 }
 
 #define PACK_I422_12BE GST_VIDEO_FORMAT_AYUV64, unpack_I422_12BE, 1, pack_I422_12BE
@@ -3859,38 +3436,8 @@ unpack_I422_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
-  const guint16 *restrict sy = GET_Y_LINE (y);
-  const guint16 *restrict su = GET_U_LINE (y);
-  const guint16 *restrict sv = GET_V_LINE (y);
-  guint16 *restrict d = dest, Y, U, V;
-
-  sy += x;
-  su += x >> 1;
-  sv += x >> 1;
-
-  for (i = 0; i < width; i++) {
-    Y = GST_READ_UINT16_BE (sy + i) << 4;
-    U = GST_READ_UINT16_BE (su + (i >> 1)) << 4;
-    V = GST_READ_UINT16_BE (sv + (i >> 1)) << 4;
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y |= (Y >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-
-    if (x & 1) {
-      x = 0;
-      su++;
-      sv++;
-    }
-  }
+  unpack_yuv_planar_16 (flags, dest, GET_Y_LINE (y), GET_U_LINE (y),
+      GET_V_LINE (y), x, width, 1, 12, TRUE);
 }
 
 static void
@@ -3899,33 +3446,8 @@ pack_I422_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
-  guint16 *restrict dy = GET_Y_LINE (y);
-  guint16 *restrict du = GET_U_LINE (y);
-  guint16 *restrict dv = GET_V_LINE (y);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  for (i = 0; i < width - 1; i += 2) {
-    Y0 = s[i * 4 + 1] >> 4;
-    Y1 = s[i * 4 + 5] >> 4;
-    U = s[i * 4 + 2] >> 4;
-    V = s[i * 4 + 3] >> 4;
-
-    GST_WRITE_UINT16_BE (dy + i + 0, Y0);
-    GST_WRITE_UINT16_BE (dy + i + 1, Y1);
-    GST_WRITE_UINT16_BE (du + (i >> 1), U);
-    GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-  }
-  if (i == width - 1) {
-    Y0 = s[i * 4 + 1] >> 4;
-    U = s[i * 4 + 2] >> 4;
-    V = s[i * 4 + 3] >> 4;
-
-    GST_WRITE_UINT16_BE (dy + i, Y0);
-    GST_WRITE_UINT16_BE (du + (i >> 1), U);
-    GST_WRITE_UINT16_BE (dv + (i >> 1), V);
-  }
+  pack_yuv_planar_16 (GET_Y_LINE (y), GET_U_LINE (y), GET_V_LINE (y), src,
+      width, 1, TRUE, 12, TRUE);
 }
 
 #define PACK_A444_10LE GST_VIDEO_FORMAT_AYUV64, unpack_A444_10LE, 1, pack_A444_10LE
@@ -4567,77 +4089,10 @@ unpack_P010_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_BE (sy);
-    U = GST_READ_UINT16_BE (suv);
-    V = GST_READ_UINT16_BE (suv + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_BE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_BE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_BE (suv + 2 * i);
-    V = GST_READ_UINT16_BE (suv + 2 * i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      Y1 |= (Y1 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
-
-  if (width & 1) {
-    gint i = width - 1;
 
-    Y0 = GST_READ_UINT16_BE (sy + i);
-    U = GST_READ_UINT16_BE (suv + i);
-    V = GST_READ_UINT16_BE (suv + i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 10, TRUE);
 }
 
 static void
@@ -4646,42 +4101,10 @@ pack_P010_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1] & 0xffc0;
-      Y1 = s[i * 8 + 5] & 0xffc0;
-      U = s[i * 8 + 2] & 0xffc0;
-      V = s[i * 8 + 3] & 0xffc0;
-
-      GST_WRITE_UINT16_BE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_BE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
-
-      Y0 = s[i * 4 + 1] & 0xffc0;
-      U = s[i * 4 + 2] & 0xffc0;
-      V = s[i * 4 + 3] & 0xffc0;
 
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-      GST_WRITE_UINT16_BE (duv + i + 0, U);
-      GST_WRITE_UINT16_BE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] & 0xffc0;
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 10, TRUE);
 }
 
 #define PACK_P010_10LE GST_VIDEO_FORMAT_AYUV64, unpack_P010_10LE, 1, pack_P010_10LE
@@ -4690,121 +4113,22 @@ unpack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_LE (sy);
-    U = GST_READ_UINT16_LE (suv);
-    V = GST_READ_UINT16_LE (suv + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_LE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_LE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_LE (suv + 2 * i);
-    V = GST_READ_UINT16_LE (suv + 2 * i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      Y1 |= (Y1 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
-
-  if (width & 1) {
-    gint i = width - 1;
-
-    Y0 = GST_READ_UINT16_LE (sy + i);
-    U = GST_READ_UINT16_LE (suv + i);
-    V = GST_READ_UINT16_LE (suv + i + 1);
 
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 10);
-      U |= (U >> 10);
-      V |= (V >> 10);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 10, FALSE);
 }
 
 static void
 pack_P010_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gpointer src, gint sstride, gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
-    gint y, gint width)
-{
-  int i;
-  gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1] & 0xffc0;
-      Y1 = s[i * 8 + 5] & 0xffc0;
-      U = s[i * 8 + 2] & 0xffc0;
-      V = s[i * 8 + 3] & 0xffc0;
-
-      GST_WRITE_UINT16_LE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_LE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
-
-      Y0 = s[i * 4 + 1] & 0xffc0;
-      U = s[i * 4 + 2] & 0xffc0;
-      V = s[i * 4 + 3] & 0xffc0;
+    gint y, gint width)
+{
+  gint uv = GET_UV_420 (y, flags);
 
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-      GST_WRITE_UINT16_LE (duv + i + 0, U);
-      GST_WRITE_UINT16_LE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] & 0xffc0;
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 10, FALSE);
 }
 
 #define PACK_GRAY10_LE32 GST_VIDEO_FORMAT_AYUV64, unpack_GRAY10_LE32, 1, pack_GRAY10_LE32
@@ -5603,58 +4927,10 @@ unpack_P016_BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_BE (sy);
-    U = GST_READ_UINT16_BE (suv);
-    V = GST_READ_UINT16_BE (suv + 1);
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_BE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_BE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_BE (suv + 2 * i);
-    V = GST_READ_UINT16_BE (suv + 2 * i + 1);
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
-
-  if (width & 1) {
-    gint i = width - 1;
-
-    Y0 = GST_READ_UINT16_BE (sy + i);
-    U = GST_READ_UINT16_BE (suv + i);
-    V = GST_READ_UINT16_BE (suv + i + 1);
 
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 16, TRUE);
 }
 
 static void
@@ -5663,42 +4939,10 @@ pack_P016_BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
 
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1];
-      Y1 = s[i * 8 + 5];
-      U = s[i * 8 + 2];
-      V = s[i * 8 + 3];
-
-      GST_WRITE_UINT16_BE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_BE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
-
-      Y0 = s[i * 4 + 1];
-      U = s[i * 4 + 2];
-      V = s[i * 4 + 3];
-
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-      GST_WRITE_UINT16_BE (duv + i + 0, U);
-      GST_WRITE_UINT16_BE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1];
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 16, TRUE);
 }
 
 #define PACK_P016_LE GST_VIDEO_FORMAT_AYUV64, unpack_P016_LE, 1, pack_P016_LE
@@ -5707,58 +4951,10 @@ unpack_P016_LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_LE (sy);
-    U = GST_READ_UINT16_LE (suv);
-    V = GST_READ_UINT16_LE (suv + 1);
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_LE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_LE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_LE (suv + 2 * i);
-    V = GST_READ_UINT16_LE (suv + 2 * i + 1);
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
 
-  if (width & 1) {
-    gint i = width - 1;
-
-    Y0 = GST_READ_UINT16_LE (sy + i);
-    U = GST_READ_UINT16_LE (suv + i);
-    V = GST_READ_UINT16_LE (suv + i + 1);
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 16, FALSE);
 }
 
 static void
@@ -5767,42 +4963,10 @@ pack_P016_LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1];
-      Y1 = s[i * 8 + 5];
-      U = s[i * 8 + 2];
-      V = s[i * 8 + 3];
-
-      GST_WRITE_UINT16_LE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_LE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
 
-      Y0 = s[i * 4 + 1];
-      U = s[i * 4 + 2];
-      V = s[i * 4 + 3];
-
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-      GST_WRITE_UINT16_LE (duv + i + 0, U);
-      GST_WRITE_UINT16_LE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1];
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 16, FALSE);
 }
 
 #define PACK_P012_BE GST_VIDEO_FORMAT_AYUV64, unpack_P012_BE, 1, pack_P012_BE
@@ -5811,77 +4975,10 @@ unpack_P012_BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_BE (sy);
-    U = GST_READ_UINT16_BE (suv);
-    V = GST_READ_UINT16_BE (suv + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_BE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_BE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_BE (suv + 2 * i);
-    V = GST_READ_UINT16_BE (suv + 2 * i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      Y1 |= (Y1 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
-
-  if (width & 1) {
-    gint i = width - 1;
-
-    Y0 = GST_READ_UINT16_BE (sy + i);
-    U = GST_READ_UINT16_BE (suv + i);
-    V = GST_READ_UINT16_BE (suv + i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
 
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 12, TRUE);
 }
 
 static void
@@ -5890,42 +4987,10 @@ pack_P012_BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1] & 0xfff0;
-      Y1 = s[i * 8 + 5] & 0xfff0;
-      U = s[i * 8 + 2] & 0xfff0;
-      V = s[i * 8 + 3] & 0xfff0;
-
-      GST_WRITE_UINT16_BE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_BE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_BE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
-
-      Y0 = s[i * 4 + 1] & 0xfff0;
-      U = s[i * 4 + 2] & 0xfff0;
-      V = s[i * 4 + 3] & 0xfff0;
 
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-      GST_WRITE_UINT16_BE (duv + i + 0, U);
-      GST_WRITE_UINT16_BE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] & 0xfff0;
-      GST_WRITE_UINT16_BE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 12, TRUE);
 }
 
 #define PACK_P012_LE GST_VIDEO_FORMAT_AYUV64, unpack_P012_LE, 1, pack_P012_LE
@@ -5934,77 +4999,10 @@ unpack_P012_LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     gpointer dest, const gpointer data[GST_VIDEO_MAX_PLANES],
     const gint stride[GST_VIDEO_MAX_PLANES], gint x, gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  const guint16 *restrict sy = GET_PLANE_LINE (0, y);
-  const guint16 *restrict suv = GET_PLANE_LINE (1, uv);
-  guint16 *restrict d = dest, Y0, Y1, U, V;
-
-  sy += x;
-  suv += (x & ~1);
-
-  if (x & 1) {
-    Y0 = GST_READ_UINT16_LE (sy);
-    U = GST_READ_UINT16_LE (suv);
-    V = GST_READ_UINT16_LE (suv + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[0] = 0xffff;
-    d[1] = Y0;
-    d[2] = U;
-    d[3] = V;
-    width--;
-    d += 4;
-    sy += 1;
-    suv += 2;
-  }
-
-  for (i = 0; i < width / 2; i++) {
-    Y0 = GST_READ_UINT16_LE (sy + 2 * i);
-    Y1 = GST_READ_UINT16_LE (sy + 2 * i + 1);
-    U = GST_READ_UINT16_LE (suv + 2 * i);
-    V = GST_READ_UINT16_LE (suv + 2 * i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      Y1 |= (Y1 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 8 + 0] = 0xffff;
-    d[i * 8 + 1] = Y0;
-    d[i * 8 + 2] = U;
-    d[i * 8 + 3] = V;
-    d[i * 8 + 4] = 0xffff;
-    d[i * 8 + 5] = Y1;
-    d[i * 8 + 6] = U;
-    d[i * 8 + 7] = V;
-  }
 
-  if (width & 1) {
-    gint i = width - 1;
-
-    Y0 = GST_READ_UINT16_LE (sy + i);
-    U = GST_READ_UINT16_LE (suv + i);
-    V = GST_READ_UINT16_LE (suv + i + 1);
-
-    if (!(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE)) {
-      Y0 |= (Y0 >> 12);
-      U |= (U >> 12);
-      V |= (V >> 12);
-    }
-
-    d[i * 4 + 0] = 0xffff;
-    d[i * 4 + 1] = Y0;
-    d[i * 4 + 2] = U;
-    d[i * 4 + 3] = V;
-  }
+  unpack_yuv_semi_planar_16 (flags, dest, GET_PLANE_LINE (0, y),
+      GET_PLANE_LINE (1, uv), x, width, 12, FALSE);
 }
 
 static void
@@ -6013,42 +5011,10 @@ pack_P012_LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
     const gint stride[GST_VIDEO_MAX_PLANES], GstVideoChromaSite chroma_site,
     gint y, gint width)
 {
-  int i;
   gint uv = GET_UV_420 (y, flags);
-  guint16 *restrict dy = GET_PLANE_LINE (0, y);
-  guint16 *restrict duv = GET_PLANE_LINE (1, uv);
-  guint16 Y0, Y1, U, V;
-  const guint16 *restrict s = src;
-
-  if (IS_CHROMA_LINE_420 (y, flags)) {
-    for (i = 0; i < width / 2; i++) {
-      Y0 = s[i * 8 + 1] & 0xfff0;
-      Y1 = s[i * 8 + 5] & 0xfff0;
-      U = s[i * 8 + 2] & 0xfff0;
-      V = s[i * 8 + 3] & 0xfff0;
-
-      GST_WRITE_UINT16_LE (dy + i * 2 + 0, Y0);
-      GST_WRITE_UINT16_LE (dy + i * 2 + 1, Y1);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 0, U);
-      GST_WRITE_UINT16_LE (duv + i * 2 + 1, V);
-    }
-    if (width & 1) {
-      gint i = width - 1;
 
-      Y0 = s[i * 4 + 1] & 0xfff0;
-      U = s[i * 4 + 2] & 0xfff0;
-      V = s[i * 4 + 3] & 0xfff0;
-
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-      GST_WRITE_UINT16_LE (duv + i + 0, U);
-      GST_WRITE_UINT16_LE (duv + i + 1, V);
-    }
-  } else {
-    for (i = 0; i < width; i++) {
-      Y0 = s[i * 4 + 1] & 0xfff0;
-      GST_WRITE_UINT16_LE (dy + i, Y0);
-    }
-  }
+  pack_yuv_semi_planar_16 (GET_PLANE_LINE (0, y), GET_PLANE_LINE (1, uv),
+      src, width, IS_CHROMA_LINE_420 (y, flags), 12, FALSE);
 }
 
 #define PACK_Y212_BE GST_VIDEO_FORMAT_AYUV64, unpack_Y212_BE, 1, pack_Y212_BE
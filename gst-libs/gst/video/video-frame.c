@@ -47,28 +47,143 @@ video_frame_get_perf_category (void)
   return cat;
 }
 
-/**
- * gst_video_frame_map_id:
- * @frame: (out caller-allocates): pointer to #GstVideoFrame
- * @info: a #GstVideoInfo
- * @buffer: the buffer to map
- * @id: the frame id to map
- * @flags: #GstMapFlags
- *
- * Use @info and @buffer to fill in the values of @frame with the video frame
- * information of frame @id.
- *
- * When @id is -1, the default frame is mapped. When @id != -1, this function
- * will return %FALSE when there is no GstVideoMeta with that id.
- *
- * All video planes of @buffer will be mapped and the pointers will be set in
- * @frame->data.
- *
- * Returns: %TRUE on success.
- */
-gboolean
-gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
-    GstBuffer * buffer, gint id, GstMapFlags flags)
+/* byte offset of the top-left pixel of the mapped region in @plane */
+static gssize
+video_frame_region_offset (const GstVideoFrame * frame, guint plane)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  gint comp[GST_VIDEO_MAX_COMPONENTS];
+  guint x = frame->ABI.abi.x;
+  guint y = frame->ABI.abi.y;
+
+  if (x == 0 && y == 0)
+    return 0;
+
+  /* the palette is not part of the image */
+  if (GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo) && plane == 1)
+    return 0;
+
+  gst_video_format_info_component (finfo, plane, comp);
+
+  return (gssize) GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp[0], y) *
+      frame->info.stride[plane] +
+      GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (finfo, comp[0], x) *
+      GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, comp[0]);
+}
+
+static gboolean
+video_frame_region_is_valid (const GstVideoInfo * info, guint x, guint y,
+    guint width, guint height)
+{
+  const GstVideoFormatInfo *finfo = info->finfo;
+  guint i;
+
+  if (width == 0 || height == 0 || x > info->width || y > info->height ||
+      width > info->width - x || height > info->height - y)
+    return FALSE;
+
+  /* tiles and complex packings can't be addressed per pixel */
+  if (GST_VIDEO_FORMAT_INFO_IS_TILED (finfo))
+    return FALSE;
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    guint w_align = 1 << GST_VIDEO_FORMAT_INFO_W_SUB (finfo, i);
+    guint h_align = 1 << GST_VIDEO_FORMAT_INFO_H_SUB (finfo, i);
+
+    if (GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, i) == 0)
+      return FALSE;
+    if (x % w_align != 0 || y % h_align != 0)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* map only the memories of the buffer that contain the rows of @plane that
+ * are part of the mapped region */
+static gboolean
+video_frame_map_plane_range (GstVideoFrame * frame, guint plane)
+{
+  const GstVideoInfo *info = &frame->info;
+  const GstVideoFormatInfo *finfo = info->finfo;
+  GstMapInfo *map = &frame->map[plane];
+  gsize offset, end, skip;
+  guint i, idx, length;
+
+  offset = info->offset[plane];
+  end = info->size;
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (info); i++) {
+    if (info->offset[i] > offset && info->offset[i] < end)
+      end = info->offset[i];
+  }
+
+  if (!GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) &&
+      !(GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo) && plane == 1)) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+    gsize rows_end;
+
+    gst_video_format_info_component (finfo, plane, comp);
+    rows_end = offset + (gsize) info->stride[plane] *
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp[0],
+        frame->ABI.abi.y + info->height);
+    end = MIN (end, rows_end);
+  }
+  offset += video_frame_region_offset (frame, plane);
+
+  if (offset >= end)
+    goto invalid_size;
+
+  if (!gst_buffer_find_memory (frame->buffer, offset, end - offset, &idx,
+          &length, &skip))
+    goto invalid_size;
+
+  if (!gst_buffer_map_range (frame->buffer, idx, length, map,
+          frame->ABI.abi.map_flags))
+    goto map_failed;
+
+  frame->data[plane] = map->data + skip;
+
+  return TRUE;
+
+  /* ERRORS */
+invalid_size:
+  {
+    GST_ERROR ("no memory for plane %u at offset %" G_GSIZE_FORMAT "-%"
+        G_GSIZE_FORMAT, plane, offset, end);
+    return FALSE;
+  }
+map_failed:
+  {
+    GST_ERROR ("failed to map memory range %u-%u", idx, length);
+    return FALSE;
+  }
+}
+
+static gboolean
+video_frame_map_plane (GstVideoFrame * frame, guint plane)
+{
+  GstVideoMeta *meta = frame->meta;
+
+  if (meta) {
+    if (!gst_video_meta_map (meta, plane, &frame->map[plane],
+            &frame->data[plane], &frame->info.stride[plane],
+            frame->ABI.abi.map_flags))
+      return FALSE;
+
+    frame->data[plane] =
+        (guint8 *) frame->data[plane] + video_frame_region_offset (frame,
+        plane);
+  } else if (!video_frame_map_plane_range (frame, plane)) {
+    return FALSE;
+  }
+  frame->ABI.abi.mapped_planes |= 1 << plane;
+
+  return TRUE;
+}
+
+static gboolean
+video_frame_map_internal (GstVideoFrame * frame, const GstVideoInfo * info,
+    GstBuffer * buffer, gint id, guint x, guint y, guint width, guint height,
+    GstMapFlags flags)
 {
   GstVideoMeta *meta;
   gint i;
@@ -85,6 +200,8 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
 
   /* copy the info */
   frame->info = *info;
+  memset (&frame->ABI, 0, sizeof (frame->ABI));
+  frame->ABI.abi.map_flags = flags;
 
   if (meta) {
     /* All these values must be consistent */
@@ -99,12 +216,8 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
     frame->id = meta->id;
     frame->flags = meta->flags;
 
-    for (i = 0; i < meta->n_planes; i++) {
+    for (i = 0; i < meta->n_planes; i++)
       frame->info.offset[i] = meta->offset[i];
-      if (!gst_video_meta_map (meta, i, &frame->map[i], &frame->data[i],
-              &frame->info.stride[i], flags))
-        goto frame_map_failed;
-    }
   } else {
     /* no metadata, we really need to have the metadata when the id is
      * specified. */
@@ -113,7 +226,32 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
 
     frame->id = id;
     frame->flags = 0;
+  }
+
+  if (width != 0) {
+    if (!video_frame_region_is_valid (&frame->info, x, y, width, height))
+      goto invalid_region;
+
+    frame->info.width = width;
+    frame->info.height = height;
+    frame->ABI.abi.x = x;
+    frame->ABI.abi.y = y;
+  }
+
+  frame->buffer = buffer;
+  frame->meta = meta;
+  memset (frame->data, 0, sizeof (frame->data));
 
+  if (flags & GST_VIDEO_FRAME_MAP_FLAG_LAZY) {
+    /* planes are mapped with gst_video_frame_map_plane() */
+    if (!meta && gst_buffer_get_size (buffer) < info->size)
+      goto invalid_buffer_size;
+  } else if (meta) {
+    for (i = 0; i < meta->n_planes; i++) {
+      if (!video_frame_map_plane (frame, i))
+        goto frame_map_failed;
+    }
+  } else {
     if (!gst_buffer_map (buffer, &frame->map[0], flags))
       goto map_failed;
 
@@ -123,15 +261,15 @@ gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
 
     /* set up pointers */
     for (i = 0; i < info->finfo->n_planes; i++) {
-      frame->data[i] = frame->map[0].data + info->offset[i];
+      frame->data[i] = frame->map[0].data + info->offset[i] +
+          video_frame_region_offset (frame, i);
     }
+    frame->ABI.abi.mapped_planes = (1 << info->finfo->n_planes) - 1;
   }
-  frame->buffer = buffer;
+
   if ((flags & GST_VIDEO_FRAME_MAP_FLAG_NO_REF) == 0)
     gst_buffer_ref (frame->buffer);
 
-  frame->meta = meta;
-
   /* buffer flags enhance the frame flags */
   if (GST_VIDEO_INFO_IS_INTERLACED (info)) {
     if (GST_VIDEO_INFO_INTERLACE_MODE (info) == GST_VIDEO_INTERLACE_MODE_MIXED) {
@@ -163,6 +301,15 @@ no_metadata:
     memset (frame, 0, sizeof (GstVideoFrame));
     return FALSE;
   }
+invalid_region:
+  {
+    GST_ERROR ("invalid region %ux%u at %u,%u for %s frame of %dx%d", width,
+        height, x, y, GST_VIDEO_INFO_NAME (&frame->info),
+        GST_VIDEO_INFO_WIDTH (&frame->info),
+        GST_VIDEO_INFO_HEIGHT (&frame->info));
+    memset (frame, 0, sizeof (GstVideoFrame));
+    return FALSE;
+  }
 frame_map_failed:
   {
     GST_ERROR ("failed to map video frame plane %d", i);
@@ -184,6 +331,111 @@ invalid_size:
     memset (frame, 0, sizeof (GstVideoFrame));
     return FALSE;
   }
+invalid_buffer_size:
+  {
+    GST_ERROR ("invalid buffer size %" G_GSIZE_FORMAT " < %" G_GSIZE_FORMAT,
+        gst_buffer_get_size (buffer), info->size);
+    memset (frame, 0, sizeof (GstVideoFrame));
+    return FALSE;
+  }
+}
+
+/**
+ * gst_video_frame_map_id:
+ * @frame: (out caller-allocates): pointer to #GstVideoFrame
+ * @info: a #GstVideoInfo
+ * @buffer: the buffer to map
+ * @id: the frame id to map
+ * @flags: #GstMapFlags
+ *
+ * Use @info and @buffer to fill in the values of @frame with the video frame
+ * information of frame @id.
+ *
+ * When @id is -1, the default frame is mapped. When @id != -1, this function
+ * will return %FALSE when there is no GstVideoMeta with that id.
+ *
+ * All video planes of @buffer will be mapped and the pointers will be set in
+ * @frame->data, unless %GST_VIDEO_FRAME_MAP_FLAG_LAZY is in @flags.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean
+gst_video_frame_map_id (GstVideoFrame * frame, const GstVideoInfo * info,
+    GstBuffer * buffer, gint id, GstMapFlags flags)
+{
+  return video_frame_map_internal (frame, info, buffer, id, 0, 0, 0, 0, flags);
+}
+
+/**
+ * gst_video_frame_map_region:
+ * @frame: (out caller-allocates): pointer to #GstVideoFrame
+ * @info: a #GstVideoInfo
+ * @buffer: the buffer to map
+ * @x: the horizontal offset of the region
+ * @y: the vertical offset of the region
+ * @width: the width of the region
+ * @height: the height of the region
+ * @flags: #GstMapFlags
+ *
+ * Like gst_video_frame_map() but only maps the rectangle of @width x @height
+ * pixels at @x, @y of the frame, with the same meaning as the fields of a
+ * #GstVideoCropMeta.
+ *
+ * The width and height of @frame are set to the size of the region and the
+ * plane pointers in @frame->data point to its top-left pixel. The strides
+ * are those of the complete frame. Together with
+ * %GST_VIDEO_FRAME_MAP_FLAG_LAZY, only the memories of @buffer that contain
+ * rows of the region are mapped.
+ *
+ * @x and @y must be multiples of the chroma subsampling of the format. Tiled
+ * formats and formats that pack several pixels in a group of bytes can't be
+ * mapped partially.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_video_frame_map_region (GstVideoFrame * frame, const GstVideoInfo * info,
+    GstBuffer * buffer, guint x, guint y, guint width, guint height,
+    GstMapFlags flags)
+{
+  g_return_val_if_fail (width > 0 && height > 0, FALSE);
+
+  return video_frame_map_internal (frame, info, buffer, -1, x, y, width,
+      height, flags);
+}
+
+/**
+ * gst_video_frame_map_plane:
+ * @frame: a #GstVideoFrame
+ * @plane: a plane
+ *
+ * Map the plane with index @plane of a frame that was mapped with
+ * %GST_VIDEO_FRAME_MAP_FLAG_LAZY and set @frame->data for it. Only the
+ * memories of the buffer that contain the plane are mapped, with the flags
+ * the frame was mapped with. Planes that are already mapped are left as they
+ * are and all mapped planes are unmapped again by gst_video_frame_unmap().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 1.20
+ */
+gboolean
+gst_video_frame_map_plane (GstVideoFrame * frame, guint plane)
+{
+  g_return_val_if_fail (frame != NULL, FALSE);
+  g_return_val_if_fail (frame->buffer != NULL, FALSE);
+  g_return_val_if_fail (plane < GST_VIDEO_FRAME_N_PLANES (frame), FALSE);
+
+  if (frame->ABI.abi.mapped_planes & (1 << plane))
+    return TRUE;
+
+  if (!video_frame_map_plane (frame, plane)) {
+    GST_ERROR ("failed to map video frame plane %u", plane);
+    return FALSE;
+  }
+  return TRUE;
 }
 
 /**
@@ -237,6 +489,10 @@ invalid_size:
  * just work and you can access the data easily. It also maps the underlying
  * memory chunks for you.
  *
+ * When only some planes or a part of the frame are needed, pass
+ * %GST_VIDEO_FRAME_MAP_FLAG_LAZY and map the planes with
+ * gst_video_frame_map_plane(), or use gst_video_frame_map_region().
+ *
  * Returns: %TRUE on success.
  */
 gboolean
@@ -264,11 +520,16 @@ gst_video_frame_unmap (GstVideoFrame * frame)
 
   buffer = frame->buffer;
   meta = frame->meta;
-  flags = frame->map[0].flags;
+  flags = frame->ABI.abi.map_flags;
 
-  if (meta) {
+  if (meta || (flags & GST_VIDEO_FRAME_MAP_FLAG_LAZY)) {
     for (i = 0; i < frame->info.finfo->n_planes; i++) {
-      gst_video_meta_unmap (meta, i, &frame->map[i]);
+      if ((frame->ABI.abi.mapped_planes & (1 << i)) == 0)
+        continue;
+      if (meta)
+        gst_video_meta_unmap (meta, i, &frame->map[i]);
+      else
+        gst_buffer_unmap (buffer, &frame->map[i]);
     }
   } else {
     gst_buffer_unmap (buffer, &frame->map[0]);
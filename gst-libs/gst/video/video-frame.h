@@ -90,7 +90,14 @@ struct _GstVideoFrame {
   GstMapInfo map[GST_VIDEO_MAX_PLANES];
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  union {
+    gpointer _gst_reserved[GST_PADDING];
+    struct {
+      GstMapFlags map_flags;
+      guint mapped_planes;
+      guint x, y;
+    } abi;
+  } ABI;
 };
 
 GST_VIDEO_API
@@ -101,6 +108,14 @@ GST_VIDEO_API
 gboolean    gst_video_frame_map_id        (GstVideoFrame *frame, const GstVideoInfo *info,
                                            GstBuffer *buffer, gint id, GstMapFlags flags);
 
+GST_VIDEO_API
+gboolean    gst_video_frame_map_region    (GstVideoFrame *frame, const GstVideoInfo *info,
+                                           GstBuffer *buffer, guint x, guint y,
+                                           guint width, guint height, GstMapFlags flags);
+
+GST_VIDEO_API
+gboolean    gst_video_frame_map_plane     (GstVideoFrame *frame, guint plane);
+
 GST_VIDEO_API
 void        gst_video_frame_unmap         (GstVideoFrame *frame);
 
@@ -185,6 +200,10 @@ gboolean    gst_video_frame_copy_plane    (GstVideoFrame *dest, const GstVideoFr
  *                                     Use GST_VIDEO_BUFFER_IS_BOTTOM_FIELD() to check for this flag.
  * @GST_VIDEO_BUFFER_FLAG_MARKER:      The #GstBuffer contains the end of a video field or frame
  *                                     boundary such as the last subframe or packet (Since: 1.18).
+ * @GST_VIDEO_BUFFER_FLAG_REPEATED:    The #GstBuffer contains the same video frame as the
+ *                                     previous buffer of the stream and usually shares its
+ *                                     memory with it. Elements can use this to skip
+ *                                     processing the frame again (Since: 1.20).
  * @GST_VIDEO_BUFFER_FLAG_LAST:        Offset to define more flags
  *
  * Additional video buffer flags. These flags can potentially be used on any
@@ -208,6 +227,8 @@ typedef enum {
 
   GST_VIDEO_BUFFER_FLAG_MARKER       = GST_BUFFER_FLAG_MARKER,
 
+  GST_VIDEO_BUFFER_FLAG_REPEATED     = (GST_BUFFER_FLAG_LAST << 6),
+
   GST_VIDEO_BUFFER_FLAG_LAST        = (GST_BUFFER_FLAG_LAST << 8)
 } GstVideoBufferFlags;
 
@@ -237,6 +258,9 @@ typedef enum {
  *                                    the GstVideoFrame. This makes sure that the buffer stays
  *                                    writable while the frame is mapped, but requires that the
  *                                    buffer reference stays valid until the frame is unmapped again.
+ * @GST_VIDEO_FRAME_MAP_FLAG_LAZY:    Don't map any plane when mapping the frame. Planes are mapped
+ *                                    on demand with gst_video_frame_map_plane() and @data stays
+ *                                    %NULL for the planes that are not mapped (Since: 1.20).
  * @GST_VIDEO_FRAME_MAP_FLAG_LAST:    Offset to define more flags
  *
  * Additional mapping flags for gst_video_frame_map().
@@ -245,6 +269,7 @@ typedef enum {
  */
 typedef enum {
   GST_VIDEO_FRAME_MAP_FLAG_NO_REF   = (GST_MAP_FLAG_LAST << 0),
+  GST_VIDEO_FRAME_MAP_FLAG_LAZY     = (GST_MAP_FLAG_LAST << 1),
   GST_VIDEO_FRAME_MAP_FLAG_LAST     = (GST_MAP_FLAG_LAST << 8)
   /* 8 more flags possible afterwards */
 } GstVideoFrameMapFlags;
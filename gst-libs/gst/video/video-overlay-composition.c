@@ -60,6 +60,7 @@
 
 #include "video-overlay-composition.h"
 #include "video-blend.h"
+#include "video-blend-private.h"
 #include "gstvideometa.h"
 #include <string.h>
 
@@ -137,6 +138,16 @@ struct _GstVideoOverlayRectangle
   GMutex lock;
 
   GList *scaled_rectangles;
+
+  /* scaled pixels converted to the colour space of the last frame they were
+   * blended onto with the alpha values applied, see
+   * gst_video_blend_prepare_source(). Only valid as long as the render size,
+   * the global alpha and the pixels are unchanged. */
+  GstBuffer *blend_pixels;
+  gboolean blend_is_rgb;
+  guint blend_width, blend_height;
+  gfloat blend_global_alpha;
+  gfloat blend_applied_global_alpha;
 };
 
 #define GST_RECTANGLE_LOCK(rect)   g_mutex_lock(&rect->lock)
@@ -449,6 +460,71 @@ gst_video_overlay_rectangle_needs_scaling (GstVideoOverlayRectangle * r)
       GST_VIDEO_INFO_HEIGHT (&r->info) != r->render_height);
 }
 
+/* Returns the pixels of @rect prepared for blending onto frames in the RGB
+ * or YUV colour space. They are cached in @rect so that static overlays only
+ * have to be scaled and converted once. */
+static GstBuffer *
+gst_video_overlay_rectangle_get_blend_pixels (GstVideoOverlayRectangle * rect,
+    gboolean is_rgb, guint * width, guint * height)
+{
+  GstVideoInfo scaled_info;
+  GstVideoInfo *vinfo;
+  GstVideoFrame frame;
+  GstBuffer *pixels, *prepared = NULL;
+  gfloat global_alpha, applied_global_alpha;
+
+  GST_RECTANGLE_LOCK (rect);
+  global_alpha = rect->global_alpha;
+  applied_global_alpha = rect->applied_global_alpha;
+  if (rect->blend_pixels != NULL && rect->blend_is_rgb == is_rgb
+      && rect->blend_width == rect->render_width
+      && rect->blend_height == rect->render_height
+      && rect->blend_global_alpha == global_alpha
+      && rect->blend_applied_global_alpha == applied_global_alpha) {
+    prepared = gst_buffer_ref (rect->blend_pixels);
+    *width = rect->blend_width;
+    *height = rect->blend_height;
+  }
+  GST_RECTANGLE_UNLOCK (rect);
+
+  if (prepared)
+    return prepared;
+
+  GST_LOG ("preparing rectangle %p for blending", rect);
+
+  if (gst_video_overlay_rectangle_needs_scaling (rect)) {
+    gst_video_blend_scale_linear_RGBA (&rect->info, rect->pixels,
+        rect->render_height, rect->render_width, &scaled_info, &pixels);
+    vinfo = &scaled_info;
+  } else {
+    pixels = gst_buffer_ref (rect->pixels);
+    vinfo = &rect->info;
+  }
+
+  if (gst_video_frame_map (&frame, vinfo, pixels, GST_MAP_READ)) {
+    prepared = gst_video_blend_prepare_source (&frame, is_rgb, global_alpha);
+    gst_video_frame_unmap (&frame);
+  }
+  gst_buffer_unref (pixels);
+
+  if (prepared == NULL)
+    return NULL;
+
+  *width = GST_VIDEO_INFO_WIDTH (vinfo);
+  *height = GST_VIDEO_INFO_HEIGHT (vinfo);
+
+  GST_RECTANGLE_LOCK (rect);
+  gst_buffer_replace (&rect->blend_pixels, prepared);
+  rect->blend_is_rgb = is_rgb;
+  rect->blend_width = *width;
+  rect->blend_height = *height;
+  rect->blend_global_alpha = global_alpha;
+  rect->blend_applied_global_alpha = applied_global_alpha;
+  GST_RECTANGLE_UNLOCK (rect);
+
+  return prepared;
+}
+
 /**
  * gst_video_overlay_composition_blend:
  * @comp: a #GstVideoOverlayComposition
@@ -476,6 +552,7 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
   GstVideoFormat fmt;
   GstBuffer *pixels = NULL;
   gboolean ret = TRUE;
+  gboolean use_prepared, is_rgb;
   guint n, num;
   int w, h;
 
@@ -490,8 +567,13 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
   GST_LOG ("Blending composition %p with %u rectangles onto video buffer %p "
       "(%ux%u, format %u)", comp, num, video_buf, w, h, fmt);
 
+  use_prepared = gst_video_blend_can_use_prepared (video_buf);
+  is_rgb = GST_VIDEO_INFO_IS_RGB (&video_buf->info);
+
   for (n = 0; n < num; ++n) {
     GstVideoOverlayRectangle *rect;
+    GstBuffer *prepared = NULL;
+    guint prepared_width, prepared_height;
     gboolean needs_scaling;
 
     rect = comp->rectangles[n];
@@ -500,6 +582,20 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
         GST_VIDEO_INFO_WIDTH (&rect->info), GST_VIDEO_INFO_HEIGHT (&rect->info),
         GST_VIDEO_INFO_FORMAT (&rect->info));
 
+    if (use_prepared) {
+      prepared = gst_video_overlay_rectangle_get_blend_pixels (rect, is_rgb,
+          &prepared_width, &prepared_height);
+      if (prepared) {
+        ret = gst_video_blend_prepared (video_buf, prepared, prepared_width,
+            prepared_height, rect->x, rect->y);
+        gst_buffer_unref (prepared);
+        if (!ret) {
+          GST_WARNING ("Could not blend overlay rectangle onto video buffer");
+        }
+        continue;
+      }
+    }
+
     needs_scaling = gst_video_overlay_rectangle_needs_scaling (rect);
     if (needs_scaling) {
       gst_video_blend_scale_linear_RGBA (&rect->info, rect->pixels,
@@ -645,6 +741,8 @@ gst_video_overlay_rectangle_free (GstMiniObject * mini_obj)
         g_list_delete_link (rect->scaled_rectangles, rect->scaled_rectangles);
   }
 
+  gst_buffer_replace (&rect->blend_pixels, NULL);
+
   g_free (rect->initial_alpha);
   g_mutex_clear (&rect->lock);
 
@@ -422,18 +422,6 @@ _mixer_pad_get_output_size (GstCompositor * comp, GstCompositorPad * comp_pad,
   *height = pad_height;
 }
 
-/* Test whether rectangle2 contains rectangle 1 (geometrically) */
-static gboolean
-is_rectangle_contained (const GstVideoRectangle rect1,
-    const GstVideoRectangle rect2)
-{
-  if ((rect2.x <= rect1.x) && (rect2.y <= rect1.y) &&
-      ((rect2.x + rect2.w) >= (rect1.x + rect1.w)) &&
-      ((rect2.y + rect2.h) >= (rect1.y + rect1.h)))
-    return TRUE;
-  return FALSE;
-}
-
 static GstVideoRectangle
 clamp_rectangle (gint x, gint y, gint w, gint h, gint outer_width,
     gint outer_height)
@@ -454,17 +442,107 @@ clamp_rectangle (gint x, gint y, gint w, gint h, gint outer_width,
   return clamped;
 }
 
-/* Call this with the lock taken */
+/* A range of output lines [start, end) */
+struct LineBand
+{
+  guint start;
+  guint end;
+};
+
+static gint
+_int_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  gint val_a = *(const gint *) a, val_b = *(const gint *) b;
+
+  if (val_a < val_b)
+    return -1;
+  if (val_a > val_b)
+    return 1;
+  return 0;
+}
+
+/* Splits @rect into bands of lines at the top and bottom edges of
+ * @occluders, and stores the bands in which @rect is not completely covered
+ * by the union of @occluders in @visible, which must have space for
+ * 2 * @n_occluders + 1 bands. Returns the number of visible bands, 0 if @rect
+ * is completely hidden */
+static guint
+_rectangle_get_visible_bands (const GstVideoRectangle * rect,
+    const GstVideoRectangle * occluders, guint n_occluders,
+    struct LineBand *visible)
+{
+  gint *edges;
+  guint i, j, n_edges = 0, n_visible = 0;
+  gint rect_end = rect->y + rect->h;
+
+  if (rect->w <= 0 || rect->h <= 0)
+    return 0;
+
+  edges = g_newa (gint, 2 * n_occluders + 2);
+  edges[n_edges++] = rect->y;
+  edges[n_edges++] = rect_end;
+  for (i = 0; i < n_occluders; i++) {
+    gint top = occluders[i].y, bottom = occluders[i].y + occluders[i].h;
+
+    if (top > rect->y && top < rect_end)
+      edges[n_edges++] = top;
+    if (bottom > rect->y && bottom < rect_end)
+      edges[n_edges++] = bottom;
+  }
+
+  g_qsort_with_data (edges, n_edges, sizeof (gint), _int_compare, NULL);
+
+  for (i = 0; i + 1 < n_edges; i++) {
+    gint start = edges[i], end = edges[i + 1];
+    gint covered_until = rect->x;
+    gboolean progress = TRUE;
+
+    if (start == end)
+      continue;
+
+    /* The set of occluders spanning all lines of this band is constant, check
+     * if their union covers the band horizontally */
+    while (covered_until < rect->x + rect->w && progress) {
+      progress = FALSE;
+      for (j = 0; j < n_occluders; j++) {
+        const GstVideoRectangle *o = &occluders[j];
+
+        if (o->y <= start && o->y + o->h >= end && o->x <= covered_until
+            && o->x + o->w > covered_until) {
+          covered_until = o->x + o->w;
+          progress = TRUE;
+        }
+      }
+    }
+
+    if (covered_until >= rect->x + rect->w)
+      continue;
+
+    if (n_visible > 0 && (gint) visible[n_visible - 1].end == start) {
+      visible[n_visible - 1].end = end;
+    } else {
+      visible[n_visible].start = start;
+      visible[n_visible].end = end;
+      n_visible++;
+    }
+  }
+
+  return n_visible;
+}
+
+/* Returns %TRUE if @pad is going to cover its area of the output frame with
+ * opaque pixels, and stores that area in @rect.
+ *
+ * Call this with the lock taken */
 static gboolean
-_pad_obscures_rectangle (GstVideoAggregator * vagg, GstVideoAggregatorPad * pad,
-    const GstVideoRectangle rect)
+_pad_get_opaque_rectangle (GstVideoAggregator * vagg,
+    GstVideoAggregatorPad * pad, GstVideoRectangle * rect)
 {
-  GstVideoRectangle pad_rect;
   GstCompositorPad *cpad = GST_COMPOSITOR_PAD (pad);
   GstStructure *converter_config = NULL;
   gboolean fill_border = TRUE;
   guint32 border_argb = 0xff000000;
-  gint x_offset, y_offset;
+  gint width, height, x_offset, y_offset;
 
   /* No buffer to obscure the rectangle with */
   if (!gst_video_aggregator_pad_has_current_buffer (pad))
@@ -477,6 +555,11 @@ _pad_obscures_rectangle (GstVideoAggregator * vagg, GstVideoAggregatorPad * pad,
   if (cpad->alpha != 1.0 || GST_VIDEO_INFO_HAS_ALPHA (&pad->info))
     return FALSE;
 
+  /* Only the source and over operators replace what is below */
+  if (cpad->op != COMPOSITOR_OPERATOR_SOURCE
+      && cpad->op != COMPOSITOR_OPERATOR_OVER)
+    return FALSE;
+
   /* If a converter-config is set and it is either configured to not fill any
    * borders, or configured to use a non-opaque color, then we have to handle
    * the pad as potentially containing transparency */
@@ -491,23 +574,16 @@ _pad_obscures_rectangle (GstVideoAggregator * vagg, GstVideoAggregatorPad * pad,
   if (!fill_border || (border_argb & 0xff000000) != 0xff000000)
     return FALSE;
 
-  pad_rect.x = cpad->xpos;
-  pad_rect.y = cpad->ypos;
   /* Handle pixel and display aspect ratios to find the actual size */
   _mixer_pad_get_output_size (GST_COMPOSITOR (vagg), cpad,
       GST_VIDEO_INFO_PAR_N (&vagg->info), GST_VIDEO_INFO_PAR_D (&vagg->info),
-      &(pad_rect.w), &(pad_rect.h), &x_offset, &y_offset);
-  pad_rect.x += x_offset;
-  pad_rect.y += y_offset;
-
-  if (!is_rectangle_contained (rect, pad_rect))
-    return FALSE;
+      &width, &height, &x_offset, &y_offset);
 
-  GST_DEBUG_OBJECT (pad, "Pad %s %ix%i@(%i,%i) obscures rect %ix%i@(%i,%i)",
-      GST_PAD_NAME (pad), pad_rect.w, pad_rect.h, pad_rect.x, pad_rect.y,
-      rect.w, rect.h, rect.x, rect.y);
+  *rect = clamp_rectangle (cpad->xpos + x_offset, cpad->ypos + y_offset,
+      width, height, GST_VIDEO_INFO_WIDTH (&vagg->info),
+      GST_VIDEO_INFO_HEIGHT (&vagg->info));
 
-  return TRUE;
+  return rect->w > 0 && rect->h > 0;
 }
 
 static void
@@ -517,7 +593,9 @@ gst_compositor_pad_prepare_frame_start (GstVideoAggregatorPad * pad,
 {
   GstCompositorPad *cpad = GST_COMPOSITOR_PAD (pad);
   gint width, height;
-  gboolean frame_obscured = FALSE;
+  GstVideoRectangle *occluders;
+  guint n_occluders = 0;
+  struct LineBand *visible;
   GList *l;
   /* The rectangle representing this frame, clamped to the video's boundaries.
    * Due to the clamping, this is different from the frame width/height above. */
@@ -555,23 +633,26 @@ gst_compositor_pad_prepare_frame_start (GstVideoAggregatorPad * pad,
   }
 
   GST_OBJECT_LOCK (vagg);
-  /* Check if this frame is obscured by a higher-zorder frame
-   * TODO: Also skip a frame if it's obscured by a combination of
-   * higher-zorder frames */
+  /* Check if this frame is obscured by a combination of higher-zorder
+   * frames, in which case there's no need to convert it at all */
   l = g_list_find (GST_ELEMENT (vagg)->sinkpads, pad);
   /* The pad might've just been removed */
   if (l)
     l = l->next;
+  occluders = g_newa (GstVideoRectangle, g_list_length (l));
   for (; l; l = l->next) {
-    if (_pad_obscures_rectangle (vagg, l->data, frame_rect)) {
-      frame_obscured = TRUE;
-      break;
-    }
+    if (_pad_get_opaque_rectangle (vagg, l->data, &occluders[n_occluders]))
+      n_occluders++;
   }
   GST_OBJECT_UNLOCK (vagg);
 
-  if (frame_obscured)
+  visible = g_newa (struct LineBand, 2 * n_occluders + 1);
+  if (_rectangle_get_visible_bands (&frame_rect, occluders, n_occluders,
+          visible) == 0) {
+    GST_DEBUG_OBJECT (pad, "Frame %ix%i@(%i,%i) is obscured by higher pads",
+        frame_rect.w, frame_rect.h, frame_rect.x, frame_rect.y);
     return;
+  }
 
   GST_VIDEO_AGGREGATOR_PAD_CLASS
       (gst_compositor_pad_parent_class)->prepare_frame_start (pad, vagg, buffer,
@@ -622,6 +703,34 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_notify (GObject * object, GParamSpec * pspec)
+{
+  GstCompositorPad *cpad = GST_COMPOSITOR_PAD (object);
+
+  /* A different converter configuration changes the prepared frame even if
+   * the input buffer stays the same, so make sure the next output frame is
+   * not rendered incrementally */
+  if (g_strcmp0 (pspec->name, "converter-config") == 0) {
+    GST_OBJECT_LOCK (cpad);
+    cpad->last_index = -1;
+    GST_OBJECT_UNLOCK (cpad);
+  }
+
+  if (G_OBJECT_CLASS (gst_compositor_pad_parent_class)->notify)
+    G_OBJECT_CLASS (gst_compositor_pad_parent_class)->notify (object, pspec);
+}
+
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *cpad = GST_COMPOSITOR_PAD (object);
+
+  gst_clear_buffer (&cpad->last_buffer);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -633,6 +742,8 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->notify = gst_compositor_pad_notify;
+  gobject_class->finalize = gst_compositor_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -695,6 +806,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
   compo_pad->width = DEFAULT_PAD_WIDTH;
   compo_pad->height = DEFAULT_PAD_HEIGHT;
   compo_pad->sizing_policy = DEFAULT_PAD_SIZING_POLICY;
+  compo_pad->last_index = -1;
 }
 
 
@@ -702,6 +814,7 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
+#define DEFAULT_INCREMENTAL FALSE
 
 enum
 {
@@ -709,8 +822,12 @@ enum
   PROP_BACKGROUND,
   PROP_ZERO_SIZE_IS_UNSCALED,
   PROP_MAX_THREADS,
+  PROP_INCREMENTAL,
+  PROP_STATS,
 };
 
+static GstStructure *gst_compositor_get_stats (GstCompositor * self);
+
 static void
 gst_compositor_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
@@ -727,6 +844,14 @@ gst_compositor_get_property (GObject * object,
     case PROP_MAX_THREADS:
       g_value_set_uint (value, self->max_threads);
       break;
+    case PROP_INCREMENTAL:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->incremental);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_STATS:
+      g_value_take_boxed (value, gst_compositor_get_stats (self));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -741,7 +866,10 @@ gst_compositor_set_property (GObject * object,
 
   switch (prop_id) {
     case PROP_BACKGROUND:
+      GST_OBJECT_LOCK (self);
       self->background = g_value_get_enum (value);
+      self->layout_changed = TRUE;
+      GST_OBJECT_UNLOCK (self);
       break;
     case PROP_ZERO_SIZE_IS_UNSCALED:
       self->zero_size_is_unscaled = g_value_get_boolean (value);
@@ -749,6 +877,12 @@ gst_compositor_set_property (GObject * object,
     case PROP_MAX_THREADS:
       self->max_threads = g_value_get_uint (value);
       break;
+    case PROP_INCREMENTAL:
+      GST_OBJECT_LOCK (self);
+      self->incremental = g_value_get_boolean (value);
+      self->layout_changed = TRUE;
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1199,31 +1333,11 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
     gst_clear_object (&pool);
   }
 
-  return GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps);
-}
-
-static gboolean
-_should_draw_background (GstVideoAggregator * vagg)
-{
-  GstVideoRectangle bg_rect;
-  gboolean draw = TRUE;
-  GList *l;
-
-  bg_rect.x = bg_rect.y = 0;
+  GST_OBJECT_LOCK (compositor);
+  compositor->layout_changed = TRUE;
+  GST_OBJECT_UNLOCK (compositor);
 
-  GST_OBJECT_LOCK (vagg);
-  bg_rect.w = GST_VIDEO_INFO_WIDTH (&vagg->info);
-  bg_rect.h = GST_VIDEO_INFO_HEIGHT (&vagg->info);
-  /* Check if the background is completely obscured by a pad
-   * TODO: Also skip if it's obscured by a combination of pads */
-  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
-    if (_pad_obscures_rectangle (vagg, l->data, bg_rect)) {
-      draw = FALSE;
-      break;
-    }
-  }
-  GST_OBJECT_UNLOCK (vagg);
-  return draw;
+  return GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps);
 }
 
 static gboolean
@@ -1243,6 +1357,9 @@ struct CompositePadInfo
   GstVideoFrame *prepared_frame;
   GstCompositorPad *pad;
   GstCompositorBlendMode blend_mode;
+  /* The lines in which the pad is not hidden by higher opaque pads */
+  const struct LineBand *bands;
+  guint n_bands;
 };
 
 struct CompositeTask
@@ -1252,16 +1369,64 @@ struct CompositeTask
   guint dst_line_start;
   guint dst_line_end;
   gboolean draw_background;
+  const struct LineBand *bg_bands;
+  guint n_bg_bands;
   guint n_pads;
   struct CompositePadInfo *pads_info;
+
+  /* Only set when compositing incrementally: lines outside of the dirty
+   * bands are copied from @prev_frame, and @base_frame (if any) is copied
+   * into the dirty bands instead of drawing the background */
+  GstVideoFrame *prev_frame;
+  GstVideoFrame *base_frame;
+  guint n_dirty;
+  struct LineBand *dirty;
 };
 
+/* Copy the lines [y_start, y_end) of @src into @dest. Both frames must have
+ * the same format and size */
 static void
-_draw_background (GstCompositor * comp, GstVideoFrame * outframe,
-    guint y_start, guint y_end, BlendFunction * composite)
+_copy_lines (GstVideoFrame * dest, const GstVideoFrame * src, guint y_start,
+    guint y_end)
 {
-  *composite = comp->blend;
+  const GstVideoFormatInfo *info = dest->info.finfo;
+  guint i, plane, num_planes;
+
+  num_planes = GST_VIDEO_FRAME_N_PLANES (dest);
+  for (plane = 0; plane < num_planes; ++plane) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+    const guint8 *sdata;
+    guint8 *ddata;
+    gsize rowsize;
+    gint sstride, dstride;
+    guint start, end;
+
+    gst_video_format_info_component (info, plane, comp);
+    rowsize = GST_VIDEO_FRAME_COMP_WIDTH (dest, comp[0])
+        * GST_VIDEO_FRAME_COMP_PSTRIDE (dest, comp[0]);
+    /* A subsampled line belongs to the range containing its first line */
+    start = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (info, comp[0], y_start);
+    end = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (info, comp[0], y_end);
+
+    sstride = GST_VIDEO_FRAME_PLANE_STRIDE (src, plane);
+    dstride = GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane);
+    sdata = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (src, plane);
+    ddata = GST_VIDEO_FRAME_PLANE_DATA (dest, plane);
+    sdata += start * sstride;
+    ddata += start * dstride;
+
+    for (i = start; i < end; ++i) {
+      memcpy (ddata, sdata, rowsize);
+      sdata += sstride;
+      ddata += dstride;
+    }
+  }
+}
 
+static void
+_draw_background (GstCompositor * comp, GstVideoFrame * outframe,
+    guint y_start, guint y_end)
+{
   switch (comp->background) {
     case COMPOSITOR_BACKGROUND_CHECKER:
       comp->fill_checker (outframe, y_start, y_end);
@@ -1302,33 +1467,364 @@ _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
           pdata += plane_stride;
         }
       }
-      /* use overlay to keep background transparent */
-      *composite = comp->overlay;
       break;
     }
   }
 }
 
 static void
-blend_pads (struct CompositeTask *comp)
+_blend_lines (struct CompositeTask *comp, guint y_start, guint y_end)
 {
   BlendFunction composite;
-  guint i;
+  guint i, j;
 
   composite = comp->compositor->blend;
 
-  if (comp->draw_background) {
-    _draw_background (comp->compositor, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, &composite);
+  if (comp->base_frame) {
+    _copy_lines (comp->out_frame, comp->base_frame, y_start, y_end);
+  } else if (comp->draw_background) {
+    /* use overlay to keep background transparent */
+    if (comp->compositor->background == COMPOSITOR_BACKGROUND_TRANSPARENT)
+      composite = comp->compositor->overlay;
+
+    for (i = 0; i < comp->n_bg_bands; i++) {
+      guint start = MAX (comp->bg_bands[i].start, y_start);
+      guint end = MIN (comp->bg_bands[i].end, y_end);
+
+      if (start < end)
+        _draw_background (comp->compositor, comp->out_frame, start, end);
+    }
   }
 
   for (i = 0; i < comp->n_pads; i++) {
-    composite (comp->pads_info[i].prepared_frame,
-        comp->pads_info[i].pad->xpos + comp->pads_info[i].pad->x_offset,
-        comp->pads_info[i].pad->ypos + comp->pads_info[i].pad->y_offset,
-        comp->pads_info[i].pad->alpha, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, comp->pads_info[i].blend_mode);
+    struct CompositePadInfo *pad_info = &comp->pads_info[i];
+
+    for (j = 0; j < pad_info->n_bands; j++) {
+      guint start = MAX (pad_info->bands[j].start, y_start);
+      guint end = MIN (pad_info->bands[j].end, y_end);
+
+      if (start >= end)
+        continue;
+
+      composite (pad_info->prepared_frame,
+          pad_info->pad->xpos + pad_info->pad->x_offset,
+          pad_info->pad->ypos + pad_info->pad->y_offset,
+          pad_info->pad->alpha, comp->out_frame, start, end,
+          pad_info->blend_mode);
+    }
+  }
+}
+
+static void
+blend_pads (struct CompositeTask *comp)
+{
+  guint i, y;
+
+  if (!comp->prev_frame) {
+    _blend_lines (comp, comp->dst_line_start, comp->dst_line_end);
+    return;
   }
+
+  /* The dirty bands are sorted and don't overlap, everything in between is
+   * still valid in the previous output frame */
+  y = comp->dst_line_start;
+  for (i = 0; i < comp->n_dirty && y < comp->dst_line_end; i++) {
+    guint start = CLAMP (comp->dirty[i].start, y, comp->dst_line_end);
+    guint end = CLAMP (comp->dirty[i].end, y, comp->dst_line_end);
+
+    if (start > y)
+      _copy_lines (comp->out_frame, comp->prev_frame, y, start);
+    if (end > start)
+      _blend_lines (comp, start, end);
+    y = MAX (y, end);
+  }
+
+  if (y < comp->dst_line_end)
+    _copy_lines (comp->out_frame, comp->prev_frame, y, comp->dst_line_end);
+}
+
+/* Returns the area of the output frame @prepared_frame of @cpad is blended
+ * into */
+static GstVideoRectangle
+_pad_output_rectangle (GstVideoAggregator * vagg, GstCompositorPad * cpad,
+    const GstVideoFrame * prepared_frame)
+{
+  return clamp_rectangle (cpad->xpos + cpad->x_offset,
+      cpad->ypos + cpad->y_offset, GST_VIDEO_FRAME_WIDTH (prepared_frame),
+      GST_VIDEO_FRAME_HEIGHT (prepared_frame),
+      GST_VIDEO_INFO_WIDTH (&vagg->info), GST_VIDEO_INFO_HEIGHT (&vagg->info));
+}
+
+/* Whether @buffer is flagged as a repeat of @prev and shares all of its
+ * memory, in which case it has the same content */
+static gboolean
+_buffer_is_repeat_of (GstBuffer * buffer, GstBuffer * prev)
+{
+  guint i, n;
+
+  if (!prev || !GST_BUFFER_FLAG_IS_SET (buffer, GST_VIDEO_BUFFER_FLAG_REPEATED))
+    return FALSE;
+
+  n = gst_buffer_n_memory (buffer);
+  if (n != gst_buffer_n_memory (prev))
+    return FALSE;
+
+  for (i = 0; i < n; i++) {
+    if (gst_buffer_peek_memory (buffer, i) != gst_buffer_peek_memory (prev, i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Compares what @cpad contributes to the current output frame with what it
+ * contributed to the previous one and remembers the new state. Returns %TRUE
+ * if the layout changed, otherwise adds the lines covered by the pad to
+ * @dirty if its buffer changed.
+ *
+ * Call with the object lock taken */
+static gboolean
+_pad_update_incremental_state (GstVideoAggregator * vagg,
+    GstCompositorPad * cpad, gint index, const GstVideoFrame * prepared_frame,
+    struct LineBand *dirty, guint * n_dirty)
+{
+  GstBuffer *buffer = NULL;
+  GstVideoRectangle rect = { 0, 0, 0, 0 };
+  gboolean drawn = (prepared_frame != NULL);
+  gboolean changed;
+
+  if (drawn) {
+    buffer =
+        gst_video_aggregator_pad_get_current_buffer (GST_VIDEO_AGGREGATOR_PAD
+        (cpad));
+    rect = _pad_output_rectangle (vagg, cpad, prepared_frame);
+  }
+
+  changed = drawn != cpad->last_drawn || index != cpad->last_index;
+  if (!changed && drawn) {
+    changed = rect.x != cpad->last_rect.x || rect.y != cpad->last_rect.y
+        || rect.w != cpad->last_rect.w || rect.h != cpad->last_rect.h
+        || cpad->alpha != cpad->last_alpha || cpad->op != cpad->last_op;
+  }
+
+  /* We keep a reference to the last buffer so it can't be recycled and come
+   * back with different content, comparing pointers is hence enough. Repeats
+   * of the last buffer, e.g. from videorate, share its memory which can't be
+   * modified either while we keep it around */
+  if (!changed && drawn && buffer != cpad->last_buffer
+      && !_buffer_is_repeat_of (buffer, cpad->last_buffer) && rect.h > 0) {
+    dirty[*n_dirty].start = rect.y;
+    dirty[*n_dirty].end = rect.y + rect.h;
+    (*n_dirty)++;
+  }
+
+  cpad->last_drawn = drawn;
+  cpad->last_index = index;
+  cpad->last_rect = rect;
+  cpad->last_alpha = cpad->alpha;
+  cpad->last_op = cpad->op;
+  gst_buffer_replace (&cpad->last_buffer, buffer);
+
+  return changed;
+}
+
+static gint
+_line_band_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const struct LineBand *band_a = a, *band_b = b;
+
+  if (band_a->start < band_b->start)
+    return -1;
+  if (band_a->start > band_b->start)
+    return 1;
+  return 0;
+}
+
+/* Aligns the bands to @align lines so that subsampled lines are never
+ * shared between neighbouring bands, then sorts and merges them.
+ * Returns the new number of bands */
+static guint
+_line_bands_merge (struct LineBand *bands, guint n_bands, guint align,
+    guint height)
+{
+  guint i, n = 0;
+
+  if (n_bands == 0)
+    return 0;
+
+  for (i = 0; i < n_bands; i++) {
+    bands[i].start = GST_ROUND_DOWN_N (bands[i].start, align);
+    bands[i].end = MIN (GST_ROUND_UP_N (bands[i].end, align), height);
+  }
+
+  g_qsort_with_data (bands, n_bands, sizeof (struct LineBand),
+      _line_band_compare, NULL);
+
+  for (i = 1; i < n_bands; i++) {
+    if (bands[i].start <= bands[n].end) {
+      bands[n].end = MAX (bands[n].end, bands[i].end);
+    } else {
+      bands[++n] = bands[i];
+    }
+  }
+
+  return n + 1;
+}
+
+/* Number of lines that are in both @a and @b, the bands in each of them must
+ * not overlap */
+static guint
+_line_bands_count_overlap (const struct LineBand *a, guint n_a,
+    const struct LineBand *b, guint n_b)
+{
+  guint i, j, lines = 0;
+
+  for (i = 0; i < n_a; i++) {
+    for (j = 0; j < n_b; j++) {
+      guint start = MAX (a[i].start, b[j].start);
+      guint end = MIN (a[i].end, b[j].end);
+
+      if (end > start)
+        lines += end - start;
+    }
+  }
+
+  return lines;
+}
+
+static guint
+_line_alignment (const GstVideoInfo * info)
+{
+  guint i, h_sub = 0;
+
+  for (i = 0; i < GST_VIDEO_INFO_N_COMPONENTS (info); i++)
+    h_sub = MAX (h_sub, GST_VIDEO_FORMAT_INFO_H_SUB (info->finfo, i));
+
+  return 1 << h_sub;
+}
+
+/* Whether @pad is opaque, covers the whole output and its buffers can be
+ * used as output buffers without any conversion or scaling */
+static gboolean
+_pad_covers_output_unconverted (GstVideoAggregator * vagg,
+    GstVideoAggregatorPad * pad)
+{
+  GstCompositorPad *cpad = GST_COMPOSITOR_PAD (pad);
+  GstVideoInfo *out_info = &vagg->info;
+  GstVideoRectangle rect;
+  GstVideoMeta *meta;
+  GstBuffer *buffer;
+  gint width, height, x_offset, y_offset;
+  guint i;
+
+  if (!_pad_get_opaque_rectangle (vagg, pad, &rect))
+    return FALSE;
+
+  if (GST_VIDEO_INFO_FORMAT (&pad->info) != GST_VIDEO_INFO_FORMAT (out_info)
+      || GST_VIDEO_INFO_WIDTH (&pad->info) != GST_VIDEO_INFO_WIDTH (out_info)
+      || GST_VIDEO_INFO_HEIGHT (&pad->info) != GST_VIDEO_INFO_HEIGHT (out_info)
+      || GST_VIDEO_INFO_INTERLACE_MODE (&pad->info) !=
+      GST_VIDEO_INFO_INTERLACE_MODE (out_info)
+      || GST_VIDEO_INFO_CHROMA_SITE (&pad->info) !=
+      GST_VIDEO_INFO_CHROMA_SITE (out_info)
+      || !gst_video_colorimetry_is_equal (&GST_VIDEO_INFO_COLORIMETRY
+          (&pad->info), &GST_VIDEO_INFO_COLORIMETRY (out_info)))
+    return FALSE;
+
+  _mixer_pad_get_output_size (GST_COMPOSITOR (vagg), cpad,
+      GST_VIDEO_INFO_PAR_N (out_info), GST_VIDEO_INFO_PAR_D (out_info),
+      &width, &height, &x_offset, &y_offset);
+  if (cpad->xpos + x_offset != 0 || cpad->ypos + y_offset != 0
+      || width != GST_VIDEO_INFO_WIDTH (out_info)
+      || height != GST_VIDEO_INFO_HEIGHT (out_info))
+    return FALSE;
+
+  /* Downstream expects the memory layout of the output video info */
+  buffer = gst_video_aggregator_pad_get_current_buffer (pad);
+  if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_GAP)
+      && gst_buffer_get_size (buffer) == 0)
+    return FALSE;
+  meta = gst_buffer_get_video_meta (buffer);
+  if (meta) {
+    for (i = 0; i < meta->n_planes; i++) {
+      if (meta->offset[i] != GST_VIDEO_INFO_PLANE_OFFSET (out_info, i)
+          || meta->stride[i] != GST_VIDEO_INFO_PLANE_STRIDE (out_info, i))
+        return FALSE;
+    }
+  } else if (gst_buffer_get_size (buffer) < GST_VIDEO_INFO_SIZE (out_info)) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Returns the top-most pad with a buffer for the current output frame and
+ * whether it can be forwarded as the output buffer.
+ *
+ * Call with the object lock taken */
+static GstVideoAggregatorPad *
+_get_passthrough_pad (GstVideoAggregator * vagg)
+{
+  GList *l;
+
+  for (l = g_list_last (GST_ELEMENT (vagg)->sinkpads); l; l = l->prev) {
+    if (gst_video_aggregator_pad_has_current_buffer (l->data)) {
+      if (_pad_covers_output_unconverted (vagg, l->data))
+        return l->data;
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+static gboolean
+_remove_non_video_meta (GstBuffer * buffer, GstMeta ** meta,
+    gpointer user_data)
+{
+  if ((*meta)->info->api != GST_VIDEO_META_API_TYPE)
+    *meta = NULL;
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_compositor_create_output_buffer (GstVideoAggregator * vagg,
+    GstBuffer ** outbuf)
+{
+  GstCompositor *compositor = GST_COMPOSITOR (vagg);
+  GstVideoAggregatorPad *top;
+
+  /* The input buffers for this output frame are already selected here. If
+   * the top-most pad with a buffer hides everything below it and needs no
+   * conversion, its buffer is forwarded instead of rendering a new frame.
+   * This is checked for every output frame so that we switch back to
+   * blending as soon as the layout changes. The pad properties are only
+   * synced to the output time afterwards, so this is checked again in
+   * aggregate_frames(). The frames of all pads are still prepared as usual
+   * so that they can be blended if forwarding isn't possible anymore. */
+  GST_OBJECT_LOCK (vagg);
+  compositor->passthrough = FALSE;
+  top = _get_passthrough_pad (vagg);
+  if (top) {
+    GST_LOG_OBJECT (top, "Covers the whole output, forwarding its buffer");
+
+    /* Only copies the metadata, the memory is shared with the input buffer.
+     * The timestamps are set by the base class afterwards. */
+    *outbuf = gst_buffer_copy (gst_video_aggregator_pad_get_current_buffer
+        (top));
+    GST_BUFFER_DTS (*outbuf) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_OFFSET (*outbuf) = GST_BUFFER_OFFSET_NONE;
+    GST_BUFFER_OFFSET_END (*outbuf) = GST_BUFFER_OFFSET_NONE;
+    compositor->passthrough = TRUE;
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  if (compositor->passthrough)
+    return GST_FLOW_OK;
+
+  return GST_VIDEO_AGGREGATOR_CLASS (parent_class)->create_output_buffer (vagg,
+      outbuf);
 }
 
 static GstFlowReturn
@@ -1337,10 +1833,47 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   GstCompositor *compositor = GST_COMPOSITOR (vagg);
   GList *l;
   GstVideoFrame out_frame, *outframe;
+  GstVideoFrame prev_frame, *prevframe = NULL;
+  GstVideoFrame *base_frame = NULL;
   gboolean draw_background;
   guint drawn_a_pad = FALSE;
   struct CompositePadInfo *pads_info;
-  guint i, n_pads = 0;
+  struct LineBand full_band, *dirty = NULL;
+  struct LineBand *bands, *bg_bands, *next_bands;
+  GstVideoRectangle bg_rect, *opaque;
+  gint *opaque_index;
+  guint i, n_pads = 0, n_dirty = 0, n_opaque = 0, first_occluder = 0;
+  guint n_bg_bands, max_bands, align;
+  gboolean incremental, layout_changed, copy_base;
+  guint out_height, line_bytes, dirty_lines;
+  guint64 bytes_blended;
+  gint index;
+
+  GST_OBJECT_LOCK (vagg);
+  if (compositor->passthrough) {
+    /* @outbuf is the input buffer of the top-most pad already. The next
+     * rendered frame can't be based on the previous output anymore. */
+    compositor->passthrough = FALSE;
+    compositor->layout_changed = TRUE;
+    gst_clear_buffer (&compositor->prev_outbuf);
+
+    if (_get_passthrough_pad (vagg)) {
+      compositor->frames_passthrough++;
+      compositor->last_bytes_blended = 0;
+      compositor->last_bytes_copied = 0;
+      GST_OBJECT_UNLOCK (vagg);
+      return GST_FLOW_OK;
+    }
+
+    /* The synced pad properties don't allow forwarding the buffer anymore,
+     * render into it instead. Its memory is shared with the input buffer
+     * and gets copied when mapping it for writing below, only the metadata
+     * of the input buffer has to go. */
+    GST_LOG_OBJECT (vagg, "Pad properties changed, blending after all");
+    GST_BUFFER_FLAGS (outbuf) = 0;
+    gst_buffer_foreach_meta (outbuf, _remove_non_video_meta, NULL);
+  }
+  GST_OBJECT_UNLOCK (vagg);
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
     GST_WARNING_OBJECT (vagg, "Could not map output buffer");
@@ -1348,32 +1881,66 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   }
 
   outframe = &out_frame;
+  out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
+  align = _line_alignment (&vagg->info);
 
-  /* If one of the frames to be composited completely obscures the background,
-   * don't bother drawing the background at all. We can also always use the
-   * 'blend' BlendFunction in that case because it only changes if we have to
-   * overlay on top of a transparent background. */
-  draw_background = _should_draw_background (vagg);
+  full_band.start = 0;
+  full_band.end = out_height;
 
   GST_OBJECT_LOCK (vagg);
-  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+  opaque = g_newa (GstVideoRectangle, GST_ELEMENT (vagg)->numsinkpads);
+  opaque_index = g_newa (gint, GST_ELEMENT (vagg)->numsinkpads);
+  for (l = GST_ELEMENT (vagg)->sinkpads, index = 0; l; l = l->next, index++) {
     GstVideoAggregatorPad *pad = l->data;
     GstVideoFrame *prepared_frame =
         gst_video_aggregator_pad_get_prepared_frame (pad);
 
-    if (prepared_frame)
+    if (prepared_frame) {
       n_pads++;
+      if (_pad_get_opaque_rectangle (vagg, pad, &opaque[n_opaque])) {
+        opaque_index[n_opaque] = index;
+        n_opaque++;
+      }
+    }
   }
 
+  /* Every pad and the background can be split in at most that many visible
+   * bands by the opaque pads */
+  max_bands = 2 * n_opaque + 1;
+  bands = g_new (struct LineBand, (n_pads + 1) * max_bands);
+
   pads_info = g_newa (struct CompositePadInfo, n_pads);
   n_pads = 0;
 
-  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+  /* Only draw the background in the lines where it's not completely hidden
+   * by opaque pads. If there are none left, don't bother drawing the
+   * background at all. We can also always use the 'blend' BlendFunction in
+   * that case because it only changes if we have to overlay on top of a
+   * transparent background. */
+  bg_rect.x = bg_rect.y = 0;
+  bg_rect.w = GST_VIDEO_INFO_WIDTH (&vagg->info);
+  bg_rect.h = out_height;
+  bg_bands = bands;
+  n_bg_bands = _rectangle_get_visible_bands (&bg_rect, opaque, n_opaque,
+      bg_bands);
+  n_bg_bands = _line_bands_merge (bg_bands, n_bg_bands, align, out_height);
+  draw_background = n_bg_bands > 0;
+  next_bands = bands + max_bands;
+
+  incremental = compositor->incremental;
+  layout_changed = compositor->layout_changed || !compositor->prev_outbuf
+      || draw_background != compositor->last_draw_background;
+  if (incremental)
+    dirty = g_newa (struct LineBand, GST_ELEMENT (vagg)->numsinkpads + 1);
+
+  for (l = GST_ELEMENT (vagg)->sinkpads, index = 0; l; l = l->next, index++) {
     GstVideoAggregatorPad *pad = l->data;
     GstCompositorPad *compo_pad = GST_COMPOSITOR_PAD (pad);
     GstVideoFrame *prepared_frame =
         gst_video_aggregator_pad_get_prepared_frame (pad);
     GstCompositorBlendMode blend_mode = COMPOSITOR_BLEND_MODE_OVER;
+    GstVideoRectangle rect;
+    guint n_bands;
 
     switch (compo_pad->op) {
       case COMPOSITOR_OPERATOR_SOURCE:
@@ -1390,27 +1957,109 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
         break;
     }
 
-    if (prepared_frame != NULL) {
-      /* If this is the first pad we're drawing, and we didn't draw the
-       * background, and @prepared_frame has the same format, height, and width
-       * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
-       * will be composited on top of it. */
-      if (!drawn_a_pad && !draw_background &&
-          frames_can_copy (prepared_frame, outframe)) {
-        gst_video_frame_copy (outframe, prepared_frame);
-      } else {
-        pads_info[n_pads].pad = compo_pad;
-        pads_info[n_pads].prepared_frame = prepared_frame;
-        pads_info[n_pads].blend_mode = blend_mode;
-        n_pads++;
-      }
-      drawn_a_pad = TRUE;
+    if (incremental) {
+      if (_pad_update_incremental_state (vagg, compo_pad, index,
+              prepared_frame, dirty, &n_dirty))
+        layout_changed = TRUE;
+    } else {
+      gst_clear_buffer (&compo_pad->last_buffer);
+    }
+
+    if (prepared_frame == NULL)
+      continue;
+
+    /* Only the opaque pads above this one can hide it */
+    while (first_occluder < n_opaque && opaque_index[first_occluder] <= index)
+      first_occluder++;
+
+    rect = _pad_output_rectangle (vagg, compo_pad, prepared_frame);
+    n_bands = _rectangle_get_visible_bands (&rect, opaque + first_occluder,
+        n_opaque - first_occluder, next_bands);
+    n_bands = _line_bands_merge (next_bands, n_bands, align, out_height);
+    if (n_bands == 0) {
+      GST_LOG_OBJECT (pad, "Completely hidden by higher pads, not blending");
+      continue;
+    }
+
+    /* If this is the first pad we're drawing, and we didn't draw the
+     * background, and @prepared_frame has the same format, height, and width
+     * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
+     * will be composited on top of it. */
+    if (!drawn_a_pad && !draw_background &&
+        frames_can_copy (prepared_frame, outframe)) {
+      base_frame = prepared_frame;
+    } else {
+      pads_info[n_pads].pad = compo_pad;
+      pads_info[n_pads].prepared_frame = prepared_frame;
+      pads_info[n_pads].blend_mode = blend_mode;
+      pads_info[n_pads].bands = next_bands;
+      pads_info[n_pads].n_bands = n_bands;
+      next_bands += max_bands;
+      n_pads++;
+    }
+    drawn_a_pad = TRUE;
+  }
+
+  if (incremental) {
+    /* Only the lines covered by pads with a new buffer have to be rendered
+     * again if nothing else changed since the previous output frame */
+    if (!layout_changed && gst_video_frame_map (&prev_frame, &vagg->info,
+            compositor->prev_outbuf, GST_MAP_READ)) {
+      prevframe = &prev_frame;
+      n_dirty = _line_bands_merge (dirty, n_dirty, align, out_height);
+    }
+    compositor->layout_changed = FALSE;
+    compositor->last_draw_background = draw_background;
+  } else {
+    gst_clear_buffer (&compositor->prev_outbuf);
+  }
+
+  copy_base = base_frame != NULL;
+  if (!prevframe) {
+    dirty = &full_band;
+    n_dirty = 1;
+
+    if (base_frame) {
+      gst_video_frame_copy (outframe, base_frame);
+      base_frame = NULL;
     }
   }
 
+  /* Approximate the amount of output data that is rendered and copied, with
+   * the bytes per line averaged over all planes */
+  line_bytes = GST_VIDEO_INFO_SIZE (&vagg->info) / MAX (out_height, 1);
+  dirty_lines = _line_bands_count_overlap (dirty, n_dirty, &full_band, 1);
+  bytes_blended = 0;
+  if (copy_base) {
+    bytes_blended += (guint64) dirty_lines * line_bytes;
+  } else if (draw_background) {
+    bytes_blended += (guint64) _line_bands_count_overlap (dirty, n_dirty,
+        bg_bands, n_bg_bands) * line_bytes;
+  }
+  for (i = 0; i < n_pads; i++) {
+    GstVideoRectangle rect = _pad_output_rectangle (vagg, pads_info[i].pad,
+        pads_info[i].prepared_frame);
+    guint lines = _line_bands_count_overlap (dirty, n_dirty,
+        pads_info[i].bands, pads_info[i].n_bands);
+
+    bytes_blended += gst_util_uint64_scale_int ((guint64) lines * line_bytes,
+        rect.w, MAX (GST_VIDEO_FRAME_WIDTH (outframe), 1));
+  }
+  compositor->last_bytes_blended = bytes_blended;
+  compositor->last_bytes_copied =
+      (guint64) (out_height - dirty_lines) * line_bytes;
+  if (!prevframe)
+    compositor->frames_full++;
+  else if (n_dirty > 0)
+    compositor->frames_incremental++;
+  else
+    compositor->frames_unchanged++;
+
+  GST_LOG_OBJECT (vagg, "Rendering %u of %u lines in %u bands, background "
+      "visible in %u bands", dirty_lines, out_height, n_dirty, n_bg_bands);
+
   {
     guint n_threads, lines_per_thread;
-    guint out_height;
     struct CompositeTask *tasks;
     struct CompositeTask **tasks_p;
 
@@ -1419,8 +2068,10 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     tasks = g_newa (struct CompositeTask, n_threads);
     tasks_p = g_newa (struct CompositeTask *, n_threads);
 
-    out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
     lines_per_thread = (out_height + n_threads - 1) / n_threads;
+    /* Never split subsampled lines between threads, they would be blended
+     * twice otherwise */
+    lines_per_thread = GST_ROUND_UP_N (lines_per_thread, align);
 
     for (i = 0; i < n_threads; i++) {
       tasks[i].compositor = compositor;
@@ -1428,12 +2079,18 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
       tasks[i].pads_info = pads_info;
       tasks[i].out_frame = outframe;
       tasks[i].draw_background = draw_background;
+      tasks[i].bg_bands = bg_bands;
+      tasks[i].n_bg_bands = n_bg_bands;
       /* This is a dumb split of the work by number of output lines.
        * If there is a section of the output that reads from a lot of source
        * pads, then that thread will consume more time. Maybe tracking and
        * splitting on the source fill rate would produce better results. */
-      tasks[i].dst_line_start = i * lines_per_thread;
+      tasks[i].dst_line_start = MIN (i * lines_per_thread, out_height);
       tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
+      tasks[i].prev_frame = prevframe;
+      tasks[i].base_frame = base_frame;
+      tasks[i].n_dirty = n_dirty;
+      tasks[i].dirty = dirty;
 
       tasks_p[i] = &tasks[i];
     }
@@ -1442,13 +2099,38 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
         (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
   }
 
+  if (prevframe)
+    gst_video_frame_unmap (prevframe);
+  if (incremental)
+    gst_buffer_replace (&compositor->prev_outbuf, outbuf);
+
   GST_OBJECT_UNLOCK (vagg);
 
+  g_free (bands);
+
   gst_video_frame_unmap (outframe);
 
   return GST_FLOW_OK;
 }
 
+static GstStructure *
+gst_compositor_get_stats (GstCompositor * self)
+{
+  GstStructure *s;
+
+  GST_OBJECT_LOCK (self);
+  s = gst_structure_new ("application/x-compositor-stats",
+      "frames-full", G_TYPE_UINT64, self->frames_full,
+      "frames-incremental", G_TYPE_UINT64, self->frames_incremental,
+      "frames-unchanged", G_TYPE_UINT64, self->frames_unchanged,
+      "frames-passthrough", G_TYPE_UINT64, self->frames_passthrough,
+      "last-bytes-blended", G_TYPE_UINT64, self->last_bytes_blended,
+      "last-bytes-copied", G_TYPE_UINT64, self->last_bytes_copied, NULL);
+  GST_OBJECT_UNLOCK (self);
+
+  return s;
+}
+
 static GstPad *
 gst_compositor_request_new_pad (GstElement * element, GstPadTemplate * templ,
     const gchar * req_name, const GstCaps * caps)
@@ -1462,6 +2144,10 @@ gst_compositor_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (newpad == NULL)
     goto could_not_create;
 
+  GST_OBJECT_LOCK (element);
+  GST_COMPOSITOR (element)->layout_changed = TRUE;
+  GST_OBJECT_UNLOCK (element);
+
   gst_child_proxy_child_added (GST_CHILD_PROXY (element), G_OBJECT (newpad),
       GST_OBJECT_NAME (newpad));
 
@@ -1486,6 +2172,10 @@ gst_compositor_release_pad (GstElement * element, GstPad * pad)
   gst_child_proxy_child_removed (GST_CHILD_PROXY (compositor), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
+  GST_OBJECT_LOCK (compositor);
+  compositor->layout_changed = TRUE;
+  GST_OBJECT_UNLOCK (compositor);
+
   GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
 }
 
@@ -1531,11 +2221,33 @@ _sink_query (GstAggregator * agg, GstAggregatorPad * bpad, GstQuery * query)
   }
 }
 
+static gboolean
+_stop (GstAggregator * agg)
+{
+  GstCompositor *compositor = GST_COMPOSITOR (agg);
+  GList *l;
+
+  GST_OBJECT_LOCK (compositor);
+  gst_clear_buffer (&compositor->prev_outbuf);
+  compositor->layout_changed = TRUE;
+  for (l = GST_ELEMENT (compositor)->sinkpads; l; l = l->next) {
+    GstCompositorPad *cpad = l->data;
+
+    gst_clear_buffer (&cpad->last_buffer);
+    cpad->last_index = -1;
+  }
+  GST_OBJECT_UNLOCK (compositor);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
+}
+
 static void
 gst_compositor_finalize (GObject * object)
 {
   GstCompositor *compositor = GST_COMPOSITOR (object);
 
+  gst_clear_buffer (&compositor->prev_outbuf);
+
   if (compositor->blend_runner)
     gst_parallelized_task_runner_free (compositor->blend_runner);
   compositor->blend_runner = NULL;
@@ -1564,7 +2276,10 @@ gst_compositor_class_init (GstCompositorClass * klass)
   agg_class->sink_query = _sink_query;
   agg_class->fixate_src_caps = _fixate_caps;
   agg_class->negotiated_src_caps = _negotiated_caps;
+  agg_class->stop = _stop;
   videoaggregator_class->aggregate_frames = gst_compositor_aggregate_frames;
+  videoaggregator_class->create_output_buffer =
+      gst_compositor_create_output_buffer;
 
   g_object_class_install_property (gobject_class, PROP_BACKGROUND,
       g_param_spec_enum ("background", "Background", "Background type",
@@ -1601,6 +2316,51 @@ gst_compositor_class_init (GstCompositorClass * klass)
           GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * compositor:incremental:
+   *
+   * Keep the previous output frame around and only re-render the lines
+   * covered by pads whose buffer changed since then, e.g. because of repeated
+   * buffers for static content. Everything else is copied from the previous
+   * output frame. A full frame is rendered whenever the background, the pads
+   * or their position, size, alpha, operator or zorder change.
+   *
+   * As a reference to the previous output buffer is kept, output buffers are
+   * not writable downstream.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_INCREMENTAL,
+      g_param_spec_boolean ("incremental", "Incremental",
+          "Only re-render the parts of the output that changed since the "
+          "previous output frame", DEFAULT_INCREMENTAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * compositor:stats:
+   *
+   * Various statistics. This property returns a #GstStructure
+   * with name application/x-compositor-stats with the following fields:
+   *
+   * * #guint64 `frames-full`: the number of fully rendered output frames.
+   * * #guint64 `frames-incremental`: the number of output frames for which
+   *   only the changed lines were rendered.
+   * * #guint64 `frames-unchanged`: the number of output frames that were
+   *   copied from the previous one.
+   * * #guint64 `frames-passthrough`: the number of output frames for which
+   *   the input buffer of a single opaque pad covering the whole output was
+   *   forwarded unchanged.
+   * * #guint64 `last-bytes-blended`: the approximate number of bytes rendered
+   *   by background filling and blending for the last output frame.
+   * * #guint64 `last-bytes-copied`: the approximate number of bytes copied
+   *   from the previous output frame for the last output frame.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics", "Various statistics",
+          GST_TYPE_STRUCTURE, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &src_factory, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -1623,6 +2383,8 @@ gst_compositor_init (GstCompositor * self)
   self->background = DEFAULT_BACKGROUND;
   self->zero_size_is_unscaled = DEFAULT_ZERO_SIZE_IS_UNSCALED;
   self->max_threads = DEFAULT_MAX_THREADS;
+  self->incremental = DEFAULT_INCREMENTAL;
+  self->layout_changed = TRUE;
 }
 
 /* GstChildProxy implementation */
@@ -145,6 +145,26 @@ struct _GstCompositor
   FillColorFunction fill_color;
 
   GstParallelizedTaskRunner *blend_runner;
+
+  /* Incremental compositing: if enabled, the previous output buffer is kept
+   * around and only the lines covered by pads whose buffer changed are
+   * re-rendered as long as the layout stays the same */
+  gboolean incremental;
+  gboolean layout_changed;
+  gboolean last_draw_background;
+  GstBuffer *prev_outbuf;
+
+  /* Set while the input buffer of a single pad that covers the whole output
+   * is forwarded as-is instead of rendering a new frame */
+  gboolean passthrough;
+
+  /* statistics, protected by the object lock */
+  guint64 frames_full;
+  guint64 frames_incremental;
+  guint64 frames_unchanged;
+  guint64 frames_passthrough;
+  guint64 last_bytes_blended;
+  guint64 last_bytes_copied;
 };
 
 /**
@@ -168,6 +188,15 @@ struct _GstCompositorPad
    * keep-aspect-ratio */
   gint x_offset;
   gint y_offset;
+
+  /* What this pad contributed to the previous output frame, used for
+   * incremental compositing */
+  GstBuffer *last_buffer;
+  GstVideoRectangle last_rect;
+  gdouble last_alpha;
+  GstCompositorOperator last_op;
+  gint last_index;
+  gboolean last_drawn;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (compositor);
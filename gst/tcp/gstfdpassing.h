@@ -0,0 +1,64 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FD_PASSING_H__
+#define __GST_FD_PASSING_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Wire format of the fd-passing mode of multisocketsink and socketsrc.
+ *
+ * Every buffer is sent as a fixed size GstFdPassingHeader followed by the
+ * data of the memories that are sent inline, in order. The file descriptors
+ * of the other memories are passed as SCM_RIGHTS ancillary data along with
+ * the header. Both ends are on the same host so the header is in host byte
+ * order. */
+
+#define GST_FD_PASSING_MAGIC            0x47534644      /* "GSFD" */
+#define GST_FD_PASSING_MAX_MEMORIES     16
+#define GST_FD_PASSING_INLINE           G_MAXUINT32
+/* the receiver refuses buffers with more inline data than this */
+#define GST_FD_PASSING_MAX_INLINE_SIZE  (256 * 1024 * 1024)
+
+typedef struct {
+  /* index in the passed file descriptors, or GST_FD_PASSING_INLINE */
+  guint32 fd_index;
+  guint32 reserved;
+  /* offset of the data in the file, 0 for inline data */
+  guint64 offset;
+  guint64 size;
+} GstFdPassingMemory;
+
+typedef struct {
+  guint32 magic;
+  guint32 n_memories;
+  guint64 pts;
+  guint64 dts;
+  guint64 duration;
+  guint64 offset;
+  guint64 offset_end;
+  guint32 flags;
+  guint32 reserved;
+  GstFdPassingMemory memories[GST_FD_PASSING_MAX_MEMORIES];
+} GstFdPassingHeader;
+
+G_END_DECLS
+
+#endif /* __GST_FD_PASSING_H__ */
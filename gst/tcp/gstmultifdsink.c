@@ -811,8 +811,8 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
-        mhclient->last_activity_time = now;
-        mhclient->last_activity_time_monotonic = now_monotonic;
+        gst_multi_handle_sink_client_activity (mhsink, mhclient, now,
+            now_monotonic);
         mhsink->bytes_served += wrote;
       }
     }
@@ -881,6 +881,7 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
   gboolean try_again;
   GstMultiFdSinkClass *fclass;
   guint cookie;
+  GstClockTime wait;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   int fd;
 
@@ -896,9 +897,26 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
      * - client socket output (ie, client reads)          */
     GST_LOG_OBJECT (sink, "waiting on action on fdset");
 
-    result =
-        gst_poll_wait (sink->fdset,
-        mhsink->timeout != 0 ? mhsink->timeout : GST_CLOCK_TIME_NONE);
+    /* wake up when the least recently active client times out, or check
+     * again after a full timeout when there is no client yet */
+    wait = GST_CLOCK_TIME_NONE;
+    if (mhsink->timeout != 0) {
+      GstClockTime deadline, now;
+
+      CLIENTS_LOCK (mhsink);
+      deadline = gst_multi_handle_sink_next_timeout (mhsink);
+      CLIENTS_UNLOCK (mhsink);
+
+      now = g_get_monotonic_time () * GST_USECOND;
+      if (deadline == GST_CLOCK_TIME_NONE)
+        wait = mhsink->timeout;
+      else if (deadline > now)
+        wait = deadline - now + GST_MSECOND;
+      else
+        wait = 0;
+    }
+
+    result = gst_poll_wait (sink->fdset, wait);
 
     /* Handle the special case in which the sink is not receiving more buffers
      * and will not disconnect inactive client in the streaming thread. */
@@ -908,19 +926,7 @@ gst_multi_fd_sink_handle_clients (GstMultiFdSink * sink)
       now = g_get_monotonic_time () * GST_USECOND;
 
       CLIENTS_LOCK (mhsink);
-      for (clients = mhsink->clients; clients; clients = next) {
-        GstTCPClient *client;
-        GstMultiHandleClient *mhclient;
-
-        client = (GstTCPClient *) clients->data;
-        mhclient = (GstMultiHandleClient *) client;
-        next = g_list_next (clients);
-        if (mhsink->timeout > 0
-            && now - mhclient->last_activity_time_monotonic > mhsink->timeout) {
-          mhclient->status = GST_CLIENT_STATUS_SLOW;
-          gst_multi_handle_sink_remove_client_link (mhsink, clients);
-        }
-      }
+      gst_multi_handle_sink_remove_timed_out (mhsink, now);
       CLIENTS_UNLOCK (mhsink);
       return;
     } else if (result < 0) {
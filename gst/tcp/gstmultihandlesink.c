@@ -420,7 +420,10 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   GST_OBJECT_FLAG_UNSET (this, GST_MULTI_HANDLE_SINK_OPEN);
 
   CLIENTS_LOCK_INIT (this);
+  g_mutex_init (&this->writing_lock);
+  g_cond_init (&this->writing_cond);
   this->clients = NULL;
+  g_queue_init (&this->activity);
 
   this->bufqueue = g_array_new (FALSE, TRUE, sizeof (GstBuffer *));
   this->unit_format = DEFAULT_UNIT_FORMAT;
@@ -450,6 +453,8 @@ gst_multi_handle_sink_finalize (GObject * object)
   this = GST_MULTI_HANDLE_SINK (object);
 
   CLIENTS_LOCK_CLEAR (this);
+  g_mutex_clear (&this->writing_lock);
+  g_cond_clear (&this->writing_cond);
   g_array_free (this->bufqueue, TRUE);
   g_hash_table_destroy (this->handle_hash);
 
@@ -540,6 +545,8 @@ gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
   client->new_connection = TRUE;
   client->sync_method = sync_method;
   client->currently_removing = FALSE;
+  client->activity_link.data = client;
+  client->activity_link.prev = client->activity_link.next = NULL;
 
   /* update start time */
   client->connect_time = g_get_real_time () * GST_USECOND;
@@ -551,6 +558,86 @@ gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
   client->last_activity_time_monotonic = client->connect_time_monotonic;
 }
 
+/* Updates the last activity time of @client and moves it to the end of the
+ * activity queue, which keeps the queue sorted by last activity so that only
+ * the clients at its head can have timed out. Must be called with the clients
+ * lock held. */
+void
+gst_multi_handle_sink_client_activity (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, guint64 now, guint64 now_monotonic)
+{
+  client->last_activity_time = now;
+  client->last_activity_time_monotonic = now_monotonic;
+
+  /* clients being removed are not in the queue anymore */
+  if (client->currently_removing ||
+      sink->activity.tail == &client->activity_link)
+    return;
+
+  g_queue_unlink (&sink->activity, &client->activity_link);
+  g_queue_push_tail_link (&sink->activity, &client->activity_link);
+}
+
+/* Returns the monotonic time at which the least recently active client times
+ * out, or GST_CLOCK_TIME_NONE when there is no timeout or no client. Must be
+ * called with the clients lock held. */
+GstClockTime
+gst_multi_handle_sink_next_timeout (GstMultiHandleSink * sink)
+{
+  GstMultiHandleClient *mhclient;
+
+  if (sink->timeout == 0 || sink->activity.head == NULL)
+    return GST_CLOCK_TIME_NONE;
+
+  mhclient = sink->activity.head->data;
+
+  return mhclient->last_activity_time_monotonic + sink->timeout;
+}
+
+/* Removes the clients that have been inactive for longer than the timeout at
+ * the monotonic time @now. Only the clients that timed out and the next one
+ * in the activity queue are looked at. Must be called with the clients lock
+ * held. Returns TRUE when clients were removed. */
+gboolean
+gst_multi_handle_sink_remove_timed_out (GstMultiHandleSink * sink,
+    GstClockTime now)
+{
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+  gboolean removed = FALSE;
+
+  if (sink->timeout == 0)
+    return FALSE;
+
+  /* removing a client releases the lock, so always look at the current head
+   * of the queue */
+  while (sink->activity.head) {
+    GstMultiHandleClient *mhclient = sink->activity.head->data;
+    GList *clink;
+
+    if (mhclient->last_activity_time_monotonic + sink->timeout >= now)
+      break;
+
+    GST_WARNING_OBJECT (sink, "%s client %p timed out, removing",
+        mhclient->debug, mhclient);
+
+    mhclient->status = GST_CLIENT_STATUS_SLOW;
+    /* set client to invalid position while being removed */
+    mhclient->bufpos = -1;
+
+    clink = g_hash_table_lookup (sink->handle_hash,
+        mhsinkclass->handle_hash_key (mhclient->handle));
+    if (G_UNLIKELY (clink == NULL)) {
+      /* can't happen, make sure we don't look at this client again */
+      g_queue_unlink (&sink->activity, &mhclient->activity_link);
+      continue;
+    }
+    gst_multi_handle_sink_remove_client_link (sink, clink);
+    removed = TRUE;
+  }
+
+  return removed;
+}
+
 static void
 gst_multi_handle_sink_setup_dscp (GstMultiHandleSink * mhsink)
 {
@@ -616,6 +703,8 @@ gst_multi_handle_sink_add_full (GstMultiHandleSink * sink,
   g_hash_table_insert (mhsink->handle_hash,
       mhsinkclass->handle_hash_key (mhclient->handle), clink);
   mhsink->clients_cookie++;
+  /* the new client is the most recently active one */
+  g_queue_push_tail_link (&mhsink->activity, &mhclient->activity_link);
 
 
   mhclient->burst_min_format = min_format;
@@ -846,6 +935,22 @@ noclient:
   return result;
 }
 
+/* Marks @client as being written to by an I/O thread that releases the
+ * clients lock during the write, see
+ * gst_multi_handle_sink_remove_client_link().
+ *
+ * Call with the clientslock held */
+void
+gst_multi_handle_sink_client_set_writing (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client, gboolean writing)
+{
+  g_mutex_lock (&sink->writing_lock);
+  client->writing = writing;
+  if (!writing)
+    g_cond_broadcast (&sink->writing_cond);
+  g_mutex_unlock (&sink->writing_lock);
+}
+
 /* should be called with the clientslock held.
  * Note that we don't close the fd as we didn't open it in the first
  * place. An application should connect to the client-fd-removed signal and
@@ -866,6 +971,20 @@ gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
     mhclient->currently_removing = TRUE;
   }
 
+  /* an I/O thread of the subclass might be writing to the client without
+   * holding the lock, wait until it notices that the client is removed */
+  while (mhclient->writing) {
+    CLIENTS_UNLOCK (sink);
+    g_mutex_lock (&sink->writing_lock);
+    while (mhclient->writing)
+      g_cond_wait (&sink->writing_cond, &sink->writing_lock);
+    g_mutex_unlock (&sink->writing_lock);
+    CLIENTS_LOCK (sink);
+  }
+
+  /* can't time out anymore */
+  g_queue_unlink (&sink->activity, &mhclient->activity_link);
+
   /* FIXME: if we keep track of ip we can log it here and signal */
   switch (mhclient->status) {
     case GST_CLIENT_STATUS_OK:
@@ -1665,6 +1784,11 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   max_buffer_usage = 0;
   now = g_get_monotonic_time () * GST_USECOND;
 
+  /* remove the clients that were idle for too long first, this only needs to
+   * look at the least recently active ones */
+  if (gst_multi_handle_sink_remove_timed_out (mhsink, now))
+    hash_changed = TRUE;
+
   /* now check for new or slow clients */
 restart:
   cookie = mhsink->clients_cookie;
@@ -1678,11 +1802,8 @@ restart:
 
     next = g_list_next (clients);
 
-    /* check hard max and timeout, remove client */
-    if ((max_buffers > 0 && mhclient->bufpos >= max_buffers) ||
-        (mhsink->timeout > 0
-            && now - mhclient->last_activity_time_monotonic >
-            mhsink->timeout)) {
+    /* check hard max, remove client */
+    if (max_buffers > 0 && mhclient->bufpos >= max_buffers) {
       /* remove client */
       GST_WARNING_OBJECT (sink, "%s client %p is too slow, removing",
           mhclient->debug, mhclient);
@@ -149,6 +149,9 @@ typedef struct {
 
   gboolean new_connection;
   gboolean currently_removing;
+  gboolean writing;             /* being written to without the clients lock */
+
+  GList activity_link;          /* link in the activity queue of the sink */
 
 
   /* method to sync client when connecting */
@@ -197,10 +200,13 @@ struct _GstMultiHandleSink {
   guint64 bytes_served; /* how much bytes have we served */
 
   GRecMutex clientslock;  /* lock to protect the clients list */
+  GMutex writing_lock;    /* protects the writing flag of the clients */
+  GCond writing_cond;     /* signalled when a client is not written anymore */
   GList *clients;       /* list of clients we are serving */
   guint clients_cookie; /* Cookie to detect changes to the clients list */
 
   GHashTable *handle_hash;  /* index of handle -> GstMultiHandleClient */
+  GQueue activity;          /* clients by last activity, least recent first */
 
   GMainContext *main_context;
   GCancellable *cancellable;
@@ -289,6 +295,10 @@ void gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
     GList * link);
 
 void gst_multi_handle_sink_client_init (GstMultiHandleClient * client, GstSyncMethod sync_method);
+void gst_multi_handle_sink_client_set_writing (GstMultiHandleSink * sink, GstMultiHandleClient * client, gboolean writing);
+void gst_multi_handle_sink_client_activity (GstMultiHandleSink * sink, GstMultiHandleClient * client, guint64 now, guint64 now_monotonic);
+GstClockTime gst_multi_handle_sink_next_timeout (GstMultiHandleSink * sink);
+gboolean gst_multi_handle_sink_remove_timed_out (GstMultiHandleSink * sink, GstClockTime now);
 
 #define GST_TYPE_RECOVER_POLICY (gst_multi_handle_sink_recover_policy_get_type())
 GType gst_multi_handle_sink_recover_policy_get_type (void);
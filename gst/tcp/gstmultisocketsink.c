@@ -97,6 +97,13 @@
  * buffers to the clients. This behaviour can be disabled by setting the sync
  * property to FALSE. Multisocketsink will by default not do QoS and will never
  * drop late buffers.
+ *
+ * With the #GstMultiSocketSink:fd-passing property, buffers are sent with a
+ * small header describing their memories and metadata. Memories backed by a
+ * file descriptor, like memfd or dmabuf memory, are not copied but their file
+ * descriptor is passed to clients connected over a UNIX domain socket. A
+ * #socketsrc with the same property set receives these buffers. This allows
+ * to share raw video between processes without copying it.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -105,10 +112,16 @@
 
 #include <gst/gst-i18n-plugin.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/allocators.h>
 
 #include <string.h>
 
+#ifdef HAVE_GIO_UNIX_2_0
+#include <gio/gunixfdmessage.h>
+#endif
+
 #include "gstmultisocketsink.h"
+#include "gstfdpassing.h"
 #include "gsttcpelements.h"
 
 #ifndef G_OS_WIN32
@@ -140,12 +153,16 @@ enum
 
 #define DEFAULT_SEND_DISPATCHED FALSE
 #define DEFAULT_SEND_MESSAGES   FALSE
+#define DEFAULT_FD_PASSING      FALSE
+#define DEFAULT_N_THREADS       1
 
 enum
 {
   PROP_0,
   PROP_SEND_DISPATCHED,
   PROP_SEND_MESSAGES,
+  PROP_FD_PASSING,
+  PROP_N_THREADS,
   PROP_LAST
 };
 
@@ -212,6 +229,8 @@ GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (multisocketsink, "multisocketsink",
 
 static guint gst_multi_socket_sink_signals[LAST_SIGNAL] = { 0 };
 
+static GQuark fd_passing_quark;
+
 static void
 gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
 {
@@ -264,6 +283,39 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
           "If GstNetworkMessage events should be pushed", DEFAULT_SEND_MESSAGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiSocketSink:fd-passing:
+   *
+   * Send buffers with a header describing their memories and metadata, to
+   * be received by a #socketsrc with #GstSocketSrc:fd-passing enabled.
+   * The file descriptors of memories backed by one are passed over UNIX
+   * domain sockets instead of copying their data. Other memories, and all
+   * memories for other kinds of sockets, are sent inline after the header.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_FD_PASSING,
+      g_param_spec_boolean ("fd-passing", "FD Passing",
+          "Pass file descriptors of fd backed memories instead of their "
+          "data to clients on UNIX domain sockets", DEFAULT_FD_PASSING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiSocketSink:n-threads:
+   *
+   * The number of threads writing to the clients. Each client is assigned to
+   * one of them when it is added, and the threads write to their clients in
+   * parallel. The buffer queue and the statistics stay shared between all
+   * threads.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of threads",
+          "The number of threads writing to the clients", 1, G_MAXINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   /**
    * GstMultiSocketSink::add:
    * @gstmultisocketsink: the multisocketsink element to emit this signal on
@@ -437,6 +489,8 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
   gstmultihandlesink_class->hash_removing =
       GST_DEBUG_FUNCPTR (gst_multi_socket_sink_hash_removing);
 
+  fd_passing_quark = g_quark_from_static_string ("GstMultiSocketSinkFdPassing");
+
   GST_DEBUG_CATEGORY_INIT (multisocketsink_debug, "multisocketsink", 0,
       "Multi socket sink");
 }
@@ -451,6 +505,8 @@ gst_multi_socket_sink_init (GstMultiSocketSink * this)
   this->cancellable = g_cancellable_new ();
   this->send_dispatched = DEFAULT_SEND_DISPATCHED;
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->fd_passing = DEFAULT_FD_PASSING;
+  this->n_threads = DEFAULT_N_THREADS;
 }
 
 static void
@@ -774,6 +830,81 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+/* Wraps @buf into the fd-passing wire format: a buffer with the header and
+ * the inline memories, which carries the file descriptors of the other
+ * memories as control message. The original buffer is kept as qdata. */
+static GstBuffer *
+gst_multi_socket_sink_wrap_buffer (GstMultiSocketSink * sink, GstBuffer * buf,
+    gboolean pass_fds)
+{
+  GstFdPassingHeader *header;
+  GstBuffer *wire;
+  GSocketControlMessage *cmsgs[CMSG_MAX];
+  gsize i, msg_count;
+  guint n_fds = 0;
+#ifdef HAVE_GIO_UNIX_2_0
+  GUnixFDMessage *fdmsg = NULL;
+#endif
+
+  header = g_new0 (GstFdPassingHeader, 1);
+  header->magic = GST_FD_PASSING_MAGIC;
+  /* buffers never hold more memories than the header can describe */
+  header->n_memories = gst_buffer_n_memory (buf);
+  g_assert (header->n_memories <= GST_FD_PASSING_MAX_MEMORIES);
+  header->pts = GST_BUFFER_PTS (buf);
+  header->dts = GST_BUFFER_DTS (buf);
+  header->duration = GST_BUFFER_DURATION (buf);
+  header->offset = GST_BUFFER_OFFSET (buf);
+  header->offset_end = GST_BUFFER_OFFSET_END (buf);
+  header->flags = GST_BUFFER_FLAGS (buf) & ~GST_BUFFER_FLAG_TAG_MEMORY;
+
+  wire = gst_buffer_new_wrapped (header, sizeof (GstFdPassingHeader));
+
+  for (i = 0; i < header->n_memories; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buf, i);
+    GstFdPassingMemory *desc = &header->memories[i];
+
+    desc->fd_index = GST_FD_PASSING_INLINE;
+    desc->size = mem->size;
+
+#ifdef HAVE_GIO_UNIX_2_0
+    if (pass_fds && gst_is_fd_memory (mem)) {
+      if (!fdmsg)
+        fdmsg = (GUnixFDMessage *) g_unix_fd_message_new ();
+
+      if (g_unix_fd_message_append_fd (fdmsg, gst_fd_memory_get_fd (mem),
+              NULL)) {
+        desc->fd_index = n_fds++;
+        desc->offset = mem->offset;
+        continue;
+      }
+    }
+#endif
+
+    gst_buffer_append_memory (wire, gst_memory_ref (mem));
+  }
+
+  msg_count = gst_buffer_get_cmsg_list (buf, cmsgs, CMSG_MAX);
+  for (i = 0; i < msg_count; i++)
+    gst_buffer_add_net_control_message_meta (wire, cmsgs[i]);
+
+#ifdef HAVE_GIO_UNIX_2_0
+  if (fdmsg) {
+    gst_buffer_add_net_control_message_meta (wire,
+        G_SOCKET_CONTROL_MESSAGE (fdmsg));
+    g_object_unref (fdmsg);
+  }
+#endif
+
+  GST_LOG_OBJECT (sink, "wrapped buffer %p with %u memories, %u passed as fd",
+      buf, header->n_memories, n_fds);
+
+  gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (wire), fd_passing_quark,
+      gst_buffer_ref (buf), (GDestroyNotify) gst_buffer_unref);
+
+  return wire;
+}
+
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
     GSocket * sock, GstBuffer * buffer, gsize bufoffset,
@@ -784,11 +915,14 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   guint mems_mapped;
   gssize wrote;
   GSocketControlMessage *cmsgs[CMSG_MAX];
-  gsize msg_count;
+  gsize msg_count = 0;
 
   mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
 
-  msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
+  /* control messages go with the first byte of the buffer only, a partial
+   * write must not send them again */
+  if (bufoffset == 0)
+    msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
 
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
@@ -825,6 +959,7 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
 {
   gboolean more;
   gboolean flushing;
+  gboolean unlocked;
   GstClockTime now, now_monotonic;
   GError *err = NULL;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
@@ -832,6 +967,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
 
+  /* only release the lock while writing when other threads can use it */
+  unlocked = sink->contexts->len > 1;
 
   now = g_get_real_time () * GST_USECOND;
   now_monotonic = g_get_monotonic_time () * GST_USECOND;
@@ -912,9 +1049,37 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
       /* pick first buffer from list */
       head = GST_BUFFER (mhclient->sending->data);
 
+      if (sink->fd_passing && mhclient->bufoffset == 0 &&
+          !gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (head),
+              fd_passing_quark)) {
+        gboolean pass_fds = g_socket_get_family (mhclient->handle.socket) ==
+            G_SOCKET_FAMILY_UNIX;
+
+        mhclient->sending->data =
+            gst_multi_socket_sink_wrap_buffer (sink, head, pass_fds);
+        gst_buffer_unref (head);
+        head = GST_BUFFER (mhclient->sending->data);
+      }
+
+      if (unlocked) {
+        /* let the other I/O threads write to their clients meanwhile, the
+         * client is not freed while we are writing to it */
+        gst_multi_handle_sink_client_set_writing (mhsink, mhclient, TRUE);
+        CLIENTS_UNLOCK (mhsink);
+      }
+
       wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
           mhclient->bufoffset, sink->cancellable, &err);
 
+      if (unlocked) {
+        CLIENTS_LOCK (mhsink);
+        gst_multi_handle_sink_client_set_writing (mhsink, mhclient, FALSE);
+        if (mhclient->currently_removing)
+          goto removed;
+        /* the client might have been flushed meanwhile */
+        flushing = mhclient->status == GST_CLIENT_STATUS_FLUSHING;
+      }
+
       if (wrote < 0) {
         /* hmm error.. */
         if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CLOSED)) {
@@ -937,11 +1102,16 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           mhclient->bufoffset += wrote;
         } else {
           if (sink->send_dispatched) {
+            GstBuffer *orig =
+                gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (head),
+                fd_passing_quark);
+
             gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
                 gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
                     gst_structure_new ("GstNetworkMessageDispatched",
                         "object", G_TYPE_OBJECT, mhclient->handle.socket,
-                        "buffer", GST_TYPE_BUFFER, head, NULL)));
+                        "buffer", GST_TYPE_BUFFER, orig ? orig : head,
+                        NULL)));
           }
           /* complete buffer was written, we can proceed to the next one */
           mhclient->sending = g_slist_remove (mhclient->sending, head);
@@ -951,8 +1121,8 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         }
         /* update stats */
         mhclient->bytes_sent += wrote;
-        mhclient->last_activity_time = now;
-        mhclient->last_activity_time_monotonic = now_monotonic;
+        gst_multi_handle_sink_client_activity (mhsink, mhclient, now,
+            now_monotonic);
         mhsink->bytes_served += wrote;
       }
     }
@@ -961,6 +1131,14 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   return TRUE;
 
   /* ERRORS */
+removed:
+  {
+    /* removed by another thread while writing, the client is freed as soon
+     * as we release the lock */
+    GST_DEBUG_OBJECT (sink, "%s removed while writing", mhclient->debug);
+    g_clear_error (&err);
+    return TRUE;
+  }
 flushed:
   {
     GST_DEBUG_OBJECT (sink, "%s flushed, removing", mhclient->debug);
@@ -1000,12 +1178,18 @@ ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
     g_source_unref (client->source);
   }
   if (condition && sink->main_context) {
+    /* spread the clients over the I/O threads */
+    if (client->context == NULL) {
+      client->context = g_ptr_array_index (sink->contexts,
+          sink->next_context++ % sink->contexts->len);
+    }
+
     client->source = g_socket_create_source (mhclient->handle.socket,
         condition, sink->cancellable);
     g_source_set_callback (client->source,
         (GSourceFunc) gst_multi_socket_sink_socket_condition,
         gst_object_ref (sink), (GDestroyNotify) gst_object_unref);
-    g_source_attach (client->source, sink->main_context);
+    g_source_attach (client->source, client->context);
   } else {
     client->source = NULL;
     condition = 0;
@@ -1114,29 +1298,38 @@ static gboolean
 gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
 {
   GstClockTime now;
-  GList *clients;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
 
   now = g_get_monotonic_time () * GST_USECOND;
 
   CLIENTS_LOCK (mhsink);
-  for (clients = mhsink->clients; clients; clients = clients->next) {
-    GstSocketClient *client;
-    GstMultiHandleClient *mhclient;
-
-    client = clients->data;
-    mhclient = (GstMultiHandleClient *) client;
-    if (mhsink->timeout > 0
-        && now - mhclient->last_activity_time_monotonic > mhsink->timeout) {
-      mhclient->status = GST_CLIENT_STATUS_SLOW;
-      gst_multi_handle_sink_remove_client_link (mhsink, clients);
-    }
-  }
+  gst_multi_handle_sink_remove_timed_out (mhsink, now);
   CLIENTS_UNLOCK (mhsink);
 
   return FALSE;
 }
 
+typedef struct
+{
+  GstMultiSocketSink *sink;
+  GMainContext *context;
+} GstSocketIOThread;
+
+/* the I/O threads besides the main one only handle the sockets of their
+ * clients */
+static gpointer
+gst_multi_socket_sink_io_thread (GstSocketIOThread * io)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (io->sink);
+
+  while (mhsink->running)
+    g_main_context_iteration (io->context, TRUE);
+
+  g_free (io);
+
+  return NULL;
+}
+
 /* we handle the client communication in another thread so that we do not block
  * the gstreamer thread while we select() on the client fds */
 static gpointer
@@ -1144,10 +1337,39 @@ gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GSource *timeout = NULL;
+  GPtrArray *threads;
+  guint i;
+
+  threads = g_ptr_array_new ();
+  for (i = 1; i < sink->contexts->len; i++) {
+    GstSocketIOThread *io = g_new (GstSocketIOThread, 1);
+
+    io->sink = sink;
+    io->context = g_ptr_array_index (sink->contexts, i);
+    g_ptr_array_add (threads, g_thread_new ("multisocketsink-io",
+            (GThreadFunc) gst_multi_socket_sink_io_thread, io));
+  }
 
   while (mhsink->running) {
     if (mhsink->timeout > 0) {
-      timeout = g_timeout_source_new (mhsink->timeout / GST_MSECOND);
+      GstClockTime deadline, now;
+      guint interval;
+
+      CLIENTS_LOCK (mhsink);
+      deadline = gst_multi_handle_sink_next_timeout (mhsink);
+      CLIENTS_UNLOCK (mhsink);
+
+      /* wake up when the least recently active client times out, or check
+       * again after a full timeout when there is no client yet */
+      now = g_get_monotonic_time () * GST_USECOND;
+      if (deadline == GST_CLOCK_TIME_NONE)
+        interval = mhsink->timeout / GST_MSECOND;
+      else if (deadline > now)
+        interval = (deadline - now) / GST_MSECOND + 1;
+      else
+        interval = 0;
+
+      timeout = g_timeout_source_new (interval);
 
       g_source_set_callback (timeout,
           (GSourceFunc) gst_multi_socket_sink_timeout, gst_object_ref (sink),
@@ -1167,6 +1389,10 @@ gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
     }
   }
 
+  for (i = 0; i < threads->len; i++)
+    g_thread_join (g_ptr_array_index (threads, i));
+  g_ptr_array_free (threads, TRUE);
+
   return NULL;
 }
 
@@ -1183,6 +1409,12 @@ gst_multi_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       sink->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_FD_PASSING:
+      sink->fd_passing = g_value_get_boolean (value);
+      break;
+    case PROP_N_THREADS:
+      sink->n_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1202,6 +1434,12 @@ gst_multi_socket_sink_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, sink->send_messages);
       break;
+    case PROP_FD_PASSING:
+      g_value_set_boolean (value, sink->fd_passing);
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, sink->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1215,10 +1453,17 @@ gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink)
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
   GList *clients;
+  guint i;
 
   GST_INFO_OBJECT (mssink, "starting");
 
   mssink->main_context = g_main_context_new ();
+  mssink->contexts =
+      g_ptr_array_new_with_free_func ((GDestroyNotify) g_main_context_unref);
+  g_ptr_array_add (mssink->contexts, g_main_context_ref (mssink->main_context));
+  for (i = 1; i < mssink->n_threads; i++)
+    g_ptr_array_add (mssink->contexts, g_main_context_new ());
+  mssink->next_context = 0;
 
   CLIENTS_LOCK (mhsink);
   for (clients = mhsink->clients; clients; clients = clients->next) {
@@ -1240,13 +1485,24 @@ multisocketsink_hash_remove (gpointer key, gpointer value, gpointer data)
   return TRUE;
 }
 
+static void
+wakeup_contexts (GstMultiSocketSink * sink)
+{
+  guint i;
+
+  if (sink->contexts == NULL)
+    return;
+
+  for (i = 0; i < sink->contexts->len; i++)
+    g_main_context_wakeup (g_ptr_array_index (sink->contexts, i));
+}
+
 static void
 gst_multi_socket_sink_stop_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
 
-  if (mssink->main_context)
-    g_main_context_wakeup (mssink->main_context);
+  wakeup_contexts (mssink);
 }
 
 static void
@@ -1258,6 +1514,10 @@ gst_multi_socket_sink_stop_post (GstMultiHandleSink * mhsink)
     g_main_context_unref (mssink->main_context);
     mssink->main_context = NULL;
   }
+  if (mssink->contexts) {
+    g_ptr_array_unref (mssink->contexts);
+    mssink->contexts = NULL;
+  }
 
   g_hash_table_foreach_remove (mhsink->handle_hash, multisocketsink_hash_remove,
       mssink);
@@ -1272,8 +1532,7 @@ gst_multi_socket_sink_unlock (GstBaseSink * bsink)
 
   GST_DEBUG_OBJECT (sink, "set to flushing");
   g_cancellable_cancel (sink->cancellable);
-  if (sink->main_context)
-    g_main_context_wakeup (sink->main_context);
+  wakeup_contexts (sink);
 
   return TRUE;
 }
@@ -1296,9 +1555,20 @@ gst_multi_socket_sink_unlock_stop (GstBaseSink * bsink)
 static gboolean
 gst_multi_socket_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
 {
+  GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (bsink);
+
   /* we support some meta */
   gst_query_add_allocation_meta (query, GST_NET_CONTROL_MESSAGE_META_API_TYPE,
       NULL);
 
+  /* shared memory can be passed to clients without copying */
+  if (sink->fd_passing) {
+    GstAllocator *allocator;
+
+    allocator = gst_shm_allocator_new (GST_SHM_ALLOCATOR_FLAG_SEAL);
+    gst_query_add_allocation_param (query, allocator, NULL);
+    gst_object_unref (allocator);
+  }
+
   return TRUE;
 }
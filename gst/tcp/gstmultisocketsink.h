@@ -55,6 +55,7 @@ typedef struct {
 
   GSource *source;
   GIOCondition condition;
+  GMainContext *context;        /* context of the I/O thread of the client */
 } GstSocketClient;
 
 /**
@@ -67,9 +68,14 @@ struct _GstMultiSocketSink {
 
   /*< private >*/
   GMainContext *main_context;
+  GPtrArray *contexts;          /* one per I/O thread, the first one is
+                                   main_context */
+  guint next_context;           /* context for the next client */
   GCancellable *cancellable;
   gboolean send_messages;
   gboolean send_dispatched;
+  gboolean fd_passing;
+  guint n_threads;
 };
 
 struct _GstMultiSocketSinkClass {
@@ -42,6 +42,11 @@
  * As compared to #fdsrc socketsrc is socket specific and deals with #GSocket
  * objects rather than sockets via integer file-descriptors.
  *
+ * With the #GstSocketSrc:fd-passing property, socketsrc receives buffers
+ * sent by a #multisocketsink with the same property set. File descriptors
+ * passed over UNIX domain sockets are wrapped in #GstFdMemory, so the data
+ * shared by the sending process is used without copying it.
+ *
  * @see_also: #multisocketsink
  */
 
@@ -51,8 +56,23 @@
 
 #include <gst/gst-i18n-plugin.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/gstfdmemory.h>
+
+#ifdef HAVE_GIO_UNIX_2_0
+#include <gio/gunixfdmessage.h>
+#endif
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef G_OS_UNIX
+#include <sys/stat.h>
+#include <errno.h>
+#endif
+
 #include "gsttcpelements.h"
 #include "gstsocketsrc.h"
+#include "gstfdpassing.h"
 
 GST_DEBUG_CATEGORY_STATIC (socketsrc_debug);
 #define GST_CAT_DEFAULT socketsrc_debug
@@ -67,13 +87,15 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
 
 
 #define DEFAULT_SEND_MESSAGES FALSE
+#define DEFAULT_FD_PASSING FALSE
 
 enum
 {
   PROP_0,
   PROP_SOCKET,
   PROP_CAPS,
-  PROP_SEND_MESSAGES
+  PROP_SEND_MESSAGES,
+  PROP_FD_PASSING
 };
 
 enum
@@ -93,6 +115,8 @@ static void gst_socket_src_finalize (GObject * gobject);
 
 static GstCaps *gst_socketsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_socketsrc_event (GstBaseSrc * src, GstEvent * event);
+static GstFlowReturn gst_socket_src_create (GstPushSrc * psrc,
+    GstBuffer ** outbuf);
 static GstFlowReturn gst_socket_src_fill (GstPushSrc * psrc,
     GstBuffer * outbuf);
 static gboolean gst_socket_src_unlock (GstBaseSrc * bsrc);
@@ -150,6 +174,20 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
           "If GstNetworkMessage events should be handled",
           DEFAULT_SEND_MESSAGES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSocketSrc:fd-passing:
+   *
+   * Receive buffers sent by a #multisocketsink with
+   * #GstMultiSocketSink:fd-passing enabled. Memories whose file descriptor
+   * was passed are wrapped without copying and are read-only.
+   *
+   * Since: 1.20
+   **/
+  g_object_class_install_property (gobject_class, PROP_FD_PASSING,
+      g_param_spec_boolean ("fd-passing", "FD Passing",
+          "Receive buffers with passed file descriptors from multisocketsink",
+          DEFAULT_FD_PASSING, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_socket_src_signals[CONNECTION_CLOSED_BY_PEER] =
       g_signal_new ("connection-closed-by-peer", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_FIRST, G_STRUCT_OFFSET (GstSocketSrcClass,
@@ -168,6 +206,7 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
   gstbasesrc_class->unlock = gst_socket_src_unlock;
   gstbasesrc_class->unlock_stop = gst_socket_src_unlock_stop;
 
+  gstpush_src_class->create = gst_socket_src_create;
   gstpush_src_class->fill = gst_socket_src_fill;
 
   GST_DEBUG_CATEGORY_INIT (socketsrc_debug, "socketsrc", 0, "Socket Source");
@@ -179,6 +218,8 @@ gst_socket_src_init (GstSocketSrc * this)
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->fd_passing = DEFAULT_FD_PASSING;
+  this->fd_allocator = gst_fd_allocator_new ();
 }
 
 static void
@@ -190,6 +231,7 @@ gst_socket_src_finalize (GObject * gobject)
     gst_caps_unref (this->caps);
   g_clear_object (&this->cancellable);
   g_clear_object (&this->socket);
+  gst_clear_object (&this->fd_allocator);
 
   G_OBJECT_CLASS (parent_class)->finalize (gobject);
 }
@@ -273,6 +315,319 @@ gst_socketsrc_getcaps (GstBaseSrc * src, GstCaps * filter)
   return result;
 }
 
+/* Called when the peer closed @socket. Returns TRUE if a new socket was set
+ * from the connection-closed-by-peer signal, which then replaces @socket. */
+static gboolean
+gst_socket_src_socket_closed (GstSocketSrc * src, GSocket ** socket)
+{
+  GSocket *tmp = NULL;
+
+  GST_DEBUG_OBJECT (src, "Received EOS on socket %p fd %i", *socket,
+      g_socket_get_fd (*socket));
+
+  /* We've hit EOS but we'll send this signal to allow someone to change
+   * our socket before we send EOS downstream. */
+  g_signal_emit (src, gst_socket_src_signals[CONNECTION_CLOSED_BY_PEER], 0);
+
+  GST_OBJECT_LOCK (src);
+
+  if (src->socket)
+    tmp = g_object_ref (src->socket);
+
+  GST_OBJECT_UNLOCK (src);
+
+  /* Do this dance with tmp to avoid unreffing with the lock held */
+  if (tmp != NULL && tmp != *socket) {
+    SWAP (*socket, tmp);
+    g_clear_object (&tmp);
+
+    GST_INFO_OBJECT (src, "New socket available after EOS %p fd %i: Retrying",
+        *socket, g_socket_get_fd (*socket));
+    return TRUE;
+  }
+
+  g_clear_object (&tmp);
+  GST_INFO_OBJECT (src, "Forwarding EOS downstream");
+
+  return FALSE;
+}
+
+/* Receives exactly @size bytes into @data. Control messages received on the
+ * way are added to @messages. Returns GST_FLOW_EOS if the peer closed the
+ * connection before any byte was received. */
+static GstFlowReturn
+gst_socket_src_receive_fully (GstSocketSrc * src, GSocket * socket,
+    guint8 * data, gsize size, GPtrArray * messages)
+{
+  gsize received = 0;
+
+  while (received < size) {
+    GSocketControlMessage **msgs = NULL;
+    gint i, num_messages = 0;
+    GInputVector ivec;
+    GError *err = NULL;
+    gint flags = 0;
+    gssize rret;
+
+    ivec.buffer = data + received;
+    ivec.size = size - received;
+    rret = g_socket_receive_message (socket, NULL, &ivec, 1, &msgs,
+        &num_messages, &flags, src->cancellable, &err);
+
+    for (i = 0; i < num_messages; i++)
+      g_ptr_array_add (messages, msgs[i]);
+    g_free (msgs);
+
+    if (rret == 0) {
+      if (received == 0)
+        return GST_FLOW_EOS;
+
+      GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+          ("Connection closed in the middle of a buffer"));
+      return GST_FLOW_ERROR;
+    } else if (rret < 0) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        GST_DEBUG_OBJECT (src, "Cancelled reading from socket");
+        g_clear_error (&err);
+        return GST_FLOW_FLUSHING;
+      }
+
+      GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+          ("Failed to read from socket: %s", err->message));
+      g_clear_error (&err);
+      return GST_FLOW_ERROR;
+    }
+
+    received += rret;
+  }
+
+  return GST_FLOW_OK;
+}
+
+/* Checks that the file behind @fd is large enough to back @desc. Mapping a
+ * range beyond the end of the file would fault when the data is accessed. */
+static gboolean
+gst_socket_src_check_fd_size (GstSocketSrc * src, gint fd,
+    const GstFdPassingMemory * desc)
+{
+#ifdef G_OS_UNIX
+  struct stat st;
+
+  if (desc->size > G_MAXSIZE || desc->offset > G_MAXSIZE - desc->size) {
+    GST_WARNING_OBJECT (src, "Invalid range %" G_GUINT64_FORMAT "+%"
+        G_GUINT64_FORMAT, desc->offset, desc->size);
+    return FALSE;
+  }
+
+  if (fstat (fd, &st) < 0) {
+    GST_WARNING_OBJECT (src, "Failed to stat fd %d: %s", fd,
+        g_strerror (errno));
+    return FALSE;
+  }
+
+  if (st.st_size < 0 || (guint64) st.st_size < desc->offset + desc->size) {
+    GST_WARNING_OBJECT (src, "fd %d of size %" G_GINT64_FORMAT " too small "
+        "for range %" G_GUINT64_FORMAT "+%" G_GUINT64_FORMAT, fd,
+        (gint64) st.st_size, desc->offset, desc->size);
+    return FALSE;
+  }
+
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/* Creates a buffer from the fd-passing wire format, see gstfdpassing.h */
+static GstFlowReturn
+gst_socket_src_create_fd_passing (GstSocketSrc * src, GSocket ** socket,
+    GstBuffer ** outbuf)
+{
+  GstFlowReturn ret;
+  GstFdPassingHeader header;
+  GPtrArray *messages;
+  GstBuffer *buf = NULL;
+  guint64 inline_size = 0;
+  gint *fds = NULL;
+  gint n_fds = 0;
+  guint i;
+
+retry:
+  messages = g_ptr_array_new_with_free_func (g_object_unref);
+
+  ret = gst_socket_src_receive_fully (src, *socket, (guint8 *) & header,
+      sizeof (header), messages);
+  if (ret == GST_FLOW_EOS && gst_socket_src_socket_closed (src, socket)) {
+    g_ptr_array_unref (messages);
+    goto retry;
+  }
+  if (ret != GST_FLOW_OK)
+    goto done;
+
+  if (header.magic != GST_FD_PASSING_MAGIC
+      || header.n_memories > GST_FD_PASSING_MAX_MEMORIES)
+    goto invalid_header;
+
+#ifdef HAVE_GIO_UNIX_2_0
+  /* take the passed file descriptors */
+  for (i = 0; i < messages->len && fds == NULL; i++) {
+    GSocketControlMessage *msg = g_ptr_array_index (messages, i);
+
+    if (G_IS_UNIX_FD_MESSAGE (msg))
+      fds = g_unix_fd_message_steal_fds (G_UNIX_FD_MESSAGE (msg), &n_fds);
+  }
+#endif
+
+  buf = gst_buffer_new ();
+
+  for (i = 0; i < header.n_memories; i++) {
+    GstFdPassingMemory *desc = &header.memories[i];
+    GstMemory *mem;
+
+    if (desc->fd_index == GST_FD_PASSING_INLINE) {
+      GstMapInfo map;
+
+      /* don't let the peer make us allocate arbitrary amounts of memory */
+      if (desc->size > GST_FD_PASSING_MAX_INLINE_SIZE - inline_size)
+        goto too_large;
+      inline_size += desc->size;
+
+      mem = gst_allocator_alloc (NULL, desc->size, NULL);
+      if (!mem || !gst_memory_map (mem, &map, GST_MAP_WRITE))
+        goto alloc_failed;
+
+      ret = gst_socket_src_receive_fully (src, *socket, map.data, map.size,
+          messages);
+      gst_memory_unmap (mem, &map);
+
+      if (ret != GST_FLOW_OK) {
+        gst_memory_unref (mem);
+        if (ret == GST_FLOW_EOS) {
+          GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+              ("Connection closed in the middle of a buffer"));
+          ret = GST_FLOW_ERROR;
+        }
+        goto done;
+      }
+    } else {
+      if (desc->fd_index >= (guint) n_fds || fds[desc->fd_index] < 0)
+        goto invalid_header;
+
+      if (!gst_socket_src_check_fd_size (src, fds[desc->fd_index], desc))
+        goto invalid_fd;
+
+      mem = gst_fd_allocator_alloc (src->fd_allocator, fds[desc->fd_index],
+          desc->offset + desc->size, GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+      if (!mem)
+        goto alloc_failed;
+
+      /* the memory owns the fd now */
+      fds[desc->fd_index] = -1;
+      gst_memory_resize (mem, desc->offset, desc->size);
+
+      /* writing would modify the data of the sender */
+      GST_MINI_OBJECT_FLAG_SET (mem, GST_MEMORY_FLAG_READONLY);
+    }
+
+    gst_buffer_append_memory (buf, mem);
+  }
+
+  GST_BUFFER_PTS (buf) = header.pts;
+  GST_BUFFER_DTS (buf) = header.dts;
+  GST_BUFFER_DURATION (buf) = header.duration;
+  GST_BUFFER_OFFSET (buf) = header.offset;
+  GST_BUFFER_OFFSET_END (buf) = header.offset_end;
+  GST_BUFFER_FLAGS (buf) = header.flags & ~GST_BUFFER_FLAG_TAG_MEMORY;
+
+  for (i = 0; i < messages->len; i++) {
+    GSocketControlMessage *msg = g_ptr_array_index (messages, i);
+
+#ifdef HAVE_GIO_UNIX_2_0
+    if (G_IS_UNIX_FD_MESSAGE (msg))
+      continue;
+#endif
+    gst_buffer_add_net_control_message_meta (buf, msg);
+  }
+
+  GST_LOG_OBJECT (src, "Received buffer of size %" G_GSIZE_FORMAT " with %u "
+      "memories and %d fds, ts %" GST_TIME_FORMAT, gst_buffer_get_size (buf),
+      header.n_memories, n_fds, GST_TIME_ARGS (GST_BUFFER_PTS (buf)));
+
+  *outbuf = buf;
+  buf = NULL;
+
+done:
+#ifdef G_OS_UNIX
+  for (i = 0; i < n_fds; i++) {
+    if (fds[i] >= 0)
+      close (fds[i]);
+  }
+#endif
+  g_free (fds);
+  g_ptr_array_unref (messages);
+  if (buf)
+    gst_buffer_unref (buf);
+
+  return ret;
+
+invalid_header:
+  {
+    GST_ELEMENT_ERROR (src, STREAM, DECODE, (NULL),
+        ("Received invalid fd-passing header"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+too_large:
+  {
+    GST_ELEMENT_ERROR (src, STREAM, DECODE, (NULL),
+        ("Received buffer with more than %u bytes of inline data",
+            GST_FD_PASSING_MAX_INLINE_SIZE));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+invalid_fd:
+  {
+    GST_ELEMENT_ERROR (src, STREAM, DECODE, (NULL),
+        ("Received file descriptor does not cover the announced data"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+alloc_failed:
+  {
+    GST_ELEMENT_ERROR (src, RESOURCE, FAILED, (NULL),
+        ("Failed to allocate memory for received buffer"));
+    ret = GST_FLOW_ERROR;
+    goto done;
+  }
+}
+
+static GstFlowReturn
+gst_socket_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+{
+  GstSocketSrc *src = GST_SOCKET_SRC (psrc);
+  GSocket *socket = NULL;
+  GstFlowReturn ret;
+
+  if (!src->fd_passing)
+    return GST_PUSH_SRC_CLASS (parent_class)->create (psrc, outbuf);
+
+  GST_OBJECT_LOCK (src);
+  if (src->socket)
+    socket = g_object_ref (src->socket);
+  GST_OBJECT_UNLOCK (src);
+
+  if (socket == NULL) {
+    GST_ELEMENT_ERROR (src, RESOURCE, NOT_FOUND, (NULL),
+        ("Cannot receive: No socket set on socketsrc"));
+    return GST_FLOW_ERROR;
+  }
+
+  ret = gst_socket_src_create_fd_passing (src, &socket, outbuf);
+  g_object_unref (socket);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_socket_src_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -319,34 +674,10 @@ retry:
   g_free (messages);
 
   if (rret == 0) {
-    GSocket *tmp = NULL;
-    GST_DEBUG_OBJECT (src, "Received EOS on socket %p fd %i", socket,
-        g_socket_get_fd (socket));
-
-    /* We've hit EOS but we'll send this signal to allow someone to change
-     * our socket before we send EOS downstream. */
-    g_signal_emit (src, gst_socket_src_signals[CONNECTION_CLOSED_BY_PEER], 0);
-
-    GST_OBJECT_LOCK (src);
-
-    if (src->socket)
-      tmp = g_object_ref (src->socket);
-
-    GST_OBJECT_UNLOCK (src);
-
-    /* Do this dance with tmp to avoid unreffing with the lock held */
-    if (tmp != NULL && tmp != socket) {
-      SWAP (socket, tmp);
-      g_clear_object (&tmp);
-
-      GST_INFO_OBJECT (src, "New socket available after EOS %p fd %i: Retrying",
-          socket, g_socket_get_fd (socket));
-
+    if (gst_socket_src_socket_closed (src, &socket)) {
       /* retry with our new socket: */
       goto retry;
     } else {
-      g_clear_object (&tmp);
-      GST_INFO_OBJECT (src, "Forwarding EOS downstream");
       ret = GST_FLOW_EOS;
     }
   } else if (rret < 0) {
@@ -425,6 +756,9 @@ gst_socket_src_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       socketsrc->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_FD_PASSING:
+      socketsrc->fd_passing = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -449,6 +783,9 @@ gst_socket_src_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, socketsrc->send_messages);
       break;
+    case PROP_FD_PASSING:
+      g_value_set_boolean (value, socketsrc->fd_passing);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -51,6 +51,8 @@ struct _GstSocketSrc {
   GstCaps *caps;
   GSocket *socket;
   gboolean send_messages;
+  gboolean fd_passing;
+  GstAllocator *fd_allocator;
   GCancellable *cancellable;
 };
 
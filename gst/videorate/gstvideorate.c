@@ -100,6 +100,7 @@ enum
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
+#define DEFAULT_MARK_DUPLICATES FALSE
 
 enum
 {
@@ -115,7 +116,9 @@ enum
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
   PROP_RATE,
-  PROP_MAX_DUPLICATION_TIME
+  PROP_MAX_DUPLICATION_TIME,
+  PROP_MARK_DUPLICATES,
+  PROP_REPEATED_BYTES
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -295,6 +298,38 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           0, G_MAXUINT64, DEFAULT_MAX_DUPLICATION_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:mark-duplicates:
+   *
+   * Set the %GST_VIDEO_BUFFER_FLAG_REPEATED flag on duplicated frames.
+   * Duplicated frames always share their memory with the original frame, the
+   * flag allows downstream elements like compositor to skip processing them
+   * again.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (object_class, PROP_MARK_DUPLICATES,
+      g_param_spec_boolean ("mark-duplicates", "Mark duplicates",
+          "Flag duplicated frames as repeats of the previous frame",
+          DEFAULT_MARK_DUPLICATES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoRate:repeated-bytes:
+   *
+   * Number of bytes of the frames that were flagged as repeats of the
+   * previous frame because #GstVideoRate:mark-duplicates is enabled.
+   *
+   * Duplicated frames always share their memory with the original frame, so
+   * this is not memory that was saved. It is the amount of data downstream
+   * elements can skip processing again thanks to the flag.
+   *
+   * Since: 1.20
+   */
+  g_object_class_install_property (object_class, PROP_REPEATED_BYTES,
+      g_param_spec_uint64 ("repeated-bytes", "Repeated bytes",
+          "Number of bytes of frames flagged as repeats of the previous frame",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -624,6 +659,7 @@ gst_video_rate_reset (GstVideoRate * videorate)
   videorate->out_frame_count = 0;
   videorate->drop = 0;
   videorate->dup = 0;
+  videorate->repeated_bytes = 0;
   videorate->next_ts = GST_CLOCK_TIME_NONE;
   videorate->last_ts = GST_CLOCK_TIME_NONE;
   videorate->discont = TRUE;
@@ -647,6 +683,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->rate = DEFAULT_RATE;
   videorate->pending_rate = DEFAULT_RATE;
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
+  videorate->mark_duplicates = DEFAULT_MARK_DUPLICATES;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -673,10 +710,15 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
   } else
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
 
-  if (duplicate)
+  if (duplicate) {
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  else
+    if (videorate->mark_duplicates) {
+      GST_BUFFER_FLAG_SET (outbuf, GST_VIDEO_BUFFER_FLAG_REPEATED);
+      videorate->repeated_bytes += gst_buffer_get_size (outbuf);
+    }
+  } else {
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+  }
 
   /* this is the timestamp we put on the buffer */
   push_ts = videorate->next_ts;
@@ -1874,6 +1916,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       videorate->max_duplication_time = g_value_get_uint64 (value);
       break;
+    case PROP_MARK_DUPLICATES:
+      videorate->mark_duplicates = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1936,6 +1981,12 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       g_value_set_uint64 (value, videorate->max_duplication_time);
       break;
+    case PROP_MARK_DUPLICATES:
+      g_value_set_boolean (value, videorate->mark_duplicates);
+      break;
+    case PROP_REPEATED_BYTES:
+      g_value_set_uint64 (value, videorate->repeated_bytes);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -64,6 +64,7 @@ struct _GstVideoRate
 
   /* properties */
   guint64 in, out, dup, drop;
+  guint64 repeated_bytes;
   gboolean silent;
   gdouble new_pref;
   gboolean skip_to_first;
@@ -73,6 +74,7 @@ struct _GstVideoRate
   int max_rate;
   gdouble rate;
   gdouble pending_rate;
+  gboolean mark_duplicates;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (videorate);
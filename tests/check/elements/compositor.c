@@ -2268,6 +2268,262 @@ GST_START_TEST (test_signals)
 
 GST_END_TEST;
 
+#define INCREMENTAL_N_FRAMES 5
+
+static GstBuffer *
+_new_filled_i420_buffer (gint width, gint height, guint8 value,
+    GstClockTime pts, GstClockTime duration)
+{
+  GstVideoInfo info;
+  GstBuffer *buf;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, width, height);
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  gst_buffer_memset (buf, 0, value, GST_VIDEO_INFO_SIZE (&info));
+  GST_BUFFER_PTS (buf) = pts;
+  GST_BUFFER_DURATION (buf) = duration;
+
+  return buf;
+}
+
+static void
+_run_incremental (gboolean incremental, GstBuffer ** outbufs,
+    guint64 * bytes_blended, GstStructure ** stats)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h0, *h1;
+  GstPad *pad;
+  gint i;
+
+  g_object_set (comp, "background", 1, "incremental", incremental, NULL);
+
+  h0 = gst_harness_new_with_element (comp, "sink_0", "src");
+  h1 = gst_harness_new_with_element (comp, "sink_1", NULL);
+
+  pad = gst_element_get_static_pad (comp, "sink_1");
+  g_object_set (pad, "xpos", 16, "ypos", 100, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_set_caps_str (h0,
+      "video/x-raw, format=I420, width=320, height=240, framerate=10/1",
+      "video/x-raw, format=I420, width=320, height=240, framerate=10/1");
+  gst_harness_set_src_caps_str (h1,
+      "video/x-raw, format=I420, width=32, height=32, framerate=10/1");
+
+  gst_harness_play (h0);
+  gst_harness_play (h1);
+
+  /* A static full-frame slide on sink_0 and a small changing tile on sink_1 */
+  gst_harness_push (h0, _new_filled_i420_buffer (320, 240, 80, 0,
+          10 * GST_SECOND));
+  gst_harness_push_event (h0, gst_event_new_eos ());
+
+  for (i = 0; i < INCREMENTAL_N_FRAMES; i++) {
+    GstStructure *s;
+
+    gst_harness_push (h1, _new_filled_i420_buffer (32, 32, 40 * (i + 1),
+            i * 100 * GST_MSECOND, 100 * GST_MSECOND));
+    outbufs[i] = gst_harness_pull (h0);
+    fail_unless (outbufs[i] != NULL);
+
+    g_object_get (comp, "stats", &s, NULL);
+    fail_unless (gst_structure_get_uint64 (s, "last-bytes-blended",
+            &bytes_blended[i]));
+    gst_structure_free (s);
+  }
+
+  g_object_get (comp, "stats", stats, NULL);
+
+  gst_harness_teardown (h1);
+  gst_harness_teardown (h0);
+  gst_object_unref (comp);
+}
+
+GST_START_TEST (test_incremental)
+{
+  GstBuffer *full[INCREMENTAL_N_FRAMES], *incr[INCREMENTAL_N_FRAMES];
+  guint64 full_bytes[INCREMENTAL_N_FRAMES], incr_bytes[INCREMENTAL_N_FRAMES];
+  GstStructure *full_stats, *incr_stats;
+  guint64 val;
+  gint i;
+
+  _run_incremental (FALSE, full, full_bytes, &full_stats);
+  _run_incremental (TRUE, incr, incr_bytes, &incr_stats);
+
+  fail_unless (gst_structure_get_uint64 (full_stats, "frames-full", &val));
+  fail_unless_equals_uint64 (val, INCREMENTAL_N_FRAMES);
+  fail_unless (gst_structure_get_uint64 (incr_stats, "frames-full", &val));
+  fail_unless_equals_uint64 (val, 1);
+  fail_unless (gst_structure_get_uint64 (incr_stats, "frames-incremental",
+          &val));
+  fail_unless_equals_uint64 (val, INCREMENTAL_N_FRAMES - 1);
+
+  /* The first frame is rendered completely in both cases */
+  fail_unless_equals_uint64 (incr_bytes[0], full_bytes[0]);
+
+  for (i = 0; i < INCREMENTAL_N_FRAMES; i++) {
+    GstMapInfo full_map, incr_map;
+
+    GST_INFO ("frame %d: %" G_GUINT64_FORMAT " bytes blended, %"
+        G_GUINT64_FORMAT " bytes blended incrementally", i, full_bytes[i],
+        incr_bytes[i]);
+
+    /* Only the 32 lines of the changing tile have to be rendered again */
+    if (i > 0)
+      fail_unless (incr_bytes[i] * 4 < full_bytes[i]);
+
+    /* and the result must be the same as when rendering everything */
+    fail_unless (gst_buffer_map (full[i], &full_map, GST_MAP_READ));
+    fail_unless (gst_buffer_map (incr[i], &incr_map, GST_MAP_READ));
+    fail_unless_equals_int (full_map.size, incr_map.size);
+    fail_unless (memcmp (full_map.data, incr_map.data, full_map.size) == 0);
+    gst_buffer_unmap (incr[i], &incr_map);
+    gst_buffer_unmap (full[i], &full_map);
+
+    gst_buffer_unref (full[i]);
+    gst_buffer_unref (incr[i]);
+  }
+
+  gst_structure_free (full_stats);
+  gst_structure_free (incr_stats);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+_new_mapped_watch_buffer (gint width, gint height, GstClockTime pts)
+{
+  GstBuffer *buf = _new_filled_i420_buffer (width, height, 80, pts,
+      GST_SECOND);
+  GstVideoMeta *meta;
+
+  meta = gst_buffer_add_video_meta (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, width, height);
+  /* Override the default map() function to set also buffer_mapped */
+  default_map = meta->map;
+  meta->map = test_obscured_new_videometa_map;
+
+  return buf;
+}
+
+GST_START_TEST (test_obscured_by_combination)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h0, *h1, *h2;
+  GstBuffer *buf;
+  GstPad *pad;
+
+  h0 = gst_harness_new_with_element (comp, "sink_0", "src");
+  h1 = gst_harness_new_with_element (comp, "sink_1", NULL);
+  h2 = gst_harness_new_with_element (comp, "sink_2", NULL);
+
+  /* sink_1 and sink_2 each cover one half of sink_0 */
+  pad = gst_element_get_static_pad (comp, "sink_1");
+  g_object_set (pad, "width", 10, "height", 20, NULL);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (comp, "sink_2");
+  g_object_set (pad, "xpos", 10, "width", 10, "height", 20, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_set_caps_str (h0,
+      "video/x-raw, format=I420, width=20, height=20, framerate=1/1",
+      "video/x-raw, format=I420, width=20, height=20, framerate=1/1");
+  gst_harness_set_src_caps_str (h1,
+      "video/x-raw, format=I420, width=20, height=20, framerate=1/1");
+  gst_harness_set_src_caps_str (h2,
+      "video/x-raw, format=I420, width=20, height=20, framerate=1/1");
+
+  gst_harness_play (h0);
+  gst_harness_play (h1);
+  gst_harness_play (h2);
+
+  buffer_mapped = FALSE;
+  gst_harness_push (h0, _new_mapped_watch_buffer (20, 20, 0));
+  gst_harness_push (h1, _new_filled_i420_buffer (20, 20, 40, 0, GST_SECOND));
+  gst_harness_push (h2, _new_filled_i420_buffer (20, 20, 40, 0, GST_SECOND));
+  buf = gst_harness_pull (h0);
+  gst_buffer_unref (buf);
+  fail_unless (buffer_mapped == FALSE);
+
+  /* Leave a gap of one column between sink_1 and sink_2 */
+  pad = gst_element_get_static_pad (comp, "sink_2");
+  g_object_set (pad, "xpos", 11, NULL);
+  gst_object_unref (pad);
+
+  gst_harness_push (h0, _new_mapped_watch_buffer (20, 20, GST_SECOND));
+  gst_harness_push (h1, _new_filled_i420_buffer (20, 20, 40, GST_SECOND,
+          GST_SECOND));
+  gst_harness_push (h2, _new_filled_i420_buffer (20, 20, 40, GST_SECOND,
+          GST_SECOND));
+  buf = gst_harness_pull (h0);
+  gst_buffer_unref (buf);
+  fail_unless (buffer_mapped == TRUE);
+
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h1);
+  gst_harness_teardown (h0);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_passthrough)
+{
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h;
+  GstBuffer *inbuf, *outbuf;
+  GstStructure *stats;
+  GstPad *pad;
+  guint64 val;
+
+  h = gst_harness_new_with_element (comp, "sink_0", "src");
+  gst_harness_set_caps_str (h,
+      "video/x-raw, format=I420, width=64, height=48, framerate=10/1",
+      "video/x-raw, format=I420, width=64, height=48, framerate=10/1");
+  gst_harness_play (h);
+
+  /* The input buffer covers the whole output and is forwarded as-is */
+  inbuf = _new_filled_i420_buffer (64, 48, 80, 0, 100 * GST_MSECOND);
+  GST_BUFFER_DTS (inbuf) = 0;
+  gst_harness_push (h, gst_buffer_ref (inbuf));
+  outbuf = gst_harness_pull (h);
+  fail_unless (gst_buffer_peek_memory (outbuf, 0) ==
+      gst_buffer_peek_memory (inbuf, 0));
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), 0);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuf),
+      100 * GST_MSECOND);
+  fail_unless (!GST_BUFFER_DTS_IS_VALID (outbuf));
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  /* Once it doesn't cover the output anymore, it's blended again */
+  pad = gst_element_get_static_pad (comp, "sink_0");
+  g_object_set (pad, "xpos", 2, NULL);
+  gst_object_unref (pad);
+
+  inbuf = _new_filled_i420_buffer (64, 48, 80, 100 * GST_MSECOND,
+      100 * GST_MSECOND);
+  gst_harness_push (h, gst_buffer_ref (inbuf));
+  outbuf = gst_harness_pull (h);
+  fail_unless (gst_buffer_peek_memory (outbuf, 0) !=
+      gst_buffer_peek_memory (inbuf, 0));
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), 100 * GST_MSECOND);
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+
+  g_object_get (comp, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "frames-passthrough", &val));
+  fail_unless_equals_uint64 (val, 1);
+  fail_unless (gst_structure_get_uint64 (stats, "frames-full", &val));
+  fail_unless_equals_uint64 (val, 1);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
 static Suite *
 compositor_suite (void)
 {
@@ -2308,6 +2564,9 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
   tcase_add_test (tc_chain, test_signals);
+  tcase_add_test (tc_chain, test_incremental);
+  tcase_add_test (tc_chain, test_obscured_by_combination);
+  tcase_add_test (tc_chain, test_passthrough);
 
   return s;
 }
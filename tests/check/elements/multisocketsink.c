@@ -965,6 +965,148 @@ GST_START_TEST (test_client_next_keyframe)
 
 GST_END_TEST;
 
+static void
+client_removed_cb (GstElement * sink, GSocket * socket, gint status,
+    gint * n_slow)
+{
+  if (status == 3)              /* 3 = GST_CLIENT_STATUS_SLOW */
+    g_atomic_int_inc (n_slow);
+}
+
+/* waits at most 10 seconds for the sink to have @n_handles clients */
+static gboolean
+wait_num_handles (GstElement * sink, guint n_handles)
+{
+  gint64 end_time = g_get_monotonic_time () + 10 * G_USEC_PER_SEC;
+  guint num_handles;
+
+  do {
+    g_object_get (sink, "num-handles", &num_handles, NULL);
+    if (num_handles == n_handles)
+      return TRUE;
+    g_usleep (G_USEC_PER_SEC / 100);
+  } while (g_get_monotonic_time () < end_time);
+
+  return FALSE;
+}
+
+/* Check that idle clients are removed in the order they became idle, also
+ * when no more buffers are pushed */
+GST_START_TEST (test_client_timeout)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *socket[2];
+  GSocket *sinksockets[200], *srcsockets[200];
+  gint n_slow = 0;
+  guint i;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "timeout", GST_SECOND, NULL);
+  g_signal_connect (sink, "client-removed", G_CALLBACK (client_removed_cb),
+      &n_slow);
+
+  fail_unless (setup_handles (&socket[0], &socket[1]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  g_signal_emit_by_name (sink, "add", socket[0]);
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (0)) == GST_FLOW_OK);
+  fail_unless_read ("client 1", socket[1], 16, "deadbee00000000");
+
+  /* the clients added later are active for longer */
+  g_usleep (G_USEC_PER_SEC / 2);
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i++) {
+    fail_unless (setup_handles (&sinksockets[i], &srcsockets[i]));
+    g_signal_emit_by_name (sink, "add", sinksockets[i]);
+  }
+
+  /* the first client goes away first, without any more buffers */
+  fail_unless (wait_num_handles (sink, G_N_ELEMENTS (sinksockets)));
+  fail_unless_equals_int (g_atomic_int_get (&n_slow), 1);
+
+  fail_unless (wait_num_handles (sink, 0));
+  fail_unless_equals_int (g_atomic_int_get (&n_slow),
+      G_N_ELEMENTS (sinksockets) + 1);
+
+  GST_DEBUG ("cleaning up multisocketsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  g_object_unref (socket[0]);
+  g_object_unref (socket[1]);
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i++) {
+    g_object_unref (sinksockets[i]);
+    g_object_unref (srcsockets[i]);
+  }
+}
+
+GST_END_TEST;
+
+/* Check that clients spread over several I/O threads get all their data and
+ * can be removed while the other threads keep writing */
+GST_START_TEST (test_n_threads)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GSocket *sinksockets[8], *srcsockets[8];
+  gchar ref[17];
+  guint i, j;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "n-threads", 4, NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i++) {
+    fail_unless (setup_handles (&sinksockets[i], &srcsockets[i]));
+    g_signal_emit_by_name (sink, "add", sinksockets[i]);
+  }
+  fail_unless_num_handles (sink, G_N_ELEMENTS (sinksockets));
+
+  for (j = 0; j < 3; j++)
+    fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (j)) == GST_FLOW_OK);
+
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i++) {
+    for (j = 0; j < 3; j++) {
+      g_snprintf (ref, sizeof (ref), "deadbee%08x", j);
+      fail_unless_read ("client", srcsockets[i], 16, ref);
+    }
+  }
+
+  /* remove every other client */
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i += 2)
+    g_signal_emit_by_name (sink, "remove", sinksockets[i]);
+  fail_unless_num_handles (sink, G_N_ELEMENTS (sinksockets) / 2);
+
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (3)) == GST_FLOW_OK);
+  for (i = 1; i < G_N_ELEMENTS (sinksockets); i += 2)
+    fail_unless_read ("client", srcsockets[i], 16, "deadbee00000003");
+
+  GST_DEBUG ("cleaning up multisocketsink");
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  ASSERT_CAPS_REFCOUNT (caps, "caps", 1);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < G_N_ELEMENTS (sinksockets); i++) {
+    g_object_unref (sinksockets[i]);
+    g_object_unref (srcsockets[i]);
+  }
+}
+
+GST_END_TEST;
+
 /* FIXME: add test simulating chained oggs where:
  * sync-method is burst-on-connect
  * (when multisocketsink actually does burst-on-connect based on byte size, not
@@ -988,6 +1130,8 @@ multisocketsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
+  tcase_add_test (tc_chain, test_client_timeout);
+  tcase_add_test (tc_chain, test_n_threads);
 
   return s;
 }
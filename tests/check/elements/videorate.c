@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -1589,6 +1590,57 @@ GST_START_TEST (test_nopts_in_middle)
 
 GST_END_TEST;
 
+/* test flagging of duplicated frames */
+GST_START_TEST (test_mark_duplicates)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second, *buf;
+  GstMemory *mem;
+  GstCaps *caps;
+  guint64 repeated_bytes;
+  GList *l;
+
+  videorate = setup_videorate_full (&srctemplate, &downstreamsinktemplate);
+  g_object_set (videorate, "mark-duplicates", TRUE, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  gst_buffer_memset (first, 0, 1, 4);
+  mem = gst_buffer_peek_memory (first, 0);
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = 2 * GST_SECOND;
+  gst_buffer_memset (second, 0, 2, 4);
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+
+  fail_unless_equals_int (g_list_length (buffers), 26);
+  assert_videorate_stats (videorate, "second", 2, 26, 0, 25);
+
+  /* All buffers are references to the first one, only the duplicates are
+   * flagged as repeats */
+  for (l = buffers; l; l = l->next) {
+    buf = l->data;
+    fail_unless (gst_buffer_peek_memory (buf, 0) == mem);
+    fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (buf,
+            GST_VIDEO_BUFFER_FLAG_REPEATED), l != buffers);
+  }
+
+  g_object_get (videorate, "repeated-bytes", &repeated_bytes, NULL);
+  fail_unless_equals_uint64 (repeated_bytes, 25 * 4);
+
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 /* test segment update */
 GST_START_TEST (test_segment_update)
 {
@@ -1855,6 +1907,7 @@ videorate_suite (void)
       G_N_ELEMENTS (position_tests));
   tcase_add_test (tc_chain, test_nopts_in_middle);
   tcase_add_test (tc_chain, test_segment_update);
+  tcase_add_test (tc_chain, test_mark_duplicates);
   tcase_add_test (tc_chain, test_segment_closing);
 
   return s;
@@ -28,9 +28,12 @@
 #include <fcntl.h>
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/allocators/gstfdmemory.h>
+#include <gst/allocators/gstshmallocator.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #define FILE_SIZE 4096
@@ -101,6 +104,169 @@ GST_START_TEST (test_fdmem)
 
 GST_END_TEST;
 
+GST_START_TEST (test_shm_fork)
+{
+  GstAllocator *alloc;
+  GstMemory *mem;
+  GstMapInfo info;
+  int fd, status;
+  pid_t pid;
+
+  alloc = gst_shm_allocator_new (GST_SHM_ALLOCATOR_FLAG_NONE);
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, NULL);
+  fail_unless (mem != NULL);
+  fail_unless (gst_is_shm_memory (mem));
+  fail_unless (gst_is_fd_memory (mem));
+
+  fd = gst_fd_memory_get_fd (mem);
+  fail_unless (fd >= 0);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless (info.size == FILE_SIZE);
+  memset (info.data, 0x42, info.size);
+  gst_memory_unmap (mem, &info);
+
+  pid = fork ();
+  fail_unless (pid >= 0);
+
+  if (pid == 0) {
+    /* Map the fd independently, as a process receiving it would do */
+    guint8 *data = mmap (NULL, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED,
+        fd, 0);
+    gsize i;
+
+    if (data == MAP_FAILED)
+      _exit (1);
+    for (i = 0; i < FILE_SIZE; i++) {
+      if (data[i] != 0x42)
+        _exit (2);
+    }
+    data[0] = 0x17;
+    data[FILE_SIZE - 1] = 0x71;
+    munmap (data, FILE_SIZE);
+    _exit (0);
+  }
+
+  fail_unless (waitpid (pid, &status, 0) == pid);
+  fail_unless (WIFEXITED (status));
+  fail_unless_equals_int (WEXITSTATUS (status), 0);
+
+  /* The writes of the child are visible without copying anything */
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.data[0], 0x17);
+  fail_unless_equals_int (info.data[1], 0x42);
+  fail_unless_equals_int (info.data[FILE_SIZE - 1], 0x71);
+  gst_memory_unmap (mem, &info);
+
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_shm_seal)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstMemory *mem, *imported;
+  GstMapInfo info;
+  GError *error = NULL;
+  int fd, dup_fd;
+
+  alloc = gst_shm_allocator_new (GST_SHM_ALLOCATOR_FLAG_SEAL);
+
+  gst_allocation_params_init (&params);
+  params.prefix = 16;
+  params.padding = 32;
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, &params);
+  fail_unless (mem != NULL);
+  fail_unless_equals_int (mem->offset, 16);
+  fail_unless_equals_int (mem->size, FILE_SIZE);
+  fail_unless (mem->maxsize >= FILE_SIZE + 16 + 32);
+
+  fd = gst_fd_memory_get_fd (mem);
+#ifdef F_GET_SEALS
+  {
+    int seals = fcntl (fd, F_GET_SEALS);
+
+    fail_unless (seals & F_SEAL_SHRINK);
+    fail_unless (seals & F_SEAL_GROW);
+    fail_unless (seals & F_SEAL_SEAL);
+  }
+#endif
+  /* Nobody can change the size under the mapping anymore */
+  fail_unless (ftruncate (fd, 0) < 0);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  info.data[0] = 'S';
+  gst_memory_unmap (mem, &info);
+
+  /* A sealed fd is accepted for import and shares the same pages */
+  dup_fd = dup (fd);
+  fail_unless (dup_fd >= 0);
+  imported = gst_shm_allocator_import (alloc, dup_fd, mem->maxsize);
+  fail_unless (imported != NULL);
+  fail_unless (gst_is_shm_memory (imported));
+  fail_unless (gst_memory_map (imported, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.data[16], 'S');
+  gst_memory_unmap (imported, &info);
+  gst_memory_unref (imported);
+
+  /* but not if it's too small */
+  dup_fd = dup (fd);
+  fail_unless (gst_shm_allocator_import (alloc, dup_fd,
+          mem->maxsize + 1) == NULL);
+  close (dup_fd);
+
+  /* An unsealed file is refused */
+  fd = g_file_open_tmp (NULL, NULL, &error);
+  fail_if (error);
+  fail_unless (ftruncate (fd, FILE_SIZE) == 0);
+  fail_unless (gst_shm_allocator_import (alloc, fd, FILE_SIZE) == NULL);
+  close (fd);
+
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_shm_pool)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstAllocator *alloc = NULL;
+  GstBuffer *buf;
+  GstMapInfo info;
+
+  pool = gst_shm_buffer_pool_new (GST_SHM_ALLOCATOR_FLAG_SEAL |
+      GST_SHM_ALLOCATOR_FLAG_HUGE_PAGES);
+
+  config = gst_buffer_pool_get_config (pool);
+  fail_unless (gst_buffer_pool_config_get_allocator (config, &alloc, NULL));
+  fail_unless (GST_IS_SHM_ALLOCATOR (alloc));
+  gst_buffer_pool_config_set_params (config, NULL, FILE_SIZE, 2, 0);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  /* Huge pages may not be available, allocation must work regardless */
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 1);
+  fail_unless (gst_is_shm_memory (gst_buffer_peek_memory (buf, 0)));
+  fail_unless_equals_int (gst_buffer_get_size (buf), FILE_SIZE);
+
+  fail_unless (gst_buffer_map (buf, &info, GST_MAP_READWRITE));
+  memset (info.data, 0, info.size);
+  gst_buffer_unmap (buf, &info);
+
+  gst_buffer_unref (buf);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -110,6 +276,9 @@ allocators_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
   tcase_add_test (tc_chain, test_fdmem);
+  tcase_add_test (tc_chain, test_shm_fork);
+  tcase_add_test (tc_chain, test_shm_seal);
+  tcase_add_test (tc_chain, test_shm_pool);
 
   return s;
 }
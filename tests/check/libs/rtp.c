@@ -819,6 +819,100 @@ GST_START_TEST (test_rtcp_buffer)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtcp_buffer_get_packets_add_next)
+{
+  GstBuffer *buf;
+  GstRTCPPacket packet;
+  GstRTCPPacket packets[8];
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  guint32 ssrc;
+  guint i;
+
+  buf = gst_rtcp_buffer_new (1400);
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets,
+          G_N_ELEMENTS (packets)), 0);
+
+  /* build a compound packet, each packet after the previous one */
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_SR, &packet));
+  gst_rtcp_packet_sr_set_sender_info (&packet, 0x44556677,
+      G_GUINT64_CONSTANT (1), 0x11111111, 101, 123456);
+  fail_unless (gst_rtcp_packet_add_rb (&packet, 0x11, 0, 0, 0, 0, 0, 0));
+  fail_unless (gst_rtcp_packet_add_rb (&packet, 0x22, 0, 0, 0, 0, 0, 0));
+
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_SDES));
+  fail_unless (gst_rtcp_packet_sdes_add_item (&packet, 0x44556677));
+  fail_unless (gst_rtcp_packet_sdes_add_entry (&packet, GST_RTCP_SDES_CNAME,
+          sizeof ("test@foo.bar"), (guint8 *) "test@foo.bar"));
+
+  /* the length of feedback packets is updated through the FCI */
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_RTPFB));
+  gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_RTPFB_TYPE_NACK);
+  gst_rtcp_packet_fb_set_sender_ssrc (&packet, 0x44556677);
+  gst_rtcp_packet_fb_set_media_ssrc (&packet, 0x11);
+  fail_unless (gst_rtcp_packet_fb_set_fci_length (&packet, 2));
+  GST_WRITE_UINT32_BE (gst_rtcp_packet_fb_get_fci (&packet), 0x12345678);
+  GST_WRITE_UINT32_BE (gst_rtcp_packet_fb_get_fci (&packet) + 4, 0x9abcdef0);
+
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_PSFB));
+  gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_PSFB_TYPE_PLI);
+  gst_rtcp_packet_fb_set_media_ssrc (&packet, 0x22);
+
+  /* not pointing to the last packet anymore, this has to find the end */
+  fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_BYE));
+  fail_unless (gst_rtcp_packet_bye_add_ssrc (&packet, 0x44556677));
+
+  fail_unless_equals_int (gst_rtcp_buffer_get_packet_count (&rtcp), 5);
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets, 2), 2);
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets,
+          G_N_ELEMENTS (packets)), 5);
+
+  /* the index matches iterating over the packets */
+  fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+  for (i = 0; i < 5; i++) {
+    fail_unless_equals_int (packets[i].offset, packet.offset);
+    fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[i]),
+        gst_rtcp_packet_get_type (&packet));
+    fail_unless_equals_int (gst_rtcp_packet_get_count (&packets[i]),
+        gst_rtcp_packet_get_count (&packet));
+    fail_unless_equals_int (gst_rtcp_packet_get_length (&packets[i]),
+        gst_rtcp_packet_get_length (&packet));
+    fail_unless (gst_rtcp_packet_move_to_next (&packet) == (i < 4));
+  }
+
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[0]),
+      GST_RTCP_TYPE_SR);
+  fail_unless_equals_int (gst_rtcp_packet_get_rb_count (&packets[0]), 2);
+  gst_rtcp_packet_get_rb (&packets[0], 1, &ssrc, NULL, NULL, NULL, NULL, NULL,
+      NULL);
+  fail_unless_equals_int (ssrc, 0x22);
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[1]),
+      GST_RTCP_TYPE_SDES);
+  fail_unless_equals_int (gst_rtcp_packet_sdes_get_ssrc (&packets[1]),
+      0x44556677);
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[2]),
+      GST_RTCP_TYPE_RTPFB);
+  fail_unless_equals_int (gst_rtcp_packet_fb_get_fci_length (&packets[2]), 2);
+  fail_unless_equals_int (GST_READ_UINT32_BE (gst_rtcp_packet_fb_get_fci
+          (&packets[2]) + 4), 0x9abcdef0);
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[3]),
+      GST_RTCP_TYPE_PSFB);
+  fail_unless_equals_int (gst_rtcp_packet_fb_get_media_ssrc (&packets[3]),
+      0x22);
+  fail_unless_equals_int (gst_rtcp_packet_get_type (&packets[4]),
+      GST_RTCP_TYPE_BYE);
+  fail_unless_equals_int (gst_rtcp_packet_bye_get_nth_ssrc (&packets[4], 0),
+      0x44556677);
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  fail_unless (gst_rtcp_buffer_validate (buf));
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtcp_reduced_buffer)
 {
   GstBuffer *buf;
@@ -1130,6 +1224,280 @@ GST_START_TEST (test_rtcp_validate_and_parse_padded_chrome_twcc)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtcp_twcc_parse_chrome)
+{
+  GstBuffer *buffer;
+  GstRTCPPacket packet;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPTWCCStatus statuses[3];
+  guint16 base_seqnum, status_count;
+  gint32 reference_time;
+  guint8 fb_pkt_count;
+
+  guint8 rtcp_pkt[] = {
+    0xaf, 0xcd, 0x00, 0x06,     /* P=1, FMT=15, FTPT=205(FB), length=6 (x4 = 24 bytes) */
+    0xce, 0x0d, 0xc2, 0xb3,     /* SSRC of packet sender  */
+    0x53, 0xf6, 0x11, 0x3b,     /* SSRC of media source  */
+    0x00, 0x34, 0x00, 0x03,     /* base seqnum = 52, packet status count = 3 */
+    0x00, 0xce, 0x3f, 0x01,     /* reference time = 52799, fb pkt count = 1 */
+    0x20, 0x03, 0x94, 0x50,     /* run length chunk, 3 small deltas, 148, 80 */
+    0x50, 0x00, 0x00, 0x03      /* 80, 3x padding bytes */
+  };
+
+  buffer = gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+      rtcp_pkt, sizeof (rtcp_pkt), 0, sizeof (rtcp_pkt), NULL, NULL);
+
+  gst_rtcp_buffer_map (buffer, GST_MAP_READ, &rtcp);
+  fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+
+  fail_unless (gst_rtcp_packet_twcc_get_info (&packet, &base_seqnum,
+          &status_count, &reference_time, &fb_pkt_count));
+  fail_unless_equals_int (base_seqnum, 52);
+  fail_unless_equals_int (status_count, 3);
+  fail_unless_equals_int (reference_time, 52799);
+  fail_unless_equals_int (fb_pkt_count, 1);
+
+  fail_if (gst_rtcp_packet_twcc_get_statuses (&packet, statuses, 2));
+  fail_unless (gst_rtcp_packet_twcc_get_statuses (&packet, statuses, 3));
+  fail_unless_equals_int (statuses[0].seqnum, 52);
+  fail_unless (statuses[0].received);
+  fail_unless_equals_int (statuses[0].delta, 148);
+  fail_unless_equals_int (statuses[1].seqnum, 53);
+  fail_unless (statuses[1].received);
+  fail_unless_equals_int (statuses[1].delta, 80);
+  fail_unless_equals_int (statuses[2].seqnum, 54);
+  fail_unless (statuses[2].received);
+  fail_unless_equals_int (statuses[2].delta, 80);
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtcp_twcc_write_chrome)
+{
+  GstBuffer *buffer;
+  GstRTCPPacket packet;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPTWCCStatus statuses[] = {
+    {55, TRUE, 132},
+    {56, TRUE, 80},
+  };
+  guint8 rtcp_pkt[] = {
+    0x8f, 0xcd, 0x00, 0x05,     /* P=0, FMT=15, PT=205(FB), length=5 (x4 = 20 bytes) */
+    0xce, 0x0d, 0xc2, 0xb3,     /* SSRC of packet sender  */
+    0x53, 0xf6, 0x11, 0x3b,     /* SSRC of media source  */
+    0x00, 0x37, 0x00, 0x02,     /* base seqnum = 55, packet status count = 2 */
+    0x00, 0xce, 0x40, 0x02,     /* reference time = 52800, fb pkt count = 2 */
+    0x20, 0x02, 0x84, 0x50      /* run length chunk, 2 small deltas, 132, 80 */
+  };
+
+  buffer = gst_rtcp_buffer_new (1400);
+  gst_rtcp_buffer_map (buffer, GST_MAP_READWRITE, &rtcp);
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB,
+          &packet));
+  gst_rtcp_packet_fb_set_sender_ssrc (&packet, 0xce0dc2b3);
+  gst_rtcp_packet_fb_set_media_ssrc (&packet, 0x53f6113b);
+  fail_unless (gst_rtcp_packet_twcc_set_statuses (&packet, 52800, 2,
+          statuses, G_N_ELEMENTS (statuses)));
+  gst_rtcp_buffer_unmap (&rtcp);
+
+  fail_unless (gst_rtcp_buffer_validate_reduced (buffer));
+  fail_unless_equals_int (gst_buffer_get_size (buffer), sizeof (rtcp_pkt));
+  fail_unless (gst_buffer_memcmp (buffer, 0, rtcp_pkt, sizeof (rtcp_pkt)) == 0);
+
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+#define TWCC_MAX_STATUSES 4000
+
+static void
+create_twcc_statuses (GRand * rand, GstRTCPTWCCStatus * statuses, guint n)
+{
+  guint16 seqnum = g_rand_int (rand);
+  guint i = 0;
+
+  while (i < n) {
+    /* alternate between runs of the same status, which are stored in run
+     * length chunks, and mixed statuses */
+    guint len = g_rand_int_range (rand, 1, 200);
+    gboolean run = g_rand_boolean (rand);
+    gint kind = g_rand_int_range (rand, 0, 3);
+
+    len = MIN (len, n - i);
+    for (; len > 0; len--, i++) {
+      if (!run)
+        kind = g_rand_int_range (rand, 0, 3);
+
+      statuses[i].seqnum = seqnum + i;
+      statuses[i].received = kind != 0;
+      if (kind == 1)
+        statuses[i].delta = g_rand_int_range (rand, 0, 256);
+      else if (kind == 2)
+        statuses[i].delta = g_rand_boolean (rand) ?
+            g_rand_int_range (rand, G_MININT16, 0) :
+            g_rand_int_range (rand, 256, G_MAXINT16 + 1);
+      else
+        statuses[i].delta = 0;
+    }
+  }
+}
+
+GST_START_TEST (test_rtcp_twcc_roundtrip)
+{
+  GstRTCPTWCCStatus *statuses, *result;
+  GRand *rand = g_rand_new_with_seed (1);
+  guint i, j;
+
+  statuses = g_new (GstRTCPTWCCStatus, TWCC_MAX_STATUSES);
+  result = g_new (GstRTCPTWCCStatus, TWCC_MAX_STATUSES);
+
+  for (i = 0; i < 200; i++) {
+    GstBuffer *buffer;
+    GstRTCPPacket packet;
+    GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+    guint n = g_rand_int_range (rand, 1, TWCC_MAX_STATUSES);
+    guint16 base_seqnum, status_count;
+    gint32 reference_time;
+    guint8 fb_pkt_count;
+
+    create_twcc_statuses (rand, statuses, n);
+
+    buffer = gst_rtcp_buffer_new (4 * TWCC_MAX_STATUSES);
+    gst_rtcp_buffer_map (buffer, GST_MAP_READWRITE, &rtcp);
+    fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB,
+            &packet));
+    fail_unless (gst_rtcp_packet_twcc_set_statuses (&packet, -i, i, statuses,
+            n));
+    gst_rtcp_buffer_unmap (&rtcp);
+
+    fail_unless (gst_rtcp_buffer_validate_reduced (buffer));
+
+    gst_rtcp_buffer_map (buffer, GST_MAP_READ, &rtcp);
+    fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+    fail_unless (gst_rtcp_packet_twcc_get_info (&packet, &base_seqnum,
+            &status_count, &reference_time, &fb_pkt_count));
+    fail_unless_equals_int (base_seqnum, statuses[0].seqnum);
+    fail_unless_equals_int (status_count, n);
+    fail_unless_equals_int (reference_time, -(gint32) i);
+    fail_unless_equals_int (fb_pkt_count, i);
+
+    fail_unless (gst_rtcp_packet_twcc_get_statuses (&packet, result, n));
+    for (j = 0; j < n; j++) {
+      fail_unless_equals_int (result[j].seqnum, statuses[j].seqnum);
+      fail_unless_equals_int (result[j].received, statuses[j].received);
+      if (statuses[j].received)
+        fail_unless_equals_int (result[j].delta, statuses[j].delta);
+    }
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_unref (buffer);
+  }
+
+  g_free (statuses);
+  g_free (result);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtcp_twcc_invalid)
+{
+  GstRTCPTWCCStatus statuses[16] = { {0,}, };
+  GstRTCPPacket packet;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstBuffer *buffer;
+
+  buffer = gst_rtcp_buffer_new (1400);
+  gst_rtcp_buffer_map (buffer, GST_MAP_READWRITE, &rtcp);
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB,
+          &packet));
+
+  /* no FCI */
+  gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_RTPFB_TYPE_TWCC);
+  fail_if (gst_rtcp_packet_twcc_get_info (&packet, NULL, NULL, NULL, NULL));
+
+  /* not consecutive */
+  statuses[0].seqnum = 10;
+  statuses[1].seqnum = 12;
+  fail_if (gst_rtcp_packet_twcc_set_statuses (&packet, 0, 0, statuses, 2));
+
+  /* delta out of range */
+  statuses[1].seqnum = 11;
+  statuses[1].received = TRUE;
+  statuses[1].delta = G_MAXINT16 + 1;
+  fail_if (gst_rtcp_packet_twcc_set_statuses (&packet, 0, 0, statuses, 2));
+  statuses[1].delta = G_MAXINT16;
+  fail_unless (gst_rtcp_packet_twcc_set_statuses (&packet, 0, 0, statuses, 2));
+  fail_unless (gst_rtcp_packet_twcc_get_statuses (&packet, statuses, 2));
+  fail_unless_equals_int (statuses[1].delta, G_MAXINT16);
+
+  /* not TWCC */
+  gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_RTPFB_TYPE_NACK);
+  fail_if (gst_rtcp_packet_twcc_get_info (&packet, NULL, NULL, NULL, NULL));
+  fail_if (gst_rtcp_packet_twcc_get_statuses (&packet, statuses, 2));
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtcp_twcc_fuzz)
+{
+  GstRTCPTWCCStatus *statuses;
+  GRand *rand = g_rand_new_with_seed (2);
+  guint i, j;
+
+  statuses = g_new (GstRTCPTWCCStatus, G_MAXUINT16);
+
+  for (i = 0; i < 10000; i++) {
+    GstBuffer *buffer;
+    GstRTCPPacket packet;
+    GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+    guint fci_len = 4 * g_rand_int_range (rand, 0, 32);
+    guint8 *fci;
+
+    buffer = gst_rtcp_buffer_new (1400);
+    gst_rtcp_buffer_map (buffer, GST_MAP_READWRITE, &rtcp);
+    fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB,
+            &packet));
+    gst_rtcp_packet_fb_set_type (&packet, GST_RTCP_RTPFB_TYPE_TWCC);
+    fail_unless (gst_rtcp_packet_fb_set_fci_length (&packet, fci_len / 4));
+
+    /* random FCI with a small status count to reach the deltas */
+    fci = gst_rtcp_packet_fb_get_fci (&packet);
+    for (j = 0; j < fci_len; j++)
+      fci[j] = g_rand_int (rand);
+    if (fci_len >= 4 && g_rand_boolean (rand))
+      GST_WRITE_UINT16_BE (fci + 2, g_rand_int_range (rand, 0, 64));
+    gst_rtcp_buffer_unmap (&rtcp);
+
+    gst_rtcp_buffer_map (buffer, GST_MAP_READ, &rtcp);
+    fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &packet));
+    if (gst_rtcp_packet_twcc_get_statuses (&packet, statuses, G_MAXUINT16)) {
+      guint16 status_count;
+
+      fail_unless (gst_rtcp_packet_twcc_get_info (&packet, NULL,
+              &status_count, NULL, NULL));
+      for (j = 0; j < status_count; j++) {
+        if (statuses[j].received)
+          fail_unless (statuses[j].delta >= G_MININT16
+              && statuses[j].delta <= G_MAXINT16);
+      }
+    }
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_unref (buffer);
+  }
+
+  g_free (statuses);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtcp_buffer_profile_specific_extension)
 {
   GstBuffer *buf;
@@ -1880,6 +2248,84 @@ GST_START_TEST (test_rtp_buffer_get_extension_bytes)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtp_buffer_map_payload_vectors)
+{
+  const gchar *parts[] = { "Hello", " ", "World" };
+  GstRTPPayloadVector vectors[4];
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf;
+  gchar data[16];
+  guint i, n;
+
+  /* header and payload in separate memories, like payloaders produce */
+  buf = gst_rtp_buffer_new_allocate (0, 0, 0);
+  for (i = 0; i < G_N_ELEMENTS (parts); i++)
+    gst_buffer_append_memory (buf, gst_memory_new_wrapped (0,
+            (gpointer) parts[i], strlen (parts[i]), 0, strlen (parts[i]),
+            NULL, NULL));
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 4);
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 11);
+
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_n_vectors (&rtp, 0, -1),
+      3);
+  n = gst_rtp_buffer_map_payload_vectors (&rtp, 0, -1, vectors,
+      G_N_ELEMENTS (vectors));
+  fail_unless_equals_int (n, 3);
+  for (i = 0; i < n; i++) {
+    fail_unless_equals_int (vectors[i].size, strlen (parts[i]));
+    fail_unless (memcmp (vectors[i].data, parts[i], vectors[i].size) == 0);
+  }
+  gst_rtp_buffer_unmap_payload_vectors (&rtp, vectors, n);
+
+  /* a range over all memories */
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_n_vectors (&rtp, 3, 5),
+      3);
+  n = gst_rtp_buffer_map_payload_vectors (&rtp, 3, 5, vectors,
+      G_N_ELEMENTS (vectors));
+  fail_unless_equals_int (n, 3);
+  fail_unless_equals_int (vectors[0].size, 2);
+  fail_unless (memcmp (vectors[0].data, "lo", 2) == 0);
+  fail_unless_equals_int (vectors[1].size, 1);
+  fail_unless (memcmp (vectors[1].data, " ", 1) == 0);
+  fail_unless_equals_int (vectors[2].size, 2);
+  fail_unless (memcmp (vectors[2].data, "Wo", 2) == 0);
+  gst_rtp_buffer_unmap_payload_vectors (&rtp, vectors, n);
+
+  /* a range in a single memory */
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_n_vectors (&rtp, 7, -1),
+      1);
+
+  /* not enough vectors */
+  n = gst_rtp_buffer_map_payload_vectors (&rtp, 0, -1, vectors, 2);
+  fail_unless_equals_int (n, 2);
+  fail_unless_equals_int (vectors[1].size, 1);
+  gst_rtp_buffer_unmap_payload_vectors (&rtp, vectors, n);
+
+  /* empty or out of range */
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_n_vectors (&rtp, 11, -1),
+      0);
+  fail_unless_equals_int (gst_rtp_buffer_map_payload_vectors (&rtp, 12, -1,
+          vectors, G_N_ELEMENTS (vectors)), 0);
+
+  /* reading across memories */
+  fail_unless_equals_int (gst_rtp_buffer_extract_payload (&rtp, 4, data, 3),
+      3);
+  fail_unless (memcmp (data, "o W", 3) == 0);
+  fail_unless_equals_int (gst_rtp_buffer_extract_payload (&rtp, 8, data,
+          sizeof (data)), 3);
+  fail_unless (memcmp (data, "rld", 3) == 0);
+
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* nothing was merged */
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 4);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtp_buffer_get_payload_bytes)
 {
   guint8 rtppacket[] = {
@@ -2491,6 +2937,7 @@ rtp_suite (void)
 
   tcase_add_test (tc_chain, test_rtcp_sdes_type);
   tcase_add_test (tc_chain, test_rtcp_buffer);
+  tcase_add_test (tc_chain, test_rtcp_buffer_get_packets_add_next);
   tcase_add_test (tc_chain, test_rtcp_reduced_buffer);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding_wrong_padlength);
@@ -2505,6 +2952,11 @@ rtp_suite (void)
       test_rtcp_validate_reduced_with_invalid_padding_and_length);
   tcase_add_test (tc_chain, test_rtcp_validate_and_parse_chrome_twcc);
   tcase_add_test (tc_chain, test_rtcp_validate_and_parse_padded_chrome_twcc);
+  tcase_add_test (tc_chain, test_rtcp_twcc_parse_chrome);
+  tcase_add_test (tc_chain, test_rtcp_twcc_write_chrome);
+  tcase_add_test (tc_chain, test_rtcp_twcc_roundtrip);
+  tcase_add_test (tc_chain, test_rtcp_twcc_invalid);
+  tcase_add_test (tc_chain, test_rtcp_twcc_fuzz);
 
   tcase_add_test (tc_chain, test_rtcp_buffer_profile_specific_extension);
   tcase_add_test (tc_chain, test_rtcp_buffer_app);
@@ -2520,6 +2972,7 @@ rtp_suite (void)
   tcase_add_test (tc_chain, test_rtp_ntp56_extension);
 
   tcase_add_test (tc_chain, test_rtp_buffer_get_payload_bytes);
+  tcase_add_test (tc_chain, test_rtp_buffer_map_payload_vectors);
   tcase_add_test (tc_chain, test_rtp_buffer_get_extension_bytes);
   tcase_add_test (tc_chain, test_rtp_buffer_empty_payload);
 
@@ -2052,6 +2052,62 @@ GST_START_TEST (rtp_base_payload_two_byte_hdr_ext)
 
 GST_END_TEST;
 
+GST_START_TEST (rtp_base_payload_hdr_ext_max_size)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstRTPHeaderExtension *ext1, *ext2;
+  GstBuffer *buf;
+  gpointer data;
+  guint size;
+  State *state;
+
+  state = create_payloader ("application/x-rtp", &sinktmpl, NULL);
+  /* reserve more than what is written, the unused space must not end up in
+   * the packet */
+  ext1 = rtp_dummy_hdr_ext_new ();
+  GST_RTP_DUMMY_HDR_EXT (ext1)->max_size = 16;
+  gst_rtp_header_extension_set_id (ext1, 1);
+  ext2 = rtp_dummy_hdr_ext_new ();
+  GST_RTP_DUMMY_HDR_EXT (ext2)->max_size = 16;
+  gst_rtp_header_extension_set_id (ext2, 2);
+
+  g_signal_emit_by_name (state->element, "add-extension", ext1);
+  g_signal_emit_by_name (state->element, "add-extension", ext2);
+
+  set_state (state, GST_STATE_PLAYING);
+
+  push_buffer (state, "pts", 0 * GST_SECOND, NULL);
+
+  set_state (state, GST_STATE_NULL);
+
+  validate_buffers_received (1);
+
+  buf = GST_BUFFER (g_list_nth_data (buffers, 0));
+  /* header, 4 bytes of extension data and the 12 bytes input buffer */
+  fail_unless_equals_int (gst_buffer_get_size (buf), 12 + 4 + 4 + 12);
+
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 12);
+  fail_unless (gst_rtp_buffer_get_extension_data (&rtp, NULL, NULL, &size));
+  fail_unless_equals_int (size, 1);
+  fail_unless (gst_rtp_buffer_get_extension_onebyte_header (&rtp, 1, 0, &data,
+          &size));
+  fail_unless_equals_int (size, 1);
+  fail_unless (gst_rtp_buffer_get_extension_onebyte_header (&rtp, 2, 0, &data,
+          &size));
+  fail_unless_equals_int (size, 1);
+  gst_rtp_buffer_unmap (&rtp);
+
+  fail_unless_equals_int (GST_RTP_DUMMY_HDR_EXT (ext1)->write_count, 1);
+  fail_unless_equals_int (GST_RTP_DUMMY_HDR_EXT (ext2)->write_count, 1);
+
+  gst_object_unref (ext1);
+  gst_object_unref (ext2);
+  destroy_payloader (state);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (rtp_base_payload_clear_extensions)
 {
   GstRTPHeaderExtension *ext;
@@ -2306,6 +2362,7 @@ rtp_basepayloading_suite (void)
 
   tcase_add_test (tc_chain, rtp_base_payload_one_byte_hdr_ext);
   tcase_add_test (tc_chain, rtp_base_payload_two_byte_hdr_ext);
+  tcase_add_test (tc_chain, rtp_base_payload_hdr_ext_max_size);
   tcase_add_test (tc_chain, rtp_base_payload_clear_extensions);
   tcase_add_test (tc_chain, rtp_base_payload_multiple_exts);
   tcase_add_test (tc_chain, rtp_base_payload_caps_request);
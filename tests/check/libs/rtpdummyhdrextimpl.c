@@ -51,6 +51,7 @@ struct _GstRTPDummyHdrExt
   GstRTPHeaderExtension payload;
 
   GstRTPHeaderExtensionFlags supported_flags;
+  gsize max_size;
   guint read_count;
   guint write_count;
   guint set_attributes_count;
@@ -130,6 +131,7 @@ gst_rtp_dummy_hdr_ext_init (GstRTPDummyHdrExt * dummy)
 {
   dummy->supported_flags =
       GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+  dummy->max_size = 1;
 }
 
 static void
@@ -160,10 +162,12 @@ gst_rtp_dummy_hdr_ext_get_supported_flags (GstRTPHeaderExtension * ext)
 }
 
 static gsize
-gst_rtp_dummy_hdr_ext_get_max_size (G_GNUC_UNUSED GstRTPHeaderExtension * ext,
+gst_rtp_dummy_hdr_ext_get_max_size (GstRTPHeaderExtension * ext,
     G_GNUC_UNUSED const GstBuffer * input_meta)
 {
-  return 1;
+  GstRTPDummyHdrExt *dummy = GST_RTP_DUMMY_HDR_EXT (ext);
+
+  return dummy->max_size;
 }
 
 #define TEST_DATA_BYTE 0x9d
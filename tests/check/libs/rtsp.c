@@ -685,6 +685,96 @@ GST_START_TEST (test_rtsp_message)
 
 GST_END_TEST;
 
+static void
+check_headers (GstRTSPMessage * msg, const gchar * expected)
+{
+  GString *str = g_string_new (NULL);
+
+  fail_unless_equals_int (gst_rtsp_message_append_headers (msg, str),
+      GST_RTSP_OK);
+  fail_unless_equals_string (str->str, expected);
+  g_string_free (str, TRUE);
+}
+
+GST_START_TEST (test_rtsp_message_set_header)
+{
+  GstRTSPMessage *msg, *copy;
+  GstRTSPResult res;
+  gchar *val = NULL;
+
+  res = gst_rtsp_message_new_response (&msg, GST_RTSP_STS_OK, NULL, NULL);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_CSEQ, "1");
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_SERVER, "GStreamer");
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_SESSION, "xnb_NpaKEc");
+  gst_rtsp_message_add_header_by_name (msg, "Custom", "value");
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_PUBLIC, "OPTIONS, PLAY");
+  check_headers (msg, "CSeq: 1\r\nServer: GStreamer\r\nSession: xnb_NpaKEc\r\n"
+      "Custom: value\r\nPublic: OPTIONS, PLAY\r\n");
+
+  /* values are replaced in place */
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_CSEQ, "20");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_SESSION, "abc");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_SERVER, "Test");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  check_headers (msg, "CSeq: 20\r\nServer: Test\r\nSession: abc\r\n"
+      "Custom: value\r\nPublic: OPTIONS, PLAY\r\n");
+
+  /* missing headers are added */
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_DATE, "today");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  check_headers (msg, "CSeq: 20\r\nServer: Test\r\nSession: abc\r\n"
+      "Custom: value\r\nPublic: OPTIONS, PLAY\r\nDate: today\r\n");
+
+  /* and other headers with the same field removed */
+  gst_rtsp_message_add_header (msg, GST_RTSP_HDR_CSEQ, "21");
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ, &val, 1);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "21");
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_CSEQ, "22");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ, &val, 1);
+  fail_unless_equals_int (res, GST_RTSP_ENOTIMPL);
+  check_headers (msg, "CSeq: 22\r\nServer: Test\r\nSession: abc\r\n"
+      "Custom: value\r\nPublic: OPTIONS, PLAY\r\nDate: today\r\n");
+
+  /* lookups still work after removing headers */
+  res = gst_rtsp_message_remove_header (msg, GST_RTSP_HDR_SERVER, -1);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_remove_header_by_name (msg, "Custom", -1);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "abc");
+  res = gst_rtsp_message_get_header_by_name (msg, "public", &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "OPTIONS, PLAY");
+  res = gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SERVER, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_ENOTIMPL);
+
+  res = gst_rtsp_message_set_header (msg, GST_RTSP_HDR_DATE, "tomorrow");
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  check_headers (msg, "CSeq: 22\r\nSession: abc\r\n"
+      "Public: OPTIONS, PLAY\r\nDate: tomorrow\r\n");
+
+  res = gst_rtsp_message_copy (msg, &copy);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  res = gst_rtsp_message_get_header (copy, GST_RTSP_HDR_PUBLIC, &val, 0);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_string (val, "OPTIONS, PLAY");
+  check_headers (copy, "CSeq: 22\r\nSession: abc\r\n"
+      "Public: OPTIONS, PLAY\r\nDate: tomorrow\r\n");
+  gst_rtsp_message_free (copy);
+
+  res = gst_rtsp_message_free (msg);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtsp_message_auth_credentials)
 {
   GstRTSPMessage *msg;
@@ -1017,6 +1107,7 @@ rtsp_suite (void)
   tcase_add_test (tc_chain, test_rtsp_range_clock);
   tcase_add_test (tc_chain, test_rtsp_range_convert);
   tcase_add_test (tc_chain, test_rtsp_message);
+  tcase_add_test (tc_chain, test_rtsp_message_set_header);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials_boxed);
 
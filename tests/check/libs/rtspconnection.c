@@ -928,6 +928,236 @@ GST_START_TEST (test_rtspconnection_send_receive_content_length)
 
 GST_END_TEST;
 
+#define N_DATA_MESSAGES 20000
+
+static gpointer
+write_data_thread_func (gpointer user_data)
+{
+  GSocketConnection *conn = user_data;
+  GOutputStream *stream;
+  GByteArray *data;
+  guint8 header[4], value;
+  guint i, j, len;
+
+  /* interleaved data messages of all sizes between 1 and 1500 bytes, with
+   * the payload bytes set to the message index, followed by a request */
+  data = g_byte_array_new ();
+  for (i = 0; i < N_DATA_MESSAGES; i++) {
+    len = 1 + (i * 7919) % 1500;
+    header[0] = '$';
+    header[1] = i & 1;
+    GST_WRITE_UINT16_BE (header + 2, len);
+    g_byte_array_append (data, header, 4);
+    value = i & 0xff;
+    for (j = 0; j < len; j++)
+      g_byte_array_append (data, &value, 1);
+  }
+  g_byte_array_append (data, (guint8 *) "OPTIONS * RTSP/1.0\r\nCSeq: 1\r\n\r\n",
+      strlen ("OPTIONS * RTSP/1.0\r\nCSeq: 1\r\n\r\n"));
+
+  stream = g_io_stream_get_output_stream (G_IO_STREAM (conn));
+  fail_unless (g_output_stream_write_all (stream, data->data, data->len, NULL,
+          NULL, NULL));
+  g_byte_array_unref (data);
+
+  return NULL;
+}
+
+GST_START_TEST (test_rtspconnection_receive_interleaved)
+{
+  gboolean body_buffer[] = { FALSE, TRUE };
+  guint k;
+
+  for (k = 0; k < G_N_ELEMENTS (body_buffer); k++) {
+    GSocketConnection *input_conn = NULL;
+    GSocketConnection *output_conn = NULL;
+    GstRTSPConnection *rtsp_input_conn;
+    GstRTSPMessage *msg;
+    GThread *thread;
+    GTimer *timer;
+    guint i, len, recv_len;
+    guint8 *recv_data;
+    guint64 total = 0;
+
+    create_connection (&input_conn, &output_conn);
+    fail_unless (gst_rtsp_connection_create_from_socket
+        (g_socket_connection_get_socket (input_conn), "127.0.0.1", 4444, NULL,
+            &rtsp_input_conn) == GST_RTSP_OK);
+    gst_rtsp_connection_set_data_body_buffer (rtsp_input_conn,
+        body_buffer[k]);
+
+    thread = g_thread_new ("write data", write_data_thread_func, output_conn);
+    timer = g_timer_new ();
+
+    fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+    for (i = 0; i < N_DATA_MESSAGES; i++) {
+      GstBuffer *buffer = NULL;
+      GstMapInfo map;
+
+      len = 1 + (i * 7919) % 1500;
+      fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg,
+              NULL) == GST_RTSP_OK);
+      fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+      fail_unless_equals_int (msg->type_data.data.channel, i & 1);
+
+      if (body_buffer[k]) {
+        fail_unless (gst_rtsp_message_steal_body_buffer (msg,
+                &buffer) == GST_RTSP_OK);
+        fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+        recv_data = map.data;
+        recv_len = map.size;
+      } else {
+        fail_unless (gst_rtsp_message_get_body (msg, &recv_data,
+                &recv_len) == GST_RTSP_OK);
+        /* RTSPConnection adds an extra byte for the trailing '\0' */
+        fail_unless_equals_int (recv_data[--recv_len], '\0');
+      }
+      fail_unless_equals_int (recv_len, len);
+      fail_unless_equals_int (recv_data[0], i & 0xff);
+      fail_unless_equals_int (recv_data[len - 1], i & 0xff);
+      total += len;
+
+      if (buffer) {
+        gst_buffer_unmap (buffer, &map);
+        gst_buffer_unref (buffer);
+      }
+      gst_rtsp_message_unset (msg);
+    }
+
+    /* the request following the data messages is intact */
+    fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg,
+            NULL) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_REQUEST);
+    fail_unless (msg->type_data.request.method == GST_RTSP_OPTIONS);
+    fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+    GST_INFO ("received %u data messages, %" G_GUINT64_FORMAT " bytes in "
+        "%f s%s", N_DATA_MESSAGES, total, g_timer_elapsed (timer, NULL),
+        body_buffer[k] ? " as buffers" : "");
+    g_timer_destroy (timer);
+    g_thread_join (thread);
+
+    fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+
+    g_object_unref (input_conn);
+    g_object_unref (output_conn);
+  }
+}
+
+GST_END_TEST;
+
+#define N_LIST_BUFFERS 1000
+
+static gpointer
+receive_data_thread_func (gpointer user_data)
+{
+  GstRTSPConnection *conn = user_data;
+  GstRTSPMessage *msg;
+  guint8 *data;
+  guint i, size, len;
+  guint errors = 0;
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  for (i = 0; i < N_LIST_BUFFERS; i++) {
+    len = 1 + (i * 7919) % 1500;
+    if (gst_rtsp_connection_receive (conn, msg, NULL) != GST_RTSP_OK ||
+        gst_rtsp_message_get_type (msg) != GST_RTSP_MESSAGE_DATA) {
+      errors++;
+      break;
+    }
+
+    gst_rtsp_message_get_body (msg, &data, &size);
+    /* RTSPConnection adds an extra byte for the trailing '\0' */
+    if (msg->type_data.data.channel != 3 || size != len + 1 ||
+        data[0] != (i & 0xff) || data[len - 1] != (i & 0xff))
+      errors++;
+    gst_rtsp_message_unset (msg);
+  }
+  gst_rtsp_message_free (msg);
+
+  return GUINT_TO_POINTER (errors);
+}
+
+static GstBuffer *
+create_list_buffer (guint i)
+{
+  GstBuffer *buffer;
+  guint len = 1 + (i * 7919) % 1500;
+
+  /* every third buffer is made of two memories */
+  if (i % 3 == 0 && len > 1) {
+    buffer = gst_buffer_new_allocate (NULL, len / 2, NULL);
+    gst_buffer_append (buffer, gst_buffer_new_allocate (NULL, len - len / 2,
+            NULL));
+  } else {
+    buffer = gst_buffer_new_allocate (NULL, len, NULL);
+  }
+  gst_buffer_memset (buffer, 0, i & 0xff, len);
+
+  return buffer;
+}
+
+GST_START_TEST (test_rtspconnection_send_buffer_list)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GstRTSPConnection *rtsp_output_conn;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPWatch *watch;
+  GstBufferList *list;
+  GThread *thread;
+  guint i, id = 0;
+
+  create_connection (&conn1, &conn2);
+  fail_unless (gst_rtsp_connection_create_from_socket
+      (g_socket_connection_get_socket (conn1), "127.0.0.1", 4444, NULL,
+          &rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_create_from_socket
+      (g_socket_connection_get_socket (conn2), "127.0.0.1", 4444, NULL,
+          &rtsp_input_conn) == GST_RTSP_OK);
+
+  watch = gst_rtsp_watch_new (rtsp_output_conn, &watch_funcs, NULL, NULL);
+  fail_unless (watch != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch, NULL) > 0);
+  g_source_unref ((GSource *) watch);
+
+  /* payloads that don't fit in a data message are refused */
+  list = gst_buffer_list_new ();
+  gst_buffer_list_add (list, gst_buffer_new_allocate (NULL, 65536, NULL));
+  fail_unless (gst_rtsp_watch_send_buffer_list (watch, 3, list,
+          &id) == GST_RTSP_EINVAL);
+  gst_buffer_list_unref (list);
+
+  /* more data than the socket takes at once, the rest gets queued */
+  list = gst_buffer_list_new_sized (N_LIST_BUFFERS);
+  for (i = 0; i < N_LIST_BUFFERS; i++)
+    gst_buffer_list_add (list, create_list_buffer (i));
+
+  message_sent_count = 0;
+  fail_unless (gst_rtsp_watch_send_buffer_list (watch, 3, list,
+          &id) == GST_RTSP_OK);
+  /* the queued buffers are kept referenced, not the list */
+  gst_buffer_list_unref (list);
+
+  thread = g_thread_new ("receive data", receive_data_thread_func,
+      rtsp_input_conn);
+  while (id != 0 && message_sent_count == 0)
+    g_main_context_iteration (NULL, TRUE);
+  fail_unless_equals_int (GPOINTER_TO_UINT (g_thread_join (thread)), 0);
+  fail_unless (id == 0 || message_sent_count == 1);
+
+  g_source_destroy ((GSource *) watch);
+  fail_unless (gst_rtsp_connection_close (rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspconnection_suite (void)
 {
@@ -944,6 +1174,8 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_content_length);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_interleaved);
+  tcase_add_test (tc_chain, test_rtspconnection_send_buffer_list);
 
   return s;
 }
@@ -481,6 +481,110 @@ GST_END_TEST;
 #undef WIDTH
 #undef HEIGHT
 
+static guint16
+replicate_bits (guint16 v, gint depth)
+{
+  v = (v >> (16 - depth)) << (16 - depth);
+
+  return v | (v >> depth);
+}
+
+/* the high bit depth YUV formats have vectorized pack and unpack functions
+ * that convert blocks of pixels, check all the line widths around them */
+GST_START_TEST (test_video_formats_pack_unpack_high_depth)
+{
+  const GstVideoFormat formats[] = {
+    GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_I420_10BE,
+    GST_VIDEO_FORMAT_I420_12LE, GST_VIDEO_FORMAT_I420_12BE,
+    GST_VIDEO_FORMAT_I422_10LE, GST_VIDEO_FORMAT_I422_10BE,
+    GST_VIDEO_FORMAT_I422_12LE, GST_VIDEO_FORMAT_I422_12BE,
+    GST_VIDEO_FORMAT_Y444_10LE, GST_VIDEO_FORMAT_Y444_10BE,
+    GST_VIDEO_FORMAT_Y444_12LE, GST_VIDEO_FORMAT_Y444_12BE,
+    GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_P010_10BE,
+    GST_VIDEO_FORMAT_P012_LE, GST_VIDEO_FORMAT_P012_BE,
+    GST_VIDEO_FORMAT_P016_LE, GST_VIDEO_FORMAT_P016_BE,
+    GST_VIDEO_FORMAT_v210,
+  };
+  guint16 src[67 * 4], unpacked[67 * 4], repacked[67 * 4];
+  GRand *rand = g_rand_new_with_seed (42);
+  guint f, width, i;
+
+  for (i = 0; i < G_N_ELEMENTS (src); i++)
+    src[i] = g_rand_int (rand);
+  g_rand_free (rand);
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstVideoFormatInfo *finfo = gst_video_format_get_info (formats[f]);
+    gint depth = GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0);
+    gint w_sub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, 1);
+
+    GST_INFO ("testing %s", gst_video_format_to_string (formats[f]));
+
+    for (width = 1; width <= 67; width++) {
+      gpointer data[GST_VIDEO_MAX_PLANES];
+      gint stride[GST_VIDEO_MAX_PLANES];
+      GstVideoInfo info;
+      guint8 *pixels;
+      guint p;
+
+      fail_unless (gst_video_info_set_format (&info, formats[f], width, 2));
+      pixels = g_malloc0 (info.size);
+      for (p = 0; p < GST_VIDEO_INFO_N_PLANES (&info); p++) {
+        data[p] = pixels + info.offset[p];
+        stride[p] = info.stride[p];
+      }
+
+      finfo->pack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, src, 0, data,
+          stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, 0, width);
+      finfo->unpack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, unpacked, data,
+          stride, 0, 0, width);
+
+      for (i = 0; i < width; i++) {
+        guint c = i & ~((1 << w_sub) - 1);
+
+        fail_unless_equals_int (unpacked[i * 4 + 0], 0xffff);
+        fail_unless_equals_int (unpacked[i * 4 + 1],
+            replicate_bits (src[i * 4 + 1], depth));
+        fail_unless_equals_int (unpacked[i * 4 + 2],
+            replicate_bits (src[c * 4 + 2], depth));
+        fail_unless_equals_int (unpacked[i * 4 + 3],
+            replicate_bits (src[c * 4 + 3], depth));
+      }
+
+      /* unpacking from an odd pixel gives the same pixels */
+      if (formats[f] != GST_VIDEO_FORMAT_v210 && width > 1) {
+        finfo->unpack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, repacked, data,
+            stride, 1, 0, width - 1);
+        fail_unless (memcmp (repacked, unpacked + 4,
+                (width - 1) * 4 * sizeof (guint16)) == 0);
+      }
+
+      /* and packing the unpacked pixels again gives the same line */
+      memset (repacked, 0, sizeof (repacked));
+      finfo->pack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, unpacked, 0, data,
+          stride, GST_VIDEO_CHROMA_SITE_UNKNOWN, 0, width);
+      finfo->unpack_func (finfo, GST_VIDEO_PACK_FLAG_NONE, repacked, data,
+          stride, 0, 0, width);
+      fail_unless (memcmp (repacked, unpacked,
+              width * 4 * sizeof (guint16)) == 0);
+
+      /* truncating keeps the low bits zero */
+      finfo->unpack_func (finfo, GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE,
+          repacked, data, stride, 0, 0, width);
+      for (i = 0; i < width * 4; i++) {
+        if (i % 4 == 0)
+          continue;
+        fail_unless_equals_int (repacked[i],
+            unpacked[i] & (0xffff << (16 - depth)));
+      }
+
+      g_free (pixels);
+    }
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_formats)
 {
   guint i;
@@ -2872,6 +2976,116 @@ GST_START_TEST (test_video_convert_multithreading)
 
 GST_END_TEST;
 
+/* tile the NV12 frame @ref into a new buffer of @info with the pack function
+ * of the tiled format */
+static GstBuffer *
+create_tiled_buffer (GstVideoInfo * info, GstVideoFrame * ref)
+{
+  const GstVideoFormatInfo *nv12_finfo = ref->info.finfo;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  guint8 *line;
+  gint y, width = GST_VIDEO_INFO_WIDTH (info);
+
+  buffer = gst_buffer_new_and_alloc (info->size);
+  gst_buffer_memset (buffer, 0, 0, -1);
+  fail_unless (gst_video_frame_map (&frame, info, buffer, GST_MAP_WRITE));
+
+  line = g_malloc (width * 4);
+  for (y = 0; y < GST_VIDEO_INFO_HEIGHT (info); y++) {
+    nv12_finfo->unpack_func (nv12_finfo, GST_VIDEO_PACK_FLAG_NONE, line,
+        ref->data, ref->info.stride, 0, y, width);
+    info->finfo->pack_func (info->finfo, GST_VIDEO_PACK_FLAG_NONE, line, 0,
+        frame.data, frame.info.stride, info->chroma_site, y, width);
+  }
+  g_free (line);
+  gst_video_frame_unmap (&frame);
+
+  return buffer;
+}
+
+GST_START_TEST (test_video_convert_detile)
+{
+  GstVideoFormat formats[] = { GST_VIDEO_FORMAT_NV12_64Z32,
+    GST_VIDEO_FORMAT_NV12_4L4, GST_VIDEO_FORMAT_NV12_32L32
+  };
+  gint sizes[][2] = { {1280, 720}, {200, 90}, {70, 33}, {2, 2} };
+  guint n_threads[] = { 1, 4 };
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  guint8 *ref, *out;
+  gint i, j, k, x, y, plane;
+
+  for (j = 0; j < G_N_ELEMENTS (sizes); j++) {
+    gint width = sizes[j][0], height = sizes[j][1];
+
+    fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12,
+            width, height));
+    refbuffer = gst_buffer_new_and_alloc (outinfo.size);
+    fail_unless (gst_video_frame_map (&refframe, &outinfo, refbuffer,
+            GST_MAP_READWRITE));
+    for (plane = 0; plane < 2; plane++) {
+      ref = GST_VIDEO_FRAME_PLANE_DATA (&refframe, plane);
+      for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&refframe, plane); y++)
+        for (x = 0; x < GST_VIDEO_FRAME_PLANE_STRIDE (&refframe, plane); x++)
+          ref[y * GST_VIDEO_FRAME_PLANE_STRIDE (&refframe, plane) + x] =
+              (x * 3 + y * 7 + plane * 11) & 0xff;
+    }
+
+    for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+      fail_unless (gst_video_info_set_format (&ininfo, formats[i], width,
+              height));
+      inbuffer = create_tiled_buffer (&ininfo, &refframe);
+      fail_unless (gst_video_frame_map (&inframe, &ininfo, inbuffer,
+              GST_MAP_READ));
+
+      for (k = 0; k < G_N_ELEMENTS (n_threads); k++) {
+        GST_LOG ("%s %dx%d, %u threads",
+            gst_video_format_to_string (formats[i]), width, height,
+            n_threads[k]);
+
+        outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+        gst_buffer_memset (outbuffer, 0, 0, -1);
+        fail_unless (gst_video_frame_map (&outframe, &outinfo, outbuffer,
+                GST_MAP_WRITE));
+
+        convert = gst_video_converter_new (&ininfo, &outinfo,
+            gst_structure_new ("options",
+                GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads[k],
+                NULL));
+        gst_video_converter_frame (convert, &inframe, &outframe);
+        gst_video_converter_free (convert);
+
+        for (plane = 0; plane < 2; plane++) {
+          gint row_size = GST_VIDEO_FRAME_COMP_WIDTH (&outframe, plane) *
+              GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe, plane);
+
+          ref = GST_VIDEO_FRAME_PLANE_DATA (&refframe, plane);
+          out = GST_VIDEO_FRAME_PLANE_DATA (&outframe, plane);
+          for (y = 0; y < GST_VIDEO_FRAME_COMP_HEIGHT (&outframe, plane); y++)
+            fail_unless (memcmp (ref +
+                    y * GST_VIDEO_FRAME_PLANE_STRIDE (&refframe, plane),
+                    out + y * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, plane),
+                    row_size) == 0);
+        }
+
+        gst_video_frame_unmap (&outframe);
+        gst_buffer_unref (outbuffer);
+      }
+
+      gst_video_frame_unmap (&inframe);
+      gst_buffer_unref (inbuffer);
+    }
+
+    gst_video_frame_unmap (&refframe);
+    gst_buffer_unref (refbuffer);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -3174,6 +3388,109 @@ GST_START_TEST (test_overlay_composition_over_transparency)
 
 GST_END_TEST;
 
+static GstBuffer *
+_new_overlay_pixels (gint width, gint height)
+{
+  GstBuffer *pix;
+  GstMapInfo map;
+  gsize i;
+
+  pix = gst_buffer_new_and_alloc (width * height * sizeof (guint32));
+  gst_buffer_map (pix, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 37 + (i / 4) * 11) & 0xff;
+  gst_buffer_unmap (pix, &map);
+  gst_buffer_add_video_meta (pix, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height);
+
+  return pix;
+}
+
+static void
+_blend_overlay_reference (GstVideoFrame * frame, GstBuffer * pix,
+    gint width, gint height, gint x, gint y, gint render_width,
+    gint render_height, gfloat global_alpha)
+{
+  GstVideoInfo info, scaled_info;
+  GstVideoFrame overlay;
+  GstBuffer *scaled;
+
+  fail_unless (gst_video_info_set_format (&info,
+          GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height));
+  gst_video_blend_scale_linear_RGBA (&info, pix, render_height, render_width,
+      &scaled_info, &scaled);
+  fail_unless (gst_video_frame_map (&overlay, &scaled_info, scaled,
+          GST_MAP_READ));
+  fail_unless (gst_video_blend (frame, &overlay, x, y, global_alpha));
+  gst_video_frame_unmap (&overlay);
+  gst_buffer_unref (scaled);
+}
+
+static void
+_check_overlay_blend_cached (GstVideoFormat format,
+    GstVideoOverlayComposition * comp, GstBuffer * pix, gfloat global_alpha)
+{
+  GstVideoFrame ref, frame;
+  GstVideoInfo info;
+  GstBuffer *ref_buf, *buf;
+  gint i, p;
+
+  fail_unless (gst_video_info_set_format (&info, format, 160, 120));
+  ref_buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_memset (ref_buf, 0, 0x60, GST_VIDEO_INFO_SIZE (&info));
+  fail_unless (gst_video_frame_map (&ref, &info, ref_buf, GST_MAP_READWRITE));
+  _blend_overlay_reference (&ref, pix, 64, 32, -8, 100, 96, 48, global_alpha);
+
+  /* The second round uses the pixels cached in the rectangle */
+  for (i = 0; i < 2; i++) {
+    buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+    gst_buffer_memset (buf, 0, 0x60, GST_VIDEO_INFO_SIZE (&info));
+    fail_unless (gst_video_frame_map (&frame, &info, buf, GST_MAP_READWRITE));
+    fail_unless (gst_video_overlay_composition_blend (comp, &frame));
+
+    for (p = 0; p < GST_VIDEO_FRAME_N_PLANES (&frame); p++) {
+      gsize plane_size = GST_VIDEO_FRAME_PLANE_STRIDE (&frame, p) *
+          GST_VIDEO_FRAME_COMP_HEIGHT (&frame, p);
+
+      fail_unless (memcmp (GST_VIDEO_FRAME_PLANE_DATA (&frame, p),
+              GST_VIDEO_FRAME_PLANE_DATA (&ref, p), plane_size) == 0);
+    }
+
+    gst_video_frame_unmap (&frame);
+    gst_buffer_unref (buf);
+  }
+
+  gst_video_frame_unmap (&ref);
+  gst_buffer_unref (ref_buf);
+}
+
+GST_START_TEST (test_overlay_composition_blend_cached)
+{
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstBuffer *pix;
+
+  pix = _new_overlay_pixels (64, 32);
+  rect = gst_video_overlay_rectangle_new_raw (pix, -8, 100, 96, 48,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  comp = gst_video_overlay_composition_new (rect);
+
+  _check_overlay_blend_cached (GST_VIDEO_FORMAT_I420, comp, pix, 1.0);
+  _check_overlay_blend_cached (GST_VIDEO_FORMAT_NV12, comp, pix, 1.0);
+  _check_overlay_blend_cached (GST_VIDEO_FORMAT_RGB, comp, pix, 1.0);
+
+  /* Changing the global alpha invalidates the cached pixels */
+  gst_video_overlay_rectangle_set_global_alpha (rect, 0.5);
+  _check_overlay_blend_cached (GST_VIDEO_FORMAT_I420, comp, pix, 0.5);
+  _check_overlay_blend_cached (GST_VIDEO_FORMAT_RGB, comp, pix, 0.5);
+
+  gst_video_overlay_composition_unref (comp);
+  gst_video_overlay_rectangle_unref (rect);
+  gst_buffer_unref (pix);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_format_enum_stability)
 {
   /* When adding new formats, adding a format in the middle of the enum will
@@ -4003,6 +4320,180 @@ GST_START_TEST (test_video_make_raw_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_pool_huge_pages)
+{
+  const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT,
+    GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL
+  };
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 1920, 1080);
+  caps = gst_video_info_to_caps (&info);
+
+  pool = gst_video_buffer_pool_new ();
+  for (i = 0; i < G_N_ELEMENTS (options); i++)
+    fail_unless (gst_buffer_pool_has_option (pool, options[i]));
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, 2, 0);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  for (i = 0; i < G_N_ELEMENTS (options); i++)
+    gst_buffer_pool_config_add_option (config, options[i]);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buffer, NULL),
+      GST_FLOW_OK);
+  fail_unless (gst_buffer_get_size (buffer) >= info.size);
+  fail_unless (gst_buffer_get_video_meta (buffer) != NULL);
+
+  /* the memory is usable as normal system memory */
+  fail_unless (gst_video_frame_map (&frame, &info, buffer, GST_MAP_WRITE));
+  memset (GST_VIDEO_FRAME_PLANE_DATA (&frame, 0), 0x10,
+      GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0) * 1080);
+  gst_video_frame_unmap (&frame);
+  fail_unless_equals_int (gst_buffer_memcmp (buffer, 0, "\x10\x10", 2), 0);
+
+  gst_buffer_unref (buffer);
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+/* I420 with one memory per plane and a known value at every luma pixel */
+static GstBuffer *
+create_i420_planar_buffer (const GstVideoInfo * info)
+{
+  GstBuffer *buffer = gst_buffer_new ();
+  GstMapInfo map;
+  guint i, x, y;
+
+  for (i = 0; i < 3; i++) {
+    gsize end = i < 2 ? info->offset[i + 1] : info->size;
+
+    gst_buffer_append_memory (buffer,
+        gst_allocator_alloc (NULL, end - info->offset[i], NULL));
+  }
+
+  fail_unless (gst_buffer_map_range (buffer, 0, 1, &map, GST_MAP_WRITE));
+  for (y = 0; y < info->height; y++) {
+    for (x = 0; x < info->width; x++)
+      map.data[y * info->stride[0] + x] = (y * 7 + x) & 0xff;
+  }
+  gst_buffer_unmap (buffer, &map);
+
+  gst_buffer_memset (buffer, info->offset[1], 0x40,
+      info->offset[2] - info->offset[1]);
+  gst_buffer_memset (buffer, info->offset[2], 0xc0,
+      info->size - info->offset[2]);
+
+  return buffer;
+}
+
+GST_START_TEST (test_video_frame_map_lazy)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  guint8 *data;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+  buffer = create_i420_planar_buffer (&info);
+
+  /* nothing is mapped until a plane is requested */
+  fail_unless (gst_video_frame_map (&frame, &info, buffer,
+          GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_LAZY));
+  for (i = 0; i < 3; i++)
+    fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, i) == NULL);
+
+  /* only the memory of the plane is mapped */
+  fail_unless (gst_video_frame_map_plane (&frame, 0));
+  fail_unless (frame.map[0].memory == gst_buffer_peek_memory (buffer, 0));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  fail_unless_equals_int (data[5 * info.stride[0] + 3], 38);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1) == NULL);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, 2) == NULL);
+
+  fail_unless (gst_video_frame_map_plane (&frame, 2));
+  fail_unless (frame.map[2].memory == gst_buffer_peek_memory (buffer, 2));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 2);
+  fail_unless_equals_int (data[0], 0xc0);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1) == NULL);
+
+  /* mapping again is a no-op */
+  fail_unless (gst_video_frame_map_plane (&frame, 0));
+  gst_video_frame_unmap (&frame);
+
+  /* the same with a video meta */
+  gst_buffer_add_video_meta_full (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, 64, 48, 3, info.offset, info.stride);
+  fail_unless (gst_video_frame_map (&frame, &info, buffer,
+          GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_LAZY));
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) == NULL);
+  fail_unless (gst_video_frame_map_plane (&frame, 1));
+  data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 1);
+  fail_unless_equals_int (data[0], 0x40);
+  fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame, 0) == NULL);
+  gst_video_frame_unmap (&frame);
+
+  ASSERT_BUFFER_REFCOUNT (buffer, "buffer", 1);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_frame_map_region)
+{
+  GstVideoInfo info;
+  GstVideoFrame frame;
+  GstBuffer *buffer;
+  guint8 *data;
+  guint flags[] = { 0, GST_VIDEO_FRAME_MAP_FLAG_LAZY };
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 64, 48);
+  buffer = create_i420_planar_buffer (&info);
+
+  for (i = 0; i < G_N_ELEMENTS (flags); i++) {
+    fail_unless (gst_video_frame_map_region (&frame, &info, buffer, 8, 4, 16,
+            10, GST_MAP_READ | flags[i]));
+    fail_unless_equals_int (GST_VIDEO_FRAME_WIDTH (&frame), 16);
+    fail_unless_equals_int (GST_VIDEO_FRAME_HEIGHT (&frame), 10);
+    fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_STRIDE (&frame, 0),
+        info.stride[0]);
+
+    fail_unless (gst_video_frame_map_plane (&frame, 0));
+    fail_unless (gst_video_frame_map_plane (&frame, 1));
+    data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+    fail_unless_equals_int (data[0], 4 * 7 + 8);
+    fail_unless_equals_int (data[2 * info.stride[0] + 1], 6 * 7 + 9);
+    data = GST_VIDEO_FRAME_PLANE_DATA (&frame, 1);
+    fail_unless_equals_int (data[0], 0x40);
+    gst_video_frame_unmap (&frame);
+  }
+
+  /* the chroma of I420 is subsampled and can't start at an odd pixel */
+  fail_if (gst_video_frame_map_region (&frame, &info, buffer, 3, 4, 16, 10,
+          GST_MAP_READ));
+  fail_if (gst_video_frame_map_region (&frame, &info, buffer, 56, 0, 16, 10,
+          GST_MAP_READ));
+
+  ASSERT_BUFFER_REFCOUNT (buffer, "buffer", 1);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
 static Suite *
 video_suite (void)
 {
@@ -4018,6 +4509,7 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_formats_rgba_large_dimension);
   tcase_add_test (tc_chain, test_video_formats_all);
   tcase_add_test (tc_chain, test_video_formats_pack_unpack);
+  tcase_add_test (tc_chain, test_video_formats_pack_unpack_high_depth);
   tcase_add_test (tc_chain, test_guess_framerate);
   tcase_add_test (tc_chain, test_dar_calc);
   tcase_add_test (tc_chain, test_parse_caps_rgb);
@@ -4044,10 +4536,12 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_detile);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
+  tcase_add_test (tc_chain, test_overlay_composition_blend_cached);
   tcase_add_test (tc_chain, test_video_format_enum_stability);
   tcase_add_test (tc_chain, test_video_formats_pstrides);
   tcase_add_test (tc_chain, test_hdr);
@@ -4057,6 +4551,9 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_meta_align);
   tcase_add_test (tc_chain, test_video_flags);
   tcase_add_test (tc_chain, test_video_make_raw_caps);
+  tcase_add_test (tc_chain, test_video_pool_huge_pages);
+  tcase_add_test (tc_chain, test_video_frame_map_lazy);
+  tcase_add_test (tc_chain, test_video_frame_map_region);
 
   return s;
 }
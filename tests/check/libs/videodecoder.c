@@ -83,6 +83,7 @@ struct _GstVideoDecoderTester
   guint64 last_kf_num;
   gboolean set_output_state;
   gboolean subframe_mode;
+  GstClockTimeDiff decode_budget;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -149,6 +150,8 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
   gboolean last_subframe = GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
       GST_VIDEO_BUFFER_FLAG_MARKER);
 
+  dectester->decode_budget = gst_video_decoder_get_decode_budget (dec, frame);
+
   if (gst_video_decoder_get_subframe_mode (dec) && !last_subframe) {
     if (!GST_CLOCK_TIME_IS_VALID (frame->pts))
       return gst_video_decoder_drop_subframe (dec, frame);
@@ -199,6 +202,32 @@ done:
   return GST_FLOW_OK;
 }
 
+/* Only used with frame threads. Decodes like handle_frame() does for an
+ * intra-only stream, but takes longer for some frames so that the frames are
+ * completed out of order. */
+static GstFlowReturn
+gst_video_decoder_tester_decode_frame (GstVideoDecoder * dec,
+    GstVideoCodecFrame * frame)
+{
+  GstMapInfo in_map, out_map;
+  guint64 input_num;
+
+  fail_unless (frame->output_buffer != NULL);
+
+  gst_buffer_map (frame->input_buffer, &in_map, GST_MAP_READ);
+  input_num = *((guint64 *) in_map.data);
+  gst_buffer_unmap (frame->input_buffer, &in_map);
+
+  g_usleep ((3 - input_num % 4) * 500);
+
+  gst_buffer_map (frame->output_buffer, &out_map, GST_MAP_WRITE);
+  memset (out_map.data, 0, out_map.size);
+  memcpy (out_map.data, &input_num, sizeof (guint64));
+  gst_buffer_unmap (frame->output_buffer, &out_map);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_decoder_tester_parse (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos)
@@ -236,6 +265,7 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
   videodecoder_class->stop = gst_video_decoder_tester_stop;
   videodecoder_class->flush = gst_video_decoder_tester_flush;
   videodecoder_class->handle_frame = gst_video_decoder_tester_handle_frame;
+  videodecoder_class->decode_frame = gst_video_decoder_tester_decode_frame;
   videodecoder_class->set_format = gst_video_decoder_tester_set_format;
   videodecoder_class->parse = gst_video_decoder_tester_parse;
 }
@@ -1626,6 +1656,189 @@ GST_START_TEST (videodecoder_property_detect_reordering_disabled)
 
 GST_END_TEST;
 
+#define FRAME_THREADS 4
+
+GST_START_TEST (videodecoder_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), FRAME_THREADS);
+  fail_unless_equals_int (gst_video_decoder_get_frame_threads
+      (GST_VIDEO_DECODER (dec)), FRAME_THREADS);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS / 10; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* at most as many frames as threads are still being decoded */
+  fail_unless (g_list_length (buffers) >= NUM_BUFFERS / 10 - FRAME_THREADS);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all frames are output at EOS, in order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS / 10);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND * TEST_VIDEO_FPS_D,
+            TEST_VIDEO_FPS_N));
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_frame_threads_flush)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), FRAME_THREADS);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < 2 * FRAME_THREADS; i++)
+    fail_unless (gst_pad_push (mysrcpad, create_test_buffer (i)) ==
+        GST_FLOW_OK);
+
+  /* the frames that are still being decoded are discarded */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_start ()));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_stop (TRUE)));
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  for (i = 0; i < 2 * FRAME_THREADS; i++)
+    fail_unless (gst_pad_push (mysrcpad, create_test_buffer (i)) ==
+        GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fail_unless_equals_int (g_list_length (buffers), 2 * FRAME_THREADS);
+  for (i = 0; i < 2 * FRAME_THREADS; i++) {
+    GstMapInfo map;
+
+    buffer = g_list_nth_data (buffers, i);
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_decode_budget_and_stats)
+{
+  GstVideoDecoderTester *dectester;
+  GstStructure *stats;
+  GstSegment segment;
+  GstClockTime p50, p90, p99, max;
+  GstClockTime earliest;
+  guint64 processed, dropped;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+  dectester = (GstVideoDecoderTester *) dec;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < 10; i++)
+    fail_unless (gst_pad_push (mysrcpad, create_test_buffer (i)) ==
+        GST_FLOW_OK);
+
+  /* no QoS information yet */
+  fail_unless_equals_int64 (dectester->decode_budget, G_MAXINT64);
+
+  /* downstream is 10 frames ahead */
+  earliest = gst_util_uint64_scale_round (20, GST_SECOND * TEST_VIDEO_FPS_D,
+      TEST_VIDEO_FPS_N);
+  gst_pad_push_event (mysinkpad, gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW,
+          0.5, 0, earliest));
+
+  fail_unless (gst_pad_push (mysrcpad, create_test_buffer (10)) ==
+      GST_FLOW_OK);
+  fail_unless (dectester->decode_budget < 0);
+
+  fail_unless (gst_pad_push (mysrcpad, create_test_buffer (40)) ==
+      GST_FLOW_OK);
+  fail_unless (dectester->decode_budget > 0);
+  fail_unless (dectester->decode_budget <= earliest);
+
+  g_object_get (dec, "stats", &stats, NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-video-decoder-stats"));
+  fail_unless (gst_structure_get (stats,
+          "processed", G_TYPE_UINT64, &processed,
+          "dropped", G_TYPE_UINT64, &dropped,
+          "decode-time-p50", G_TYPE_UINT64, &p50,
+          "decode-time-p90", G_TYPE_UINT64, &p90,
+          "decode-time-p99", G_TYPE_UINT64, &p99,
+          "decode-time-max", G_TYPE_UINT64, &max, NULL));
+  /* the late frame was decoded but dropped before output */
+  fail_unless_equals_uint64 (processed, 12);
+  fail_unless_equals_uint64 (dropped, 1);
+  fail_unless (p50 <= p90 && p90 <= p99 && p99 <= max);
+  gst_structure_free (stats);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_videodecoder_suite (void)
 {
@@ -1664,6 +1877,11 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_property_detect_reordering_enabled);
   tcase_add_test (tc, videodecoder_property_detect_reordering_disabled);
 
+  tcase_add_test (tc, videodecoder_frame_threads);
+  tcase_add_test (tc, videodecoder_frame_threads_flush);
+
+  tcase_add_test (tc, videodecoder_decode_budget_and_stats);
+
   return s;
 }
 
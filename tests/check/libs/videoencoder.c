@@ -56,6 +56,7 @@ struct _GstVideoEncoderTester
   gboolean enable_step_by_step;
   gboolean negotiate_in_set_format;
   GstVideoCodecFrame *last_frame;
+  gint lookahead;
 };
 
 struct _GstVideoEncoderTesterClass
@@ -175,6 +176,22 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
     return gst_video_encoder_finish_frame (enc, frame);
   }
 
+  /* keep frames pending and output the one from lookahead frames ago */
+  if (enc_tester->lookahead > 0) {
+    GstVideoCodecFrame *oldest;
+    gint frame_number = frame->system_frame_number - enc_tester->lookahead;
+
+    gst_video_codec_frame_unref (frame);
+    if (frame_number < 0)
+      return GST_FLOW_OK;
+
+    oldest = gst_video_encoder_get_frame (enc, frame_number);
+    fail_unless (oldest != NULL);
+    fail_unless_equals_int (oldest->system_frame_number, frame_number);
+
+    return gst_video_encoder_push_subframe (enc, oldest, 0);
+  }
+
   enc_tester->last_frame = gst_video_codec_frame_ref (frame);
   if (enc_tester->enable_step_by_step)
     return GST_FLOW_OK;
@@ -183,6 +200,31 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
       enc_tester->num_subframes);
 }
 
+/* Only used with frame threads. Every frame is a key frame, and some take
+ * longer to encode so that the frames are completed out of order. */
+static GstFlowReturn
+gst_video_encoder_tester_encode_frame (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame)
+{
+  GstMapInfo map;
+  guint64 input_num;
+
+  gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
+  input_num = *((guint64 *) map.data);
+  gst_buffer_unmap (frame->input_buffer, &map);
+
+  g_usleep ((3 - input_num % 4) * 500);
+
+  GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+  frame->output_buffer =
+      gst_buffer_new_wrapped (g_memdup (&input_num, sizeof (guint64)),
+      sizeof (guint64));
+  frame->pts = GST_BUFFER_PTS (frame->input_buffer);
+  frame->duration = GST_BUFFER_DURATION (frame->input_buffer);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_encoder_tester_pre_push (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
@@ -214,6 +256,7 @@ gst_video_encoder_tester_class_init (GstVideoEncoderTesterClass * klass)
   videoencoder_class->start = gst_video_encoder_tester_start;
   videoencoder_class->stop = gst_video_encoder_tester_stop;
   videoencoder_class->handle_frame = gst_video_encoder_tester_handle_frame;
+  videoencoder_class->encode_frame = gst_video_encoder_tester_encode_frame;
   videoencoder_class->pre_push = gst_video_encoder_tester_pre_push;
   videoencoder_class->set_format = gst_video_encoder_tester_set_format;
 
@@ -384,6 +427,134 @@ GST_START_TEST (videoencoder_playback)
 
 GST_END_TEST;
 
+#define LOOKAHEAD 40
+GST_START_TEST (videoencoder_lookahead)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  GstVideoCodecFrame *frame;
+  GList *frames;
+  guint64 i;
+  GList *iter;
+
+  setup_videoencodertester ();
+  GST_VIDEO_ENCODER_TESTER (enc)->lookahead = LOOKAHEAD;
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* finished frames are gone, the last LOOKAHEAD ones are still pending */
+  frame = gst_video_encoder_get_frame (GST_VIDEO_ENCODER (enc), 0);
+  fail_unless (frame == NULL);
+  frame = gst_video_encoder_get_frame (GST_VIDEO_ENCODER (enc),
+      NUM_BUFFERS - LOOKAHEAD - 1);
+  fail_unless (frame == NULL);
+  frame = gst_video_encoder_get_frame (GST_VIDEO_ENCODER (enc),
+      NUM_BUFFERS - LOOKAHEAD);
+  fail_unless (frame != NULL);
+  gst_video_codec_frame_unref (frame);
+  frame = gst_video_encoder_get_oldest_frame (GST_VIDEO_ENCODER (enc));
+  fail_unless_equals_int (frame->system_frame_number, NUM_BUFFERS - LOOKAHEAD);
+  gst_video_codec_frame_unref (frame);
+
+  frames = gst_video_encoder_get_frames (GST_VIDEO_ENCODER (enc));
+  fail_unless_equals_int (g_list_length (frames), LOOKAHEAD);
+  g_list_free_full (frames, (GDestroyNotify) gst_video_codec_frame_unref);
+
+  /* all frames that left the lookahead were output in order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS - LOOKAHEAD);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
+/* make sure frames encoded by several frame threads are output in order and
+ * all pending frames are output at EOS */
+#define FRAME_THREADS 4
+GST_START_TEST (videoencoder_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videoencodertester ();
+  gst_video_encoder_set_frame_threads (GST_VIDEO_ENCODER (enc), FRAME_THREADS);
+  fail_unless_equals_int (gst_video_encoder_get_frame_threads
+      (GST_VIDEO_ENCODER (enc)), FRAME_THREADS);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  /* at most as many frames as threads are still being encoded */
+  fail_unless (g_list_length (buffers) >= NUM_BUFFERS - FRAME_THREADS);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all frames are output at EOS, in order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND * TEST_VIDEO_FPS_D,
+            TEST_VIDEO_FPS_N));
+    fail_if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT));
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
 /* make sure tags sent right before eos are pushed */
 GST_START_TEST (videoencoder_tags_before_eos)
 {
@@ -1271,6 +1442,8 @@ gst_videoencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, videoencoder_playback);
+  tcase_add_test (tc, videoencoder_lookahead);
+  tcase_add_test (tc, videoencoder_frame_threads);
 
   tcase_add_test (tc, videoencoder_tags_before_eos);
   tcase_add_test (tc, videoencoder_events_before_eos);
@@ -26,6 +26,7 @@
 #include <gst/app/gstappsink.h>
 #include <gst/app/gstappsrc.h>
 #include <gst/net/gstnetcontrolmessagemeta.h>
+#include <gst/allocators/allocators.h>
 
 #ifdef HAVE_GIO_UNIX_2_0
 #include <gio/gunixfdmessage.h>
@@ -371,6 +372,88 @@ GST_START_TEST (test_that_multisocketsink_and_socketsrc_preserve_meta)
   symmetry_test_teardown (&st);
 }
 
+GST_END_TEST;
+
+GST_START_TEST (test_that_multisocketsink_and_socketsrc_pass_fds)
+{
+  SymmetryTest st = { 0 };
+  GstAllocator *alloc;
+  GstMemory *shm_mem, *mem;
+  GstBuffer *buf, *outbuf;
+  GstSample *out;
+  GstMapInfo map;
+  struct stat orig_stat, new_stat;
+
+  st.sink = gst_check_setup_element ("multisocketsink");
+  st.src = gst_check_setup_element ("socketsrc");
+  g_object_set (st.sink, "fd-passing", TRUE, NULL);
+  g_object_set (st.src, "fd-passing", TRUE, NULL);
+  {
+    GSocket *sockets[2] = { NULL, NULL };
+
+    fail_unless (g_socketpair (G_SOCKET_FAMILY_UNIX,
+            G_SOCKET_TYPE_STREAM, G_SOCKET_PROTOCOL_DEFAULT, sockets, NULL));
+    g_object_set (st.src, "socket", sockets[0], NULL);
+    g_object_unref (sockets[0]);
+    symmetry_test_setup (&st, st.sink, st.src);
+    g_signal_emit_by_name (st.sink, "add", sockets[1], NULL);
+    g_object_unref (sockets[1]);
+  }
+
+  /* a shared memory frame followed by a plain memory trailer */
+  alloc = gst_shm_allocator_new (GST_SHM_ALLOCATOR_FLAG_SEAL);
+  shm_mem = gst_allocator_alloc (alloc, 4096, NULL);
+  fail_unless (shm_mem != NULL);
+  fail_unless (gst_memory_map (shm_mem, &map, GST_MAP_WRITE));
+  memset (map.data, 0x5a, map.size);
+  gst_memory_unmap (shm_mem, &map);
+  fstat (gst_fd_memory_get_fd (shm_mem), &orig_stat);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, gst_memory_ref (shm_mem));
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (0, g_strdup ("hello"), 6, 0, 6, NULL, NULL));
+  GST_BUFFER_PTS (buf) = 42 * GST_SECOND;
+  GST_BUFFER_DURATION (buf) = GST_SECOND;
+  GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  symmetry_test_assert_passthrough (&st, gst_buffer_ref (buf));
+
+  fail_unless (gst_app_src_push_buffer (st.sink_src, buf) == GST_FLOW_OK);
+  out = gst_app_sink_pull_sample (st.src_sink);
+  fail_unless (out != NULL);
+  outbuf = gst_sample_get_buffer (out);
+
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), 42 * GST_SECOND);
+  fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuf), GST_SECOND);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_DELTA_UNIT));
+  fail_unless_equals_int (gst_buffer_n_memory (outbuf), 2);
+  fail_unless_equals_int (gst_buffer_get_size (outbuf), 4096 + 6);
+
+  /* the frame was not copied, the same file was received */
+  mem = gst_buffer_peek_memory (outbuf, 0);
+  fail_unless (gst_is_fd_memory (mem));
+  fstat (gst_fd_memory_get_fd (mem), &new_stat);
+  fail_unless_equals_uint64 (orig_stat.st_ino, new_stat.st_ino);
+  fail_if (gst_memory_is_writable (mem));
+
+  /* writes of the sender are visible to the receiver */
+  fail_unless (gst_memory_map (shm_mem, &map, GST_MAP_WRITE));
+  map.data[0] = 0x17;
+  gst_memory_unmap (shm_mem, &map);
+  fail_unless (gst_memory_map (mem, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.data[0], 0x17);
+  fail_unless_equals_int (map.data[4095], 0x5a);
+  gst_memory_unmap (mem, &map);
+
+  fail_unless (gst_buffer_memcmp (outbuf, 4096, "hello", 6) == 0);
+
+  gst_sample_unref (out);
+  gst_memory_unref (shm_mem);
+  gst_object_unref (alloc);
+  symmetry_test_teardown (&st);
+}
+
 GST_END_TEST;
 #endif /* HAVE_GIO_UNIX_2_0 */
 
@@ -392,6 +475,7 @@ socketintegrationtest_suite (void)
 #ifdef HAVE_GIO_UNIX_2_0
   tcase_add_test (tc_chain,
       test_that_multisocketsink_and_socketsrc_preserve_meta);
+  tcase_add_test (tc_chain, test_that_multisocketsink_and_socketsrc_pass_fds);
 #endif /* HAVE_GIO_UNIX_2_0 */
 
   return s;
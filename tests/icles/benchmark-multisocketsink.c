@@ -0,0 +1,119 @@
+/* GStreamer multisocketsink throughput benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/socket.h>
+#include <gio/gio.h>
+#include <gst/gst.h>
+
+#define N_CLIENTS 16
+#define NUM_BUFFERS 500
+#define BUFFER_SIZE 65536
+
+/* reads everything that is sent to one client */
+static gpointer
+read_client (GSocket * socket)
+{
+  guint8 data[BUFFER_SIZE];
+  gsize total = 0;
+  gssize ret;
+
+  while (total < NUM_BUFFERS * BUFFER_SIZE) {
+    ret = g_socket_receive (socket, (gchar *) data, sizeof (data), NULL, NULL);
+    if (ret <= 0)
+      break;
+    total += ret;
+  }
+
+  return NULL;
+}
+
+static void
+do_benchmark_multisocketsink (guint n_threads)
+{
+  GstElement *pipeline, *sink;
+  GSocket *sinksockets[N_CLIENTS], *srcsockets[N_CLIENTS];
+  GThread *threads[N_CLIENTS];
+  GstMessage *msg;
+  GstBus *bus;
+  gint64 start, end;
+  guint i;
+
+  pipeline = gst_parse_launch ("fakesrc sizetype=fixed filltype=zero "
+      "num-buffers=" G_STRINGIFY (NUM_BUFFERS) " "
+      "sizemax=" G_STRINGIFY (BUFFER_SIZE) " ! "
+      "multisocketsink name=sink sync=false", NULL);
+  g_assert (pipeline != NULL);
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_object_set (sink, "n-threads", n_threads, NULL);
+
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  for (i = 0; i < N_CLIENTS; i++) {
+    gint sv[2];
+
+    g_assert (socketpair (PF_UNIX, SOCK_STREAM, 0, sv) == 0);
+    sinksockets[i] = g_socket_new_from_fd (sv[0], NULL);
+    srcsockets[i] = g_socket_new_from_fd (sv[1], NULL);
+    g_signal_emit_by_name (sink, "add", sinksockets[i]);
+  }
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < N_CLIENTS; i++)
+    threads[i] = g_thread_new ("reader", (GThreadFunc) read_client,
+        srcsockets[i]);
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+
+  for (i = 0; i < N_CLIENTS; i++)
+    g_thread_join (threads[i]);
+  end = g_get_monotonic_time ();
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_print ("%2u threads, %u clients: %8.1f MB/s\n", n_threads, N_CLIENTS,
+      (gdouble) N_CLIENTS * NUM_BUFFERS * BUFFER_SIZE / (end - start));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  for (i = 0; i < N_CLIENTS; i++) {
+    g_object_unref (sinksockets[i]);
+    g_object_unref (srcsockets[i]);
+  }
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+
+  do_benchmark_multisocketsink (1);
+  do_benchmark_multisocketsink (2);
+  do_benchmark_multisocketsink (4);
+  do_benchmark_multisocketsink (8);
+
+  return 0;
+}
@@ -0,0 +1,259 @@
+/* GStreamer RTCP compound packet and TWCC feedback benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/rtp/rtp.h>
+
+#define NUM_ITERATIONS 10000
+#define MAX_PACKETS 256
+#define MTU 65000
+
+static const guint8 cname[] = "user@example.com";
+
+static gboolean
+add_feedback (GstRTCPPacket * packet, guint i)
+{
+  guint8 *fci;
+
+  gst_rtcp_packet_fb_set_type (packet, GST_RTCP_RTPFB_TYPE_TWCC);
+  gst_rtcp_packet_fb_set_sender_ssrc (packet, 0x1000);
+  gst_rtcp_packet_fb_set_media_ssrc (packet, 0x2000 + i);
+  if (!gst_rtcp_packet_fb_set_fci_length (packet, 4))
+    return FALSE;
+
+  fci = gst_rtcp_packet_fb_get_fci (packet);
+  memset (fci, i, 16);
+
+  return TRUE;
+}
+
+/* SR with the maximum amount of report blocks, SDES and @n_fb feedback
+ * packets, adding each packet with gst_rtcp_buffer_add_packet() when
+ * @add_next is %FALSE */
+static GstBuffer *
+build_compound (guint n_fb, gboolean add_next)
+{
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket packet;
+  GstBuffer *buf;
+  guint i;
+
+  buf = gst_rtcp_buffer_new (MTU);
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+
+  gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_SR, &packet);
+  gst_rtcp_packet_sr_set_sender_info (&packet, 0x1000, 0, 0, 0, 0);
+  for (i = 0; i < GST_RTCP_MAX_RB_COUNT; i++)
+    gst_rtcp_packet_add_rb (&packet, 0x2000 + i, 0, 0, i, 0, 0, 0);
+
+  if (add_next)
+    gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_SDES);
+  else
+    gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_SDES, &packet);
+  gst_rtcp_packet_sdes_add_item (&packet, 0x1000);
+  gst_rtcp_packet_sdes_add_entry (&packet, GST_RTCP_SDES_CNAME,
+      sizeof (cname), cname);
+
+  for (i = 0; i < n_fb; i++) {
+    if (add_next)
+      gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_RTPFB);
+    else
+      gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB, &packet);
+    add_feedback (&packet, i);
+  }
+
+  gst_rtcp_buffer_unmap (&rtcp);
+
+  return buf;
+}
+
+/* how a consumer that looks up packets by index has to do it without an
+ * index of the compound packet */
+static gboolean
+get_nth_packet (GstRTCPBuffer * rtcp, guint nth, GstRTCPPacket * packet)
+{
+  if (!gst_rtcp_buffer_get_first_packet (rtcp, packet))
+    return FALSE;
+
+  while (nth-- > 0) {
+    if (!gst_rtcp_packet_move_to_next (packet))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static guint32
+sum_packet (GstRTCPPacket * packet)
+{
+  guint32 sum = 0, ssrc;
+  guint i;
+
+  switch (gst_rtcp_packet_get_type (packet)) {
+    case GST_RTCP_TYPE_SR:
+      for (i = 0; i < gst_rtcp_packet_get_rb_count (packet); i++) {
+        gst_rtcp_packet_get_rb (packet, i, &ssrc, NULL, NULL, NULL, NULL,
+            NULL, NULL);
+        sum += ssrc;
+      }
+      break;
+    case GST_RTCP_TYPE_RTPFB:
+      sum += gst_rtcp_packet_fb_get_media_ssrc (packet);
+      sum += gst_rtcp_packet_fb_get_fci (packet)[0];
+      break;
+    default:
+      break;
+  }
+
+  return sum;
+}
+
+static void
+do_benchmark_rtcp (guint n_fb)
+{
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket packet, packets[MAX_PACKETS];
+  GstBuffer *buf;
+  GTimer *timer;
+  gdouble add_sec, add_next_sec, iter_sec, index_sec;
+  guint32 iter_sum = 0, index_sum = 0;
+  guint i, j, n_packets;
+
+  timer = g_timer_new ();
+
+  for (i = 0; i < NUM_ITERATIONS; i++)
+    gst_buffer_unref (build_compound (n_fb, FALSE));
+  add_sec = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++)
+    gst_buffer_unref (build_compound (n_fb, TRUE));
+  add_next_sec = g_timer_elapsed (timer, NULL);
+
+  buf = build_compound (n_fb, TRUE);
+  gst_rtcp_buffer_map (buf, GST_MAP_READ, &rtcp);
+  n_packets = gst_rtcp_buffer_get_packet_count (&rtcp);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    for (j = 0; j < n_packets; j++) {
+      if (get_nth_packet (&rtcp, j, &packet))
+        iter_sum += sum_packet (&packet);
+    }
+  }
+  iter_sec = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    n_packets = gst_rtcp_buffer_get_packets (&rtcp, packets, MAX_PACKETS);
+    for (j = 0; j < n_packets; j++)
+      index_sum += sum_packet (&packets[j]);
+  }
+  index_sec = g_timer_elapsed (timer, NULL);
+
+  g_assert_cmpuint (iter_sum, ==, index_sum);
+
+  gst_print ("%3u packets, %5" G_GSIZE_FORMAT " bytes: build %7.3f us, "
+      "build with add_next %7.3f us, walk by index %7.3f us, "
+      "get_packets %7.3f us\n", n_packets, rtcp.map.size,
+      add_sec * 1e6 / NUM_ITERATIONS, add_next_sec * 1e6 / NUM_ITERATIONS,
+      iter_sec * 1e6 / NUM_ITERATIONS, index_sec * 1e6 / NUM_ITERATIONS);
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  gst_buffer_unref (buf);
+  g_timer_destroy (timer);
+}
+
+/* feedback for @n_statuses packets with some losses and reordering */
+static void
+do_benchmark_twcc (guint n_statuses)
+{
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket packet;
+  GstRTCPTWCCStatus *statuses, *result;
+  GstBuffer *buf;
+  GTimer *timer;
+  gdouble write_sec, read_sec;
+  guint i;
+
+  statuses = g_new (GstRTCPTWCCStatus, n_statuses);
+  result = g_new (GstRTCPTWCCStatus, n_statuses);
+  for (i = 0; i < n_statuses; i++) {
+    statuses[i].seqnum = 1000 + i;
+    statuses[i].received = g_random_int_range (0, 100) >= 5;
+    statuses[i].delta = g_random_int_range (0, 100) >= 2 ?
+        g_random_int_range (0, 40) : g_random_int_range (-400, 400);
+  }
+
+  buf = gst_rtcp_buffer_new (MTU);
+  timer = g_timer_new ();
+
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+    gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB, &packet);
+    gst_rtcp_packet_fb_set_sender_ssrc (&packet, 0x1000);
+    gst_rtcp_packet_twcc_set_statuses (&packet, i, i, statuses, n_statuses);
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_set_size (buf, 0);
+  }
+  write_sec = g_timer_elapsed (timer, NULL);
+
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+  gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RTPFB, &packet);
+  gst_rtcp_packet_twcc_set_statuses (&packet, 0, 0, statuses, n_statuses);
+  gst_rtcp_buffer_unmap (&rtcp);
+
+  gst_rtcp_buffer_map (buf, GST_MAP_READ, &rtcp);
+  gst_rtcp_buffer_get_first_packet (&rtcp, &packet);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++)
+    gst_rtcp_packet_twcc_get_statuses (&packet, result, n_statuses);
+  read_sec = g_timer_elapsed (timer, NULL);
+
+  gst_print ("TWCC %5u statuses, %5" G_GSIZE_FORMAT " bytes: write %7.3f us, "
+      "read %7.3f us\n", n_statuses, rtcp.map.size,
+      write_sec * 1e6 / NUM_ITERATIONS, read_sec * 1e6 / NUM_ITERATIONS);
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  gst_buffer_unref (buf);
+  g_timer_destroy (timer);
+  g_free (statuses);
+  g_free (result);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+
+  do_benchmark_rtcp (1);
+  do_benchmark_rtcp (8);
+  do_benchmark_rtcp (32);
+  do_benchmark_rtcp (128);
+
+  do_benchmark_twcc (20);
+  do_benchmark_twcc (200);
+  do_benchmark_twcc (2000);
+
+  return 0;
+}
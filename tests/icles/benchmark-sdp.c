@@ -0,0 +1,171 @@
+/* GStreamer SDP parsing and serialization benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/sdp/sdp.h>
+
+#define NUM_ITERATIONS 20
+#define NUM_VIDEO_PAYLOADS 8
+
+static const gchar *video_codecs[] = { "VP8", "VP9", "H264", "AV1" };
+
+/* creates a description like the ones of a large conference in WebRTC, with
+ * @n_medias bundled audio and video m-lines */
+static gchar *
+create_sdp (guint n_medias)
+{
+  GString *sdp = g_string_new (NULL);
+  guint i, j;
+
+  g_string_append (sdp, "v=0\r\n"
+      "o=- 4611731400430051336 2 IN IP4 127.0.0.1\r\n"
+      "s=-\r\n" "t=0 0\r\n" "a=group:BUNDLE");
+  for (i = 0; i < n_medias; i++)
+    g_string_append_printf (sdp, " %u", i);
+  g_string_append (sdp, "\r\na=msid-semantic: WMS stream\r\n");
+
+  for (i = 0; i < n_medias; i++) {
+    if (i % 2 == 0) {
+      g_string_append (sdp, "m=audio 9 UDP/TLS/RTP/SAVPF 111 103 0 8\r\n");
+    } else {
+      g_string_append (sdp, "m=video 9 UDP/TLS/RTP/SAVPF");
+      for (j = 0; j < 2 * NUM_VIDEO_PAYLOADS; j++)
+        g_string_append_printf (sdp, " %u", 96 + j);
+      g_string_append (sdp, "\r\n");
+    }
+
+    g_string_append_printf (sdp, "c=IN IP4 0.0.0.0\r\n"
+        "a=rtcp:9 IN IP4 0.0.0.0\r\n"
+        "a=ice-ufrag:Fx4Q\r\n"
+        "a=ice-pwd:3qIFuBh6u2QYs6vSXqQDvR2r\r\n"
+        "a=fingerprint:sha-256 7B:8B:F0:65:5F:78:E2:51:3B:AC:6F:F3:3F:46:1B:"
+        "35:DC:B8:5F:64:1A:24:C2:43:F0:A1:58:D0:A1:2C:19:08\r\n"
+        "a=setup:actpass\r\n" "a=mid:%u\r\n"
+        "a=extmap:1 urn:ietf:params:rtp-hdrext:ssrc-audio-level\r\n"
+        "a=extmap:2 http://www.webrtc.org/experiments/rtp-hdrext/"
+        "abs-send-time\r\n"
+        "a=extmap:3 http://www.ietf.org/id/"
+        "draft-holmer-rmcat-transport-wide-cc-extensions-01\r\n"
+        "a=sendrecv\r\n" "a=rtcp-mux\r\n", i);
+
+    if (i % 2 == 0) {
+      g_string_append (sdp, "a=rtpmap:111 opus/48000/2\r\n"
+          "a=rtcp-fb:111 transport-cc\r\n"
+          "a=fmtp:111 minptime=10;useinbandfec=1\r\n"
+          "a=rtpmap:103 ISAC/16000\r\n"
+          "a=rtpmap:0 PCMU/8000\r\n" "a=rtpmap:8 PCMA/8000\r\n");
+    } else {
+      for (j = 0; j < NUM_VIDEO_PAYLOADS; j++) {
+        guint pt = 96 + 2 * j;
+
+        g_string_append_printf (sdp, "a=rtpmap:%u %s/90000\r\n"
+            "a=rtcp-fb:%u goog-remb\r\n" "a=rtcp-fb:%u transport-cc\r\n"
+            "a=rtcp-fb:%u ccm fir\r\n" "a=rtcp-fb:%u nack\r\n"
+            "a=rtcp-fb:%u nack pli\r\n"
+            "a=fmtp:%u level-asymmetry-allowed=1;packetization-mode=1;"
+            "profile-level-id=42e01f\r\n"
+            "a=rtpmap:%u rtx/90000\r\n" "a=fmtp:%u apt=%u\r\n", pt,
+            video_codecs[j % G_N_ELEMENTS (video_codecs)], pt, pt, pt, pt, pt,
+            pt, pt + 1, pt + 1, pt);
+      }
+    }
+
+    g_string_append_printf (sdp, "a=ssrc-group:FID %u %u\r\n"
+        "a=ssrc:%u cname:0FGpnTq4fpGkvnCB\r\n"
+        "a=ssrc:%u msid:stream track%u\r\n", 1000 + 2 * i, 1001 + 2 * i,
+        1000 + 2 * i, 1000 + 2 * i, i);
+  }
+
+  return g_string_free (sdp, FALSE);
+}
+
+static void
+do_benchmark_sdp (guint n_medias)
+{
+  GstSDPMessage *msg;
+  GTimer *timer;
+  gchar *sdp, *text;
+  gdouble parse_sec, text_sec, caps_sec;
+  guint i, j, k, n_caps = 0;
+
+  sdp = create_sdp (n_medias);
+  timer = g_timer_new ();
+
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    gst_sdp_message_new (&msg);
+    gst_sdp_message_parse_buffer ((const guint8 *) sdp, strlen (sdp), msg);
+    gst_sdp_message_free (msg);
+  }
+  parse_sec = g_timer_elapsed (timer, NULL);
+
+  gst_sdp_message_new (&msg);
+  gst_sdp_message_parse_buffer ((const guint8 *) sdp, strlen (sdp), msg);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    text = gst_sdp_message_as_text (msg);
+    g_free (text);
+  }
+  text_sec = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    for (j = 0; j < gst_sdp_message_medias_len (msg); j++) {
+      const GstSDPMedia *media = gst_sdp_message_get_media (msg, j);
+
+      for (k = 0; k < gst_sdp_media_formats_len (media); k++) {
+        gint pt = atoi (gst_sdp_media_get_format (media, k));
+        GstCaps *caps = gst_sdp_media_get_caps_from_media (media, pt);
+
+        if (caps) {
+          gst_caps_unref (caps);
+          n_caps++;
+        }
+      }
+    }
+  }
+  caps_sec = g_timer_elapsed (timer, NULL);
+
+  gst_print ("%3u medias, %7" G_GSIZE_FORMAT " bytes: parse %8.3f ms, "
+      "as text %8.3f ms, caps %8.3f ms (%u caps)\n", n_medias, strlen (sdp),
+      parse_sec * 1000 / NUM_ITERATIONS, text_sec * 1000 / NUM_ITERATIONS,
+      caps_sec * 1000 / NUM_ITERATIONS, n_caps / NUM_ITERATIONS);
+
+  gst_sdp_message_free (msg);
+  g_timer_destroy (timer);
+  g_free (sdp);
+}
+
+int
+main (int argc, char **argv)
+{
+  gst_init (&argc, &argv);
+
+  do_benchmark_sdp (2);
+  do_benchmark_sdp (20);
+  do_benchmark_sdp (100);
+  do_benchmark_sdp (200);
+
+  return 0;
+}
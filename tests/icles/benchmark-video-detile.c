@@ -0,0 +1,105 @@
+/* GStreamer tiled NV12 to NV12 conversion benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_DURATION 1.0
+
+/* Compares the detiling fastpaths, with one and with all threads, to the
+ * generic unpack/pack path. The generic path is selected by asking for a
+ * dither quantization, which the fastpaths don't do. */
+static void
+do_benchmark_detile (GstVideoFormat format, guint width, guint height,
+    const gchar * name, guint n_threads, guint quantization)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GTimer *timer;
+  gdouble elapsed;
+  gint count;
+
+  gst_video_info_set_format (&ininfo, format, width, height);
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_memset (inbuffer, 0, 0x80, -1);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12, width, height);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, n_threads,
+          GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, G_TYPE_UINT,
+          quantization, NULL));
+
+  /* warmup */
+  gst_video_converter_frame (convert, &inframe, &outframe);
+
+  timer = g_timer_new ();
+  count = 0;
+  do {
+    gst_video_converter_frame (convert, &inframe, &outframe);
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+  } while (elapsed < DEFAULT_DURATION);
+
+  gst_println ("%-12s -> NV12 @ %4ux%-4u %-8s %2u threads: %8.3f ms/frame",
+      gst_video_format_to_string (format), width, height, name, n_threads,
+      elapsed * 1000 / count);
+
+  g_timer_destroy (timer);
+  gst_video_converter_free (convert);
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+int
+main (int argc, char **argv)
+{
+  GstVideoFormat formats[] = { GST_VIDEO_FORMAT_NV12_64Z32,
+    GST_VIDEO_FORMAT_NV12_4L4, GST_VIDEO_FORMAT_NV12_32L32
+  };
+  guint sizes[][2] = { {1920, 1080}, {3840, 2160} };
+  guint n_threads = g_get_num_processors ();
+  guint i, j;
+
+  gst_init (&argc, &argv);
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (j = 0; j < G_N_ELEMENTS (sizes); j++) {
+      do_benchmark_detile (formats[i], sizes[j][0], sizes[j][1], "generic",
+          1, 2);
+      do_benchmark_detile (formats[i], sizes[j][0], sizes[j][1], "fastpath",
+          1, 1);
+      do_benchmark_detile (formats[i], sizes[j][0], sizes[j][1], "fastpath",
+          n_threads, 1);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,112 @@
+/* GStreamer video buffer pool benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#define DEFAULT_WIDTH 3840
+#define DEFAULT_HEIGHT 2160
+#define NUM_BUFFERS 8
+
+/* Compares the time it takes to activate a pool of 4K frames and to write
+ * every frame once, i.e. the cost of the page faults on first use. */
+static void
+do_benchmark_pool (const gchar * name, const gchar ** options)
+{
+  GstBuffer *buffers[NUM_BUFFERS];
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstVideoInfo info;
+  GstCaps *caps;
+  GTimer *timer;
+  gdouble activate_sec, first_use_sec, reuse_sec;
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, DEFAULT_WIDTH,
+      DEFAULT_HEIGHT);
+  caps = gst_video_info_to_caps (&info);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, NUM_BUFFERS,
+      NUM_BUFFERS);
+  for (; options && *options; options++)
+    gst_buffer_pool_config_add_option (config, *options);
+  gst_buffer_pool_set_config (pool, config);
+  gst_caps_unref (caps);
+
+  timer = g_timer_new ();
+
+  gst_buffer_pool_set_active (pool, TRUE);
+  activate_sec = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    gst_buffer_pool_acquire_buffer (pool, &buffers[i], NULL);
+    gst_buffer_memset (buffers[i], 0, 0x80, -1);
+  }
+  first_use_sec = g_timer_elapsed (timer, NULL);
+
+  g_timer_start (timer);
+  for (i = 0; i < NUM_BUFFERS; i++)
+    gst_buffer_memset (buffers[i], 0, 0x10, -1);
+  reuse_sec = g_timer_elapsed (timer, NULL);
+
+  for (i = 0; i < NUM_BUFFERS; i++)
+    gst_buffer_unref (buffers[i]);
+
+  gst_print ("%-28s activate %8.3f ms, first use %8.3f ms/frame, "
+      "reuse %8.3f ms/frame\n", name, activate_sec * 1000,
+      first_use_sec * 1000 / NUM_BUFFERS, reuse_sec * 1000 / NUM_BUFFERS);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+  g_timer_destroy (timer);
+}
+
+int
+main (int argc, char **argv)
+{
+  const gchar *prefault[] = { GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT, NULL };
+  const gchar *huge_pages[] = { GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    NULL
+  };
+  const gchar *huge_pages_prefault[] = {
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT, NULL
+  };
+  const gchar *all[] = { GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT,
+    GST_BUFFER_POOL_OPTION_VIDEO_NUMA_LOCAL, NULL
+  };
+
+  gst_init (&argc, &argv);
+
+  do_benchmark_pool ("default", NULL);
+  do_benchmark_pool ("prefault", prefault);
+  do_benchmark_pool ("huge-pages", huge_pages);
+  do_benchmark_pool ("huge-pages+prefault", huge_pages_prefault);
+  do_benchmark_pool ("huge-pages+prefault+numa", all);
+
+  return 0;
+}